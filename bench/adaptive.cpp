@@ -0,0 +1,82 @@
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <vector>
+
+#include "scenes.hpp"
+#include "render/adaptive.hpp"
+
+// Fixed 16 samples per pixel against adaptive sampling on a scene of spheres seen with parallel
+// rays. Both report their error against a 256 spp reference and the samples they spent per pixel.
+
+static constexpr uint32_t SIZE = 96;
+
+static Tuple4 sample(float px, float py) { return scenes::parallelSample(px, py, SIZE, SIZE); }
+
+static const std::vector<float> &reference() {
+    static const std::vector<float> image = [] {
+        std::vector<float> result(SIZE * SIZE);
+        for (uint32_t y = 0; y < SIZE; y++) {
+            for (uint32_t x = 0; x < SIZE; x++) {
+                float sum = 0;
+                for (uint32_t s = 0; s < 256; s++) {
+                    auto uv = render::sobol(s, render::pixelHash(x, y, 1));
+                    sum += sample(static_cast<float>(x) + uv[0], static_cast<float>(y) + uv[1]).x;
+                }
+                result[x + y * SIZE] = sum / 256;
+            }
+        }
+        return result;
+    }();
+    return image;
+}
+
+static double rootMeanSquareError(const render::Accumulator &accumulator) {
+    double sum = 0;
+    for (uint32_t y = 0; y < SIZE; y++) {
+        for (uint32_t x = 0; x < SIZE; x++) {
+            double error = accumulator.average(x, y).x - reference()[x + y * SIZE];
+            sum += error * error;
+        }
+    }
+    return std::sqrt(sum / (SIZE * SIZE));
+}
+
+static void BM_Uniform16(benchmark::State &state) {
+    render::Accumulator accumulator(SIZE, SIZE);
+    render::TileRenderer renderer({16, 1});
+
+    for (auto _: state) {
+        accumulator.clear();
+        renderer.forEachTile(SIZE, SIZE, [&](const render::Tile &tile) {
+            for (uint32_t y = tile.y; y < tile.y + tile.height; y++) {
+                for (uint32_t x = tile.x; x < tile.x + tile.width; x++) {
+                    for (uint32_t s = 0; s < 16; s++) {
+                        auto uv = render::sobol(s, render::pixelHash(x, y));
+                        accumulator.add(x, y, sample(static_cast<float>(x) + uv[0], static_cast<float>(y) + uv[1]));
+                    }
+                }
+            }
+        });
+    }
+    state.counters["spp"] = 16;
+    state.counters["rmse"] = rootMeanSquareError(accumulator);
+}
+
+static void BM_Adaptive(benchmark::State &state) {
+    Canvas canvas(SIZE, SIZE);
+    render::Accumulator accumulator(SIZE, SIZE);
+    render::AdaptiveOptions options;
+    options.maxSamples = static_cast<uint32_t>(state.range(0));
+    render::AdaptiveSampler sampler(options, {16, 1});
+
+    render::AdaptiveResult result;
+    for (auto _: state) {
+        result = sampler.render(canvas, accumulator, sample);
+    }
+    state.counters["spp"] = static_cast<double>(result.samples) / (SIZE * SIZE);
+    state.counters["rmse"] = rootMeanSquareError(accumulator);
+}
+
+BENCHMARK(BM_Uniform16)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Adaptive)->Arg(16)->Arg(64)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,86 @@
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "scenes.hpp"
+
+// BVH build time and closest-hit throughput as the number of spheres grows, against testing
+// every sphere for the small scenes where that is still feasible.
+
+static constexpr size_t RAY_COUNT = 1 << 12;
+
+static std::vector<Sphere> makeSpheres(size_t count) {
+    return scenes::spheres(count, 1, scenes::cubeFor(count), 0.3f, 1.5f);
+}
+
+static std::vector<Ray> makeRays(size_t count) { return scenes::rays(RAY_COUNT, 2, scenes::cubeFor(count)); }
+
+// Not built: the build is what some benchmarks measure.
+static World makeWorld(size_t count) {
+    World world;
+    for (const auto &sphere: makeSpheres(count)) world.add(sphere);
+    return world;
+}
+
+static void BM_BVHBuild(benchmark::State &state) {
+    auto count = static_cast<size_t>(state.range(0));
+    auto world = makeWorld(count);
+
+    for (auto _: state) {
+        world.build();
+        benchmark::DoNotOptimize(world.hierarchy().nodeData().data());
+    }
+    state.counters["nodes"] = static_cast<double>(world.hierarchy().nodeData().size());
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * count));
+}
+
+// The same build on a pool of range(1) threads: the hierarchy is identical, only faster.
+static void BM_BVHBuildParallel(benchmark::State &state) {
+    auto count = static_cast<size_t>(state.range(0));
+    auto world = makeWorld(count);
+    concurrency::ThreadPool pool(static_cast<size_t>(state.range(1)));
+
+    for (auto _: state) {
+        world.build({}, pool);
+        benchmark::DoNotOptimize(world.hierarchy().nodeData().data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * count));
+}
+
+static void BM_BVHIntersect(benchmark::State &state) {
+    auto count = static_cast<size_t>(state.range(0));
+    auto world = makeWorld(count);
+    world.build();
+    auto rays = makeRays(count);
+
+    for (auto _: state) {
+        for (const auto &ray: rays) {
+            benchmark::DoNotOptimize(world.intersect(ray));
+        }
+    }
+    state.counters["rays/s"] = benchmark::Counter(static_cast<double>(state.iterations() * RAY_COUNT),
+                                                  benchmark::Counter::kIsRate);
+}
+
+static void BM_BruteForceIntersect(benchmark::State &state) {
+    auto count = static_cast<size_t>(state.range(0));
+    auto spheres = makeSpheres(count);
+    auto rays = makeRays(count);
+
+    for (auto _: state) {
+        for (const auto &ray: rays) {
+            std::optional<Intersection> closest;
+            for (const auto &sphere: spheres) {
+                if (auto hit = sphere.intersect(ray).hit(); hit && (!closest || hit->t < closest->t)) closest = hit;
+            }
+            benchmark::DoNotOptimize(closest);
+        }
+    }
+    state.counters["rays/s"] = benchmark::Counter(static_cast<double>(state.iterations() * RAY_COUNT),
+                                                  benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(BM_BVHBuild)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_BVHBuildParallel)->ArgsProduct({{100000, 1000000}, {1, 3, 7, 15, 31}})->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_BVHIntersect)->RangeMultiplier(10)->Range(10, 1000000);
+BENCHMARK(BM_BruteForceIntersect)->RangeMultiplier(10)->Range(10, 1000);
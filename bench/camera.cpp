@@ -0,0 +1,49 @@
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "camera.hpp"
+#include "math/transformation.hpp"
+
+// Primary rays of a 4K frame: the textbook way, through the inverse view transformation at every
+// pixel, against the camera stepping directions along each row.
+
+static constexpr uint32_t WIDTH = 3840;
+static constexpr uint32_t HEIGHT = 2160;
+
+static Camera camera() {
+    return {WIDTH, HEIGHT, PI / 3, transformation::viewTransform(point(0, 1.5f, -5), point(0, 1, 0), vector(0, 1, 0))};
+}
+
+static void BM_RaysInverseEveryPixel(benchmark::State &state) {
+    auto c = camera();
+    float halfWidth = std::tan(c.fieldOfView() / 2);
+    float halfHeight = halfWidth * HEIGHT / WIDTH;
+    std::vector<Ray> row(WIDTH);
+    for (auto _: state) {
+        for (uint32_t y = 0; y < HEIGHT; y++) {
+            for (uint32_t x = 0; x < WIDTH; x++) {
+                auto pixel = c.inverse() * point(halfWidth - (x + 0.5f) * c.pixelSize(), halfHeight - (y + 0.5f) * c.pixelSize(), -1);
+                auto origin = c.inverse() * point(0, 0, 0);
+                row[x] = Ray(origin, (pixel - origin).normalize().value());
+            }
+            benchmark::DoNotOptimize(row.data());
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * WIDTH * HEIGHT);
+}
+
+static void BM_RaysStepped(benchmark::State &state) {
+    auto c = camera();
+    std::vector<Ray> row(WIDTH);
+    for (auto _: state) {
+        for (uint32_t y = 0; y < HEIGHT; y++) {
+            c.row(0, y, row);
+            benchmark::DoNotOptimize(row.data());
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * WIDTH * HEIGHT);
+}
+
+BENCHMARK(BM_RaysInverseEveryPixel)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_RaysStepped)->Unit(benchmark::kMillisecond);
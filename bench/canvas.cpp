@@ -0,0 +1,138 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+
+#include "canvas.hpp"
+
+// Full-frame sweeps over each pixel storage: the smaller the pixel, the less memory
+// traffic per frame, at the price of converting at the accessors.
+
+template<typename Storage>
+static void setFrameCounters(benchmark::State &state, size_t pixelCount) {
+    const auto pixelBytes = sizeof(typename Storage::value_type);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * pixelCount));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * pixelCount * pixelBytes));
+    state.counters["bytes_per_pixel"] = static_cast<double>(pixelBytes);
+    state.counters["frame_bytes"] = static_cast<double>(pixelCount * pixelBytes);
+}
+
+template<typename Storage>
+static void BM_CanvasWriteSweep(benchmark::State &state) {
+
+    const auto width = static_cast<uint32_t>(state.range(0));
+    const auto height = static_cast<uint32_t>(state.range(1));
+    BasicCanvas<Storage> canvas(width, height);
+
+    const float invWidth = 1.f / static_cast<float>(width);
+    const float invHeight = 1.f / static_cast<float>(height);
+
+    for (auto _: state) {
+        for (size_t y = 0; y < height; y++) {
+            for (size_t x = 0; x < width; x++) {
+                canvas.writePixelAt(x, y, Pixel(color(x * invWidth, y * invHeight, 0.5f)));
+            }
+        }
+        benchmark::DoNotOptimize(canvas.data().data());
+        benchmark::ClobberMemory();
+    }
+
+    setFrameCounters<Storage>(state, static_cast<size_t>(width) * height);
+}
+
+template<typename Storage>
+static void BM_CanvasReadSweep(benchmark::State &state) {
+
+    const auto width = static_cast<uint32_t>(state.range(0));
+    const auto height = static_cast<uint32_t>(state.range(1));
+    BasicCanvas<Storage> canvas(width, height);
+
+    for (auto _: state) {
+        Color sum = Colors::BLACK;
+        for (size_t y = 0; y < height; y++) {
+            for (size_t x = 0; x < width; x++) {
+                sum = sum + canvas.pixelAt(x, y).color;
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+
+    setFrameCounters<Storage>(state, static_cast<size_t>(width) * height);
+}
+
+#define CANVAS_SWEEP_BENCHMARKS(STORAGE)                                                            \
+    BENCHMARK_TEMPLATE(BM_CanvasWriteSweep, STORAGE)->Args({64, 64})->Args({512, 512})             \
+            ->Args({1920, 1080})->Args({3840, 2160});                                              \
+    BENCHMARK_TEMPLATE(BM_CanvasReadSweep, STORAGE)->Args({1920, 1080})->Args({3840, 2160})
+
+CANVAS_SWEEP_BENCHMARKS(storage::RGBA32F);
+CANVAS_SWEEP_BENCHMARKS(storage::RGB32F);
+CANVAS_SWEEP_BENCHMARKS(storage::RGB16F);
+CANVAS_SWEEP_BENCHMARKS(storage::RGBA8);
+
+// Tile-based access patterns over each memory layout: a renderer filling the canvas tile
+// by tile, and a 3x3 box filter walking the canvas tile by tile through `pixelAt`. The
+// 65536 pixels wide frame is there to push row-major neighbourhoods out of the caches.
+
+template<typename Layout>
+static void BM_CanvasTileFill(benchmark::State &state) {
+
+    const auto width = static_cast<uint32_t>(state.range(0));
+    const auto height = static_cast<uint32_t>(state.range(1));
+    BasicCanvas<storage::RGBA32F, Layout> canvas(width, height);
+
+    for (auto _: state) {
+        canvas.forEachTile([&](auto tile) {
+            canvas.fillTile(tile, [](size_t x, size_t y) {
+                return Pixel(color(static_cast<float>(x), static_cast<float>(y), 0.5f));
+            });
+        });
+        benchmark::DoNotOptimize(canvas.data().data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * width * height));
+}
+
+template<typename Layout>
+static void BM_CanvasBoxFilter(benchmark::State &state) {
+
+    const auto width = static_cast<uint32_t>(state.range(0));
+    const auto height = static_cast<uint32_t>(state.range(1));
+    BasicCanvas<storage::RGBA32F, Layout> source(width, height);
+    BasicCanvas<storage::RGBA32F, Layout> target(width, height);
+
+    for (size_t y = 0; y < height; y++) {
+        for (size_t x = 0; x < width; x++) {
+            source.writePixelAt(x, y, Pixel(color((x % 7) / 7.f, (y % 5) / 5.f, 0.5f)));
+        }
+    }
+
+    for (auto _: state) {
+        target.forEachTile([&](auto tile) {
+            for (size_t y = std::max<size_t>(tile.y, 1); y < std::min<size_t>(tile.y + tile.height, height - 1); y++) {
+                for (size_t x = std::max<size_t>(tile.x, 1); x < std::min<size_t>(tile.x + tile.width, width - 1); x++) {
+                    Color sum = Colors::BLACK;
+                    for (size_t dy = 0; dy < 3; dy++) {
+                        for (size_t dx = 0; dx < 3; dx++) {
+                            sum = sum + source.pixelAt(x + dx - 1, y + dy - 1).color;
+                        }
+                    }
+                    target.writePixelAt(x, y, Pixel(sum * (1.f / 9.f)));
+                }
+            }
+        });
+        benchmark::DoNotOptimize(target.data().data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * width * height));
+}
+
+#define CANVAS_LAYOUT_BENCHMARKS(LAYOUT)                                                            \
+    BENCHMARK_TEMPLATE(BM_CanvasTileFill, LAYOUT)->Args({3840, 2160})->Args({65536, 512});         \
+    BENCHMARK_TEMPLATE(BM_CanvasBoxFilter, LAYOUT)->Args({3840, 2160})->Args({65536, 512})
+
+CANVAS_LAYOUT_BENCHMARKS(layout::RowMajor);
+CANVAS_LAYOUT_BENCHMARKS(layout::Tiled<8>);
+CANVAS_LAYOUT_BENCHMARKS(layout::Tiled<16>);
+CANVAS_LAYOUT_BENCHMARKS(layout::MortonTiled<16>);
@@ -0,0 +1,53 @@
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "scene.hpp"
+#include "scenes.hpp"
+
+// Many copies of one tessellated sphere: closest-hit throughput through the two-level hierarchy,
+// and the memory of the scene against the memory it would take to copy the mesh per instance.
+
+static std::shared_ptr<const Mesh> sphereMesh(uint32_t rings, uint32_t segments) {
+    auto mesh = std::make_shared<Mesh>();
+    for (uint32_t r = 0; r <= rings; r++) {
+        float phi = static_cast<float>(M_PI) * r / rings;
+        for (uint32_t s = 0; s < segments; s++) {
+            float theta = 2 * static_cast<float>(M_PI) * s / segments;
+            mesh->addVertex(std::sin(phi) * std::cos(theta), std::cos(phi), std::sin(phi) * std::sin(theta));
+        }
+    }
+    for (uint32_t r = 0; r < rings; r++) {
+        for (uint32_t s = 0; s < segments; s++) {
+            uint32_t a = r * segments + s, b = r * segments + (s + 1) % segments;
+            mesh->addTriangle(a, a + segments, b);
+            mesh->addTriangle(b, a + segments, b + segments);
+        }
+    }
+    mesh->build();
+    return mesh;
+}
+
+static void BM_InstancedScene(benchmark::State &state) {
+    auto count = static_cast<size_t>(state.range(0));
+    auto mesh = sphereMesh(64, 128);
+
+    Scene scene;
+    for (const auto &t: scenes::placements(count, 1, scenes::cubeFor(count), 0.3f, 1.5f)) scene.add(Instance(mesh, t));
+    scene.build();
+    auto rays = scenes::rays(4096, 2, scenes::cubeFor(count));
+
+    for (auto _: state) {
+        for (const auto &ray: rays) {
+            benchmark::DoNotOptimize(scene.intersect(ray));
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * rays.size()));
+    state.counters["triangles"] = static_cast<double>(count * mesh->triangleCount());
+    state.counters["sceneMB"] = static_cast<double>(scene.memoryUsage()) / (1 << 20);
+    state.counters["copiedMB"] = static_cast<double>(count * mesh->memoryUsage()) / (1 << 20);
+}
+
+BENCHMARK(BM_InstancedScene)->Arg(10)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,72 @@
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "shapes/sphere.hpp"
+
+// Rays against one transformed sphere: one ray at a time against packets of N rays.
+
+static constexpr size_t RAY_COUNT = 1 << 16;
+
+static std::vector<Ray> makeRays() {
+    std::vector<Ray> rays;
+    rays.reserve(RAY_COUNT);
+    // A 256x256 grid of parallel rays, about half of them hitting the sphere.
+    for (size_t i = 0; i < RAY_COUNT; i++) {
+        auto x = static_cast<float>(i % 256) / 128.f - 1.f;
+        auto y = static_cast<float>(i / 256) / 128.f - 1.f;
+        rays.emplace_back(point(x * 1.5f, y * 1.5f, -5), vector(0, 0, 1));
+    }
+    return rays;
+}
+
+static Sphere makeSphere() {
+    return Sphere(transformation::Transform().scale(1, 1.2f, 1).rotateZ(0.3f).translate(0.1f, 0, 0.5f));
+}
+
+static void BM_IntersectScalar(benchmark::State &state) {
+    auto rays = makeRays();
+    auto sphere = makeSphere();
+    std::vector<float> hits(RAY_COUNT);
+
+    for (auto _: state) {
+        for (size_t i = 0; i < RAY_COUNT; i++) {
+            auto hit = sphere.intersect(rays[i]).hit();
+            hits[i] = hit ? hit->t : -1.f;
+        }
+        benchmark::DoNotOptimize(hits.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * RAY_COUNT));
+}
+
+template<size_t N>
+static void BM_IntersectPacket(benchmark::State &state) {
+    auto rays = makeRays();
+    auto sphere = makeSphere();
+    std::vector<float> hits(RAY_COUNT);
+
+    // Packets are built once: a renderer generates its rays directly in SoA layout.
+    std::vector<RayPacket<N>> packets(RAY_COUNT / N);
+    for (size_t i = 0; i < RAY_COUNT; i++) {
+        packets[i / N].setLane(i % N, rays[i]);
+    }
+    const auto active = MaskxN<N>::broadcast(true);
+
+    for (auto _: state) {
+        for (size_t p = 0; p < packets.size(); p++) {
+            auto t = sphere.intersect(packets[p], active).hit();
+            for (size_t lane = 0; lane < N; lane++) {
+                hits[p * N + lane] = t[lane];
+            }
+        }
+        benchmark::DoNotOptimize(hits.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * RAY_COUNT));
+}
+
+BENCHMARK(BM_IntersectScalar);
+BENCHMARK_TEMPLATE(BM_IntersectPacket, 4);
+BENCHMARK_TEMPLATE(BM_IntersectPacket, 8);
+BENCHMARK_TEMPLATE(BM_IntersectPacket, 16);
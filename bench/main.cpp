@@ -0,0 +1,37 @@
+#include <benchmark/benchmark.h>
+
+// Entry point of the aggregate RayTracerChallenge_Bench: Google Benchmark's own main, with the
+// build recorded in the report context, so that reports of different versions can be compared.
+// `--benchmark_out=<file> --benchmark_out_format=json` writes the machine-readable report; the
+// RayTracerChallenge_Bench_Report target runs the suite that way.
+
+#if __has_include("version.hpp")
+#include "version.hpp"
+#else
+#define RAYTRACER_VERSION "unknown"
+#endif
+
+int main(int argc, char **argv) {
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+
+    benchmark::AddCustomContext("raytracer_version", RAYTRACER_VERSION);
+#ifdef RAYTRACER_SIMD
+    benchmark::AddCustomContext("raytracer_simd", "on");
+#else
+    benchmark::AddCustomContext("raytracer_simd", "off");
+#endif
+#ifdef __AVX2__
+    benchmark::AddCustomContext("raytracer_isa", "avx2");
+#elif defined(__SSE4_1__)
+    benchmark::AddCustomContext("raytracer_isa", "sse4.1");
+#elif defined(__SSE2__)
+    benchmark::AddCustomContext("raytracer_isa", "sse2");
+#else
+    benchmark::AddCustomContext("raytracer_isa", "baseline");
+#endif
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,215 @@
+#include <benchmark/benchmark.h>
+
+#include <vector>
+#include <type_traits>
+
+#include "matrix.hpp"
+#include "transform.hpp"
+
+// Matrix4 inverses, products and transforms per second, the generic path against each backend of `matrix_kernels`.
+
+static constexpr size_t MATRIX_COUNT = 1024;
+
+static std::vector<Matrix4> makeMatrices(bool affine) {
+    std::vector<Matrix4> matrices;
+    matrices.reserve(MATRIX_COUNT);
+    for (size_t n = 0; n < MATRIX_COUNT; n++) {
+        Matrix4 m;
+        for (size_t i = 0; i < 4; i++) {
+            for (size_t j = 0; j < 4; j++) {
+                auto f = static_cast<float>((n * 16 + i * 4 + j) % 23) * 0.25f - 2.f;
+                m.set(i, j, i == j ? f + 8.f : f);
+            }
+        }
+        if (affine) {
+            m.set(3, 0, 0);
+            m.set(3, 1, 0);
+            m.set(3, 2, 0);
+            m.set(3, 3, 1);
+        }
+        matrices.push_back(m);
+    }
+    return matrices;
+}
+
+template<typename Op>
+static void runInverse(benchmark::State &state, bool affine, Op op) {
+    auto matrices = makeMatrices(affine);
+    std::vector<Matrix4> out(MATRIX_COUNT);
+
+    for (auto _: state) {
+        for (size_t i = 0; i < MATRIX_COUNT; i++) {
+            out[i] = op(matrices[i]).value();
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * MATRIX_COUNT));
+}
+
+static void BM_MatrixInverseCofactor(benchmark::State &state) {
+    runInverse(state, false, [](const Matrix4 &m) { return m.cofactorInverse(); });
+}
+
+template<typename Backend>
+static void BM_MatrixInverse(benchmark::State &state) {
+    runInverse(state, false, [](const Matrix4 &m) { return Backend::inverse(m); });
+}
+
+static void BM_MatrixInverseAffine(benchmark::State &state) {
+    runInverse(state, true, [](const Matrix4 &m) { return matrix_kernels::Scalar::inverseAffine(m); });
+}
+
+template<typename Backend>
+static void BM_MatrixDeterminant(benchmark::State &state) {
+    auto matrices = makeMatrices(false);
+
+    for (auto _: state) {
+        float sum = 0;
+        for (size_t i = 0; i < MATRIX_COUNT; i++) {
+            sum += Backend::determinant(matrices[i]);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * MATRIX_COUNT));
+}
+
+template<typename Backend>
+static void BM_MatrixMultiply(benchmark::State &state) {
+    auto a = makeMatrices(false);
+    auto b = makeMatrices(true);
+    std::vector<Matrix4> out(MATRIX_COUNT);
+
+    for (auto _: state) {
+        for (size_t i = 0; i < MATRIX_COUNT; i++) {
+            out[i] = Backend::multiply(a[i], b[i]);
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * MATRIX_COUNT));
+}
+
+static constexpr size_t POINT_COUNT = 1 << 16;
+
+static std::vector<Tuple4> makePoints() {
+    std::vector<Tuple4> points;
+    points.reserve(POINT_COUNT);
+    for (size_t i = 0; i < POINT_COUNT; i++) {
+        auto f = static_cast<float>(i % 1024);
+        points.emplace_back(f * 0.5f, 1.f - f * 0.25f, f * 0.125f + 2.f, 1.f);
+    }
+    return points;
+}
+
+// One `operator*` call per point.
+template<typename Backend>
+static void BM_MatrixTransformEach(benchmark::State &state) {
+    auto m = makeMatrices(true)[3];
+    auto points = makePoints();
+    std::vector<Tuple4> out(POINT_COUNT, Tuple4(0, 0, 0, 0));
+
+    for (auto _: state) {
+        for (size_t i = 0; i < POINT_COUNT; i++) {
+            out[i] = Backend::transform(m, points[i]);
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * POINT_COUNT));
+}
+
+// The whole array in one call.
+template<typename Backend>
+static void BM_MatrixTransformBatch(benchmark::State &state) {
+#if RAYTRACER_AVX_DISPATCH
+    if constexpr (std::is_same_v<Backend, matrix_kernels::AVX>) {
+        if (!matrix_kernels::AVX::supported()) {
+            state.SkipWithError("AVX is not supported by this CPU");
+            return;
+        }
+    }
+#endif
+    auto m = makeMatrices(true)[3];
+    auto points = makePoints();
+    std::vector<Tuple4> out(POINT_COUNT, Tuple4(0, 0, 0, 0));
+
+    for (auto _: state) {
+        Backend::transform(m, points.data(), out.data(), POINT_COUNT);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * POINT_COUNT));
+}
+
+// Scene setup: the matrix, its inverse and its inverse-transpose for each of a set of objects.
+static std::vector<transformation::Transform> makeTransforms(bool rigid) {
+    std::vector<transformation::Transform> transforms;
+    transforms.reserve(MATRIX_COUNT);
+    for (size_t i = 0; i < MATRIX_COUNT; i++) {
+        auto f = static_cast<float>(i);
+        transformation::Transform t;
+        t.rotateY(f * 0.01f).rotateX(f * 0.02f);
+        if (!rigid) t.scale(1.f + f * 0.001f, 2.f, 0.5f);
+        transforms.push_back(t.translate(f, -f, 2.f * f));
+    }
+    return transforms;
+}
+
+static void BM_TransformSetupMatrix(benchmark::State &state) {
+    auto transforms = makeTransforms(state.range(0) != 0);
+    std::vector<Matrix4> out(MATRIX_COUNT * 2);
+
+    for (auto _: state) {
+        for (size_t i = 0; i < MATRIX_COUNT; i++) {
+            out[i * 2] = transforms[i].matrix().inverse().value();
+            out[i * 2 + 1] = transforms[i].matrix().inverse().value().transpose();
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * MATRIX_COUNT));
+}
+
+static void BM_TransformSetupCached(benchmark::State &state) {
+    auto transforms = makeTransforms(state.range(0) != 0);
+    std::vector<Matrix4> out(MATRIX_COUNT * 2);
+
+    for (auto _: state) {
+        state.PauseTiming();
+        auto fresh = transforms;
+        for (auto &t: fresh) t.then(transformation::Transform());
+        state.ResumeTiming();
+        for (size_t i = 0; i < MATRIX_COUNT; i++) {
+            out[i * 2] = fresh[i].inverse().value();
+            out[i * 2 + 1] = fresh[i].inverseTranspose().value();
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * MATRIX_COUNT));
+}
+
+BENCHMARK(BM_MatrixInverseCofactor);
+BENCHMARK_TEMPLATE(BM_MatrixInverse, matrix_kernels::Scalar);
+#if RAYTRACER_SSE
+BENCHMARK_TEMPLATE(BM_MatrixInverse, matrix_kernels::SSE);
+#endif
+BENCHMARK(BM_MatrixInverseAffine);
+BENCHMARK_TEMPLATE(BM_MatrixDeterminant, matrix_kernels::Scalar);
+// Argument: 1 for rigid chains, 0 for chains with a scaling.
+BENCHMARK(BM_TransformSetupMatrix)->Arg(1)->Arg(0);
+BENCHMARK(BM_TransformSetupCached)->Arg(1)->Arg(0);
+
+#define MATRIX_PRODUCT_BENCHMARKS(BACKEND)                      \
+    BENCHMARK_TEMPLATE(BM_MatrixMultiply, BACKEND);             \
+    BENCHMARK_TEMPLATE(BM_MatrixTransformEach, BACKEND);        \
+    BENCHMARK_TEMPLATE(BM_MatrixTransformBatch, BACKEND)
+
+MATRIX_PRODUCT_BENCHMARKS(matrix_kernels::Scalar);
+#if RAYTRACER_SSE
+MATRIX_PRODUCT_BENCHMARKS(matrix_kernels::SSE);
+#endif
+#if RAYTRACER_AVX_DISPATCH
+BENCHMARK_TEMPLATE(BM_MatrixTransformBatch, matrix_kernels::AVX);
+#endif
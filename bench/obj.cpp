@@ -0,0 +1,98 @@
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <random>
+#include <vector>
+#include <filesystem>
+#include <system_error>
+
+#include "io/obj.hpp"
+
+// Loading an OBJ file of a finely tessellated height field, and intersecting rays with the mesh.
+
+/***
+ * The OBJ file of a `side` x `side` grid in the temporary directory, written on first use. It is
+ * written under another name and renamed once complete, so an interrupted run never leaves a
+ * truncated grid behind for the next ones. An empty path if the file cannot be written.
+ */
+static std::filesystem::path gridFile(uint32_t side) {
+    std::error_code error;
+    auto directory = std::filesystem::temp_directory_path(error);
+    if (error) return {};
+    auto path = directory / ("raytracer_grid_" + std::to_string(side) + ".obj");
+    if (std::filesystem::exists(path)) return path;
+
+    auto partial = path;
+    partial += ".partial";
+    std::FILE *file = std::fopen(partial.string().c_str(), "w");
+    if (!file) return {};
+    for (uint32_t y = 0; y <= side; y++) {
+        for (uint32_t x = 0; x <= side; x++) {
+            float u = static_cast<float>(x) / side, v = static_cast<float>(y) / side;
+            std::fprintf(file, "v %.6f %.6f %.6f\n", u * 2 - 1, 0.1f * std::sin(u * 20) * std::cos(v * 20), v * 2 - 1);
+        }
+    }
+    for (uint32_t y = 0; y < side; y++) {
+        for (uint32_t x = 0; x < side; x++) {
+            uint32_t i = y * (side + 1) + x + 1;
+            std::fprintf(file, "f %u %u %u\nf %u %u %u\n", i, i + 1, i + side + 2, i, i + side + 2, i + side + 1);
+        }
+    }
+    bool written = !std::ferror(file);
+    written = std::fclose(file) == 0 && written;
+
+    if (written) std::filesystem::rename(partial, path, error);
+    if (!written || error) {
+        std::filesystem::remove(partial, error);
+        return {};
+    }
+    return path;
+}
+
+static void BM_LoadObj(benchmark::State &state) {
+    auto side = static_cast<uint32_t>(state.range(0));
+    auto path = gridFile(side);
+    if (path.empty()) {
+        state.SkipWithError("Cannot write the grid file.");
+        return;
+    }
+    size_t triangles = 0;
+    for (auto _: state) {
+        auto mesh = io::loadObj(path);
+        triangles = mesh.triangleCount();
+        benchmark::DoNotOptimize(triangles);
+    }
+    state.counters["triangles"] = static_cast<double>(triangles);
+    state.counters["bytes"] = static_cast<double>(std::filesystem::file_size(path));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * std::filesystem::file_size(path)));
+}
+
+static void BM_MeshIntersect(benchmark::State &state) {
+    auto path = gridFile(static_cast<uint32_t>(state.range(0)));
+    if (path.empty()) {
+        state.SkipWithError("Cannot write the grid file.");
+        return;
+    }
+    auto mesh = io::loadObj(path);
+    mesh.build();
+
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> coordinate(-1, 1);
+    std::vector<Ray> rays;
+    for (int i = 0; i < 4096; i++) {
+        rays.emplace_back(point(coordinate(rng), 2, coordinate(rng)), vector(coordinate(rng) * 0.2f, -1, coordinate(rng) * 0.2f));
+    }
+
+    for (auto _: state) {
+        for (const auto &ray: rays) {
+            benchmark::DoNotOptimize(mesh.intersect(ray));
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * rays.size()));
+}
+
+// 1000 x 1000 cells are 2M triangles.
+BENCHMARK(BM_LoadObj)->Arg(100)->Arg(1000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MeshIntersect)->Arg(100)->Arg(1000)->Unit(benchmark::kMicrosecond);
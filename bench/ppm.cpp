@@ -0,0 +1,64 @@
+#include <benchmark/benchmark.h>
+
+#include <ostream>
+#include <streambuf>
+
+#include "canvas.hpp"
+
+// PPM encoding of a full canvas, in ASCII (P3) and binary (P6), at several frame sizes. The
+// output goes to a stream that only counts bytes, so that the file system is not measured.
+
+class CountingBuffer : public std::streambuf {
+
+    std::streamsize count {0};
+
+protected:
+
+    std::streamsize xsputn(const char *, std::streamsize n) override {
+        count += n;
+        return n;
+    }
+
+    int_type overflow(int_type c) override {
+        count += 1;
+        return traits_type::not_eof(c);
+    }
+
+public:
+
+    [[nodiscard]] std::streamsize written() const { return count; }
+};
+
+static Canvas gradientCanvas(uint32_t width, uint32_t height) {
+    Canvas canvas(width, height);
+    for (size_t y = 0; y < height; y++) {
+        for (size_t x = 0; x < width; x++) {
+            canvas.writePixelAt(x, y, Pixel(color(static_cast<float>(x) / width, static_cast<float>(y) / height, 0.5f)));
+        }
+    }
+    return canvas;
+}
+
+template<io::PPMIdentifier MAGIC>
+static void BM_PPMEncode(benchmark::State &state) {
+    const auto width = static_cast<uint32_t>(state.range(0));
+    const auto height = static_cast<uint32_t>(state.range(1));
+    auto canvas = gradientCanvas(width, height);
+
+    std::streamsize bytes = 0;
+    for (auto _: state) {
+        CountingBuffer buffer;
+        std::ostream os(&buffer);
+        os << canvas.ppm(MAGIC);
+        bytes = buffer.written();
+        benchmark::DoNotOptimize(bytes);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * width * height);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * bytes);
+    state.counters["file_bytes"] = static_cast<double>(bytes);
+}
+
+BENCHMARK_TEMPLATE(BM_PPMEncode, io::PPMIdentifier::COLORMAP)
+        ->Args({64, 64})->Args({512, 512})->Args({1920, 1080})->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_PPMEncode, io::PPMIdentifier::COLORMAP_BINARY)
+        ->Args({64, 64})->Args({512, 512})->Args({1920, 1080})->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,50 @@
+#include <benchmark/benchmark.h>
+
+#include "scenes.hpp"
+#include "render/progressive.hpp"
+
+// Rendering a small scene of spheres with parallel rays: tiles on a number of threads, and the
+// time progressive rendering takes to show a first image compared to the final one.
+
+static constexpr uint32_t WIDTH = 256;
+static constexpr uint32_t HEIGHT = 256;
+
+// The sample `index` of pixel (x, y), jittered inside the pixel.
+static Tuple4 sample(size_t x, size_t y, uint32_t index) {
+    float jitterX = static_cast<float>((index * 7 + 3) % 16) / 16.f;
+    float jitterY = static_cast<float>((index * 11 + 5) % 16) / 16.f;
+    return scenes::parallelSample(static_cast<float>(x) + jitterX, static_cast<float>(y) + jitterY, WIDTH, HEIGHT);
+}
+
+static void BM_TileRender(benchmark::State &state) {
+    Canvas canvas(WIDTH, HEIGHT);
+    render::TileRenderer renderer({static_cast<uint32_t>(state.range(1)), static_cast<uint32_t>(state.range(0))});
+
+    double utilization = 0;
+    for (auto _: state) {
+        auto stats = renderer.render(canvas, [&](size_t x, size_t y) { return Pixel(sample(x, y, 0)); });
+        for (size_t i = 0; i < stats.workers.size(); i++) utilization += stats.utilization(i);
+    }
+    state.counters["utilization"] = utilization / static_cast<double>(state.iterations() * state.range(0));
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * WIDTH * HEIGHT));
+}
+
+// Reports the time to the first pass (1 spp) next to the time of the whole 16 spp render.
+static void BM_ProgressiveRender(benchmark::State &state) {
+    Canvas canvas(WIDTH, HEIGHT);
+    render::Accumulator accumulator(WIDTH, HEIGHT);
+    render::ProgressiveRenderer renderer({16}, {32, static_cast<uint32_t>(state.range(0))});
+
+    double firstImage = 0;
+    for (auto _: state) {
+        renderer.render(canvas, accumulator, [&](size_t x, size_t y, uint32_t index) {
+            return sample(x, y, index);
+        }, [&](const render::PassInfo &info) {
+            if (info.pass == 0) firstImage += std::chrono::duration<double, std::milli>(info.elapsed).count();
+        });
+    }
+    state.counters["first_image_ms"] = firstImage / static_cast<double>(state.iterations());
+}
+
+BENCHMARK(BM_TileRender)->ArgsProduct({{1, 2, 4, 8}, {16, 32, 64}})->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_ProgressiveRender)->Arg(1)->Arg(4)->Unit(benchmark::kMillisecond)->UseRealTime();
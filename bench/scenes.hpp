@@ -0,0 +1,112 @@
+#ifndef RAYTRACERCHALLENGE_BENCH_SCENES_HPP
+#define RAYTRACERCHALLENGE_BENCH_SCENES_HPP
+
+#include <cmath>
+#include <random>
+#include <vector>
+#include <cstdint>
+
+#include "world.hpp"
+#include "math/transform.hpp"
+
+// The scenes of the benchmarks, generated from fixed seeds so that every run, and every version,
+// measures the same spheres and rays.
+
+namespace scenes {
+
+    // The box objects and ray end points are scattered in.
+    struct Region {
+        Point lower;
+        Point upper;
+    };
+
+    inline Region cube(float halfSide) {
+        return {point(-halfSide, -halfSide, -halfSide), point(halfSide, halfSide, halfSide)};
+    }
+
+    // A cube growing with `count`, so that scenes of any size have the same density of objects.
+    inline Region cubeFor(size_t count) { return cube(4.f * std::cbrt(static_cast<float>(count))); }
+
+    inline Point randomPoint(std::mt19937 &rng, const Region &region) {
+        std::uniform_real_distribution<float> unit(0, 1);
+        float x = unit(rng), y = unit(rng), z = unit(rng);
+        return point(region.lower.x + x * (region.upper.x - region.lower.x),
+                     region.lower.y + y * (region.upper.y - region.lower.y),
+                     region.lower.z + z * (region.upper.z - region.lower.z));
+    }
+
+    // `count` placements: a scale in [minSize, maxSize) along each axis, then a position in `region`.
+    inline std::vector<transformation::Transform> placements(size_t count, uint32_t seed, const Region &region,
+                                                             float minSize, float maxSize) {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> size(minSize, maxSize);
+        std::vector<transformation::Transform> result;
+        result.reserve(count);
+        for (size_t i = 0; i < count; i++) {
+            float sx = size(rng), sy = size(rng), sz = size(rng);
+            auto position = randomPoint(rng, region);
+            result.push_back(transformation::Transform().scale(sx, sy, sz).translate(position.x, position.y, position.z));
+        }
+        return result;
+    }
+
+    inline std::vector<Sphere> spheres(size_t count, uint32_t seed, const Region &region, float minSize, float maxSize) {
+        std::vector<Sphere> result;
+        result.reserve(count);
+        for (const auto &t: placements(count, seed, region, minSize, maxSize)) result.emplace_back(t);
+        return result;
+    }
+
+    // The spheres of `spheres(...)` in a built world.
+    inline World world(size_t count, uint32_t seed, const Region &region, float minSize, float maxSize) {
+        World w;
+        for (auto &sphere: spheres(count, seed, region, minSize, maxSize)) w.add(sphere);
+        w.build();
+        return w;
+    }
+
+    // Rays between two random points of `region`, their direction not normalized.
+    inline std::vector<Ray> rays(size_t count, uint32_t seed, const Region &region) {
+        std::mt19937 rng(seed);
+        std::vector<Ray> result;
+        result.reserve(count);
+        for (size_t i = 0; i < count; i++) {
+            auto origin = randomPoint(rng, region);
+            result.emplace_back(origin, randomPoint(rng, region) - origin);
+        }
+        return result;
+    }
+
+    // 200 spheres in [-8, 8]^3, seen along +z by the parallel rays of `parallelSample`.
+    inline const World &parallelView() {
+        static const World scene = world(200, 3, cube(8), 0.3f, 1.2f);
+        return scene;
+    }
+
+    /***
+     * The color at point (`px`, `py`) of a `width` x `height` canvas looking at `parallelView()`:
+     * a ray parallel to +z through the matching point of the [-10, 10]^2 square, shaded by distance.
+     */
+    inline Tuple4 parallelSample(float px, float py, uint32_t width, uint32_t height) {
+        auto x = px / static_cast<float>(width) * 20.f - 10.f;
+        auto y = 10.f - py / static_cast<float>(height) * 20.f;
+        auto hit = parallelView().intersect(Ray(point(x, y, -20), vector(0, 0, 1)));
+        if (!hit) return Colors::BLACK;
+        float shade = 1.f - (hit->t - 10.f) / 20.f;
+        return color(shade, shade, shade);
+    }
+
+    // 2000 spheres in [-30, 30]^3, dense enough for rays to cross many boxes before a hit.
+    inline const World &sphereCloud() {
+        static const World scene = world(2000, 1, cube(30), 0.5f, 2.f);
+        return scene;
+    }
+
+    // 400 spheres floating between 1 and 20 units above the ground square [-40, 40]^2, lit from above.
+    inline const World &floatingSpheres() {
+        static const World scene = world(400, 1, {point(-40, 1, -40), point(40, 20, 40)}, 0.5f, 3.f);
+        return scene;
+    }
+}
+
+#endif //RAYTRACERCHALLENGE_BENCH_SCENES_HPP
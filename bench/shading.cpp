@@ -0,0 +1,75 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include "lighting.hpp"
+#include "shapes/sphere.hpp"
+
+// Shaded samples per second: normals and Phong lighting for hits on a transformed sphere, one hit
+// at a time against batches of 8 and 16 hits in structure-of-arrays layout.
+
+static constexpr size_t HIT_COUNT = 1 << 12;
+
+static const Sphere &sphere() {
+    static const Sphere shape(transformation::Transform().scale(1, 0.5f, 1).rotateZ(0.6f).translate(1, 2, 3));
+    return shape;
+}
+
+static const PointLight &light() {
+    static const PointLight source(point(-10, 10, -10), color(1, 1, 1));
+    return source;
+}
+
+static std::vector<HitRecord> makeHits(const Material &material) {
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> coordinate(-1, 1);
+    std::vector<HitRecord> hits;
+    for (size_t i = 0; i < HIT_COUNT; i++) {
+        auto p = vector(coordinate(rng), coordinate(rng), coordinate(rng)).normalize().value();
+        auto world = sphere().transformation().matrix() * point(p.x, p.y, p.z);
+        hits.push_back({world, (point(0, 0, -5) - world).normalize().value(), vector(0, 0, 0), &material, false});
+    }
+    return hits;
+}
+
+static void BM_ShadeSingle(benchmark::State &state) {
+    Material material;
+    auto hits = makeHits(material);
+    std::vector<Color> colors(hits.size(), Colors::BLACK);
+    const auto &shape = sphere();
+    const auto &source = light();
+
+    for (auto _: state) {
+        for (size_t i = 0; i < hits.size(); i++) {
+            auto normal = shape.normalAt(hits[i].position);
+            colors[i] = lighting(material, source, hits[i].position, hits[i].eye, normal);
+        }
+        benchmark::DoNotOptimize(colors.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * hits.size()));
+}
+
+template<size_t N>
+static void BM_ShadeBatch(benchmark::State &state) {
+    Material material;
+    auto hits = makeHits(material);
+    std::vector<Color> colors(hits.size(), Colors::BLACK);
+    const auto &shape = sphere();
+    const auto &source = light();
+
+    for (auto _: state) {
+        for (size_t offset = 0; offset < hits.size(); offset += N) {
+            auto batch = HitBatch<N>::gather(hits, offset);
+            batch.normal = shape.normalAt(batch.position);
+            auto result = lighting(batch, source);
+            for (size_t i = 0; i < N; i++) colors[offset + i] = result.lane(i);
+        }
+        benchmark::DoNotOptimize(colors.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * hits.size()));
+}
+
+BENCHMARK(BM_ShadeSingle);
+BENCHMARK_TEMPLATE(BM_ShadeBatch, 8);
+BENCHMARK_TEMPLATE(BM_ShadeBatch, 16);
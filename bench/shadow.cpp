@@ -0,0 +1,61 @@
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "scenes.hpp"
+
+// Shadow rays from a grid of points on the ground towards a light, through a field of spheres:
+// a closest-hit search against the any-hit query, with and without the occluder cache. The
+// points are visited in scanline order, like the pixels of an image.
+
+static const World &world() { return scenes::floatingSpheres(); }
+
+static const PointLight light(point(10, 60, -10), color(1, 1, 1));
+
+static std::vector<Point> groundPoints() {
+    std::vector<Point> points;
+    for (int z = 0; z < 128; z++) {
+        for (int x = 0; x < 128; x++) points.push_back(point(-40 + x * 0.625f, 0, -40 + z * 0.625f));
+    }
+    return points;
+}
+
+static void BM_ShadowClosestHit(benchmark::State &state) {
+    auto points = groundPoints();
+    size_t shadowed = 0;
+    for (auto _: state) {
+        shadowed = 0;
+        for (const auto &p: points) {
+            auto hit = world().intersect(Ray(p, light.position - p));
+            shadowed += hit && hit->t < 1;
+        }
+    }
+    state.counters["shadowed"] = static_cast<double>(shadowed) / points.size();
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * points.size()));
+}
+
+static void BM_ShadowAnyHit(benchmark::State &state) {
+    auto points = groundPoints();
+    size_t shadowed = 0;
+    for (auto _: state) {
+        shadowed = 0;
+        for (const auto &p: points) shadowed += world().occluded(Ray(p, light.position - p), 1);
+    }
+    state.counters["shadowed"] = static_cast<double>(shadowed) / points.size();
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * points.size()));
+}
+
+static void BM_ShadowCached(benchmark::State &state) {
+    auto points = groundPoints();
+    size_t shadowed = 0;
+    for (auto _: state) {
+        shadowed = 0;
+        for (const auto &p: points) shadowed += world().isShadowed(p, light);
+    }
+    state.counters["shadowed"] = static_cast<double>(shadowed) / points.size();
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * points.size()));
+}
+
+BENCHMARK(BM_ShadowClosestHit)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ShadowAnyHit)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ShadowCached)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,83 @@
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "scenes.hpp"
+#include "render/stream.hpp"
+
+// Rays per second through a field of spheres, one ray at a time against packets of 8 and 16.
+// Primary rays of a 256 x 256 pinhole view are coherent by construction; secondary rays (from
+// one random point towards another) are traced both in generation order and sorted.
+
+static constexpr uint32_t SIZE = 256;
+
+static const World &world() { return scenes::sphereCloud(); }
+
+static render::RayStream primaryRays() {
+    render::RayStream stream;
+    // Tile by tile, as a tile renderer would generate them.
+    for (uint32_t ty = 0; ty < SIZE; ty += 32) {
+        for (uint32_t tx = 0; tx < SIZE; tx += 32) {
+            stream.generate({tx, ty, 32, 32}, SIZE, [](uint32_t x, uint32_t y) {
+                auto target = point(-30 + 60.f * (x + 0.5f) / SIZE, 30 - 60.f * (y + 0.5f) / SIZE, 0);
+                return Ray(point(0, 0, -80), target - point(0, 0, -80));
+            });
+        }
+    }
+    return stream;
+}
+
+static render::RayStream secondaryRays() {
+    render::RayStream stream;
+    auto rays = scenes::rays(SIZE * SIZE, 2, scenes::cube(30));
+    for (uint32_t i = 0; i < rays.size(); i++) stream.add(rays[i], i);
+    return stream;
+}
+
+static void traceSingle(benchmark::State &state, const render::RayStream &stream) {
+    std::vector<render::StreamHit> hits(stream.size());
+    for (auto _: state) {
+        for (size_t i = 0; i < stream.size(); i++) {
+            if (auto hit = world().intersect(stream.ray(i))) {
+                hits[i] = {hit->t, static_cast<uint32_t>(hit->object - world().objects().data())};
+            }
+        }
+        benchmark::DoNotOptimize(hits.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * stream.size()));
+}
+
+template<size_t N>
+static void tracePackets(benchmark::State &state, const render::RayStream &stream) {
+    std::vector<render::StreamHit> hits;
+    for (auto _: state) {
+        render::trace<N>(world(), stream, hits);
+        benchmark::DoNotOptimize(hits.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * stream.size()));
+}
+
+static void BM_PrimarySingle(benchmark::State &state) { traceSingle(state, primaryRays()); }
+
+template<size_t N>
+static void BM_PrimaryPacket(benchmark::State &state) { tracePackets<N>(state, primaryRays()); }
+
+static void BM_SecondarySingle(benchmark::State &state) { traceSingle(state, secondaryRays()); }
+
+template<size_t N>
+static void BM_SecondaryPacketUnsorted(benchmark::State &state) { tracePackets<N>(state, secondaryRays()); }
+
+template<size_t N>
+static void BM_SecondaryPacketSorted(benchmark::State &state) {
+    auto stream = secondaryRays();
+    stream.sort(world().hierarchy().bounds());
+    tracePackets<N>(state, stream);
+}
+
+BENCHMARK(BM_PrimarySingle)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_PrimaryPacket, 8)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_PrimaryPacket, 16)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SecondarySingle)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_SecondaryPacketUnsorted, 8)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_SecondaryPacketSorted, 8)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_SecondaryPacketSorted, 16)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,60 @@
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "transformation.hpp"
+#include "transform.hpp"
+
+// Building transformation matrices: each elementary matrix on its own, the fluent chain of
+// `Transform`, and the view transformation of a camera.
+
+static constexpr size_t MATRIX_COUNT = 1024;
+
+template<typename Make>
+static void runConstruction(benchmark::State &state, Make make) {
+    std::vector<Matrix4> out(MATRIX_COUNT);
+
+    for (auto _: state) {
+        for (size_t i = 0; i < MATRIX_COUNT; i++) {
+            out[i] = make(static_cast<float>(i) * 0.001f + 0.5f);
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * MATRIX_COUNT));
+}
+
+static void BM_TransformationTranslation(benchmark::State &state) {
+    runConstruction(state, [](float f) { return transformation::translation(f, -f, 2 * f); });
+}
+
+static void BM_TransformationScale(benchmark::State &state) {
+    runConstruction(state, [](float f) { return transformation::scale(f, 2 * f, 0.5f); });
+}
+
+static void BM_TransformationRotation(benchmark::State &state) {
+    runConstruction(state, [](float f) { return transformation::rotationY(f); });
+}
+
+static void BM_TransformationShearing(benchmark::State &state) {
+    runConstruction(state, [](float f) { return transformation::shearing(f, 0, 0, f, 0, 0); });
+}
+
+static void BM_TransformationChain(benchmark::State &state) {
+    runConstruction(state, [](float f) {
+        return transformation::Transform().rotateX(f).rotateY(2 * f).scale(f, f, f).translate(f, 0, -f).matrix();
+    });
+}
+
+static void BM_TransformationView(benchmark::State &state) {
+    runConstruction(state, [](float f) {
+        return transformation::viewTransform(point(f, 1.5f, -5), point(0, 1, 0), vector(0, 1, 0));
+    });
+}
+
+BENCHMARK(BM_TransformationTranslation);
+BENCHMARK(BM_TransformationScale);
+BENCHMARK(BM_TransformationRotation);
+BENCHMARK(BM_TransformationShearing);
+BENCHMARK(BM_TransformationChain);
+BENCHMARK(BM_TransformationView);
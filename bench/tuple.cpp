@@ -0,0 +1,101 @@
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "tuple.hpp"
+
+// Every Tuple4 operation, run over arrays of tuples with each backend of `tuple_kernels`.
+
+static constexpr size_t TUPLE_COUNT = 4096;
+
+static std::vector<Tuple4> makeTuples(float seed) {
+    std::vector<Tuple4> tuples;
+    tuples.reserve(TUPLE_COUNT);
+    for (size_t i = 0; i < TUPLE_COUNT; i++) {
+        auto f = static_cast<float>(i) + seed;
+        tuples.emplace_back(f * 0.5f, 1.f - f * 0.25f, f * 0.125f + 2.f, (i & 1) ? 1.f : 0.f);
+    }
+    return tuples;
+}
+
+template<typename Backend, typename Op>
+static void runBinary(benchmark::State &state, Op op) {
+    auto a = makeTuples(1.f);
+    auto b = makeTuples(3.f);
+    std::vector<Tuple4> out(TUPLE_COUNT, Tuple4(0, 0, 0, 0));
+
+    for (auto _: state) {
+        for (size_t i = 0; i < TUPLE_COUNT; i++) {
+            out[i] = op(a[i], b[i]);
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * TUPLE_COUNT));
+}
+
+template<typename Backend, typename Op>
+static void runReduce(benchmark::State &state, Op op) {
+    auto a = makeTuples(1.f);
+    auto b = makeTuples(3.f);
+
+    for (auto _: state) {
+        float sum = 0;
+        for (size_t i = 0; i < TUPLE_COUNT; i++) {
+            sum += op(a[i], b[i]);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * TUPLE_COUNT));
+}
+
+template<typename Backend>
+static void BM_TupleAdd(benchmark::State &state) {
+    runBinary<Backend>(state, [](const Tuple4 &a, const Tuple4 &b) { return Backend::add(a, b); });
+}
+
+template<typename Backend>
+static void BM_TupleSubtract(benchmark::State &state) {
+    runBinary<Backend>(state, [](const Tuple4 &a, const Tuple4 &b) { return Backend::subtract(a, b); });
+}
+
+template<typename Backend>
+static void BM_TupleMultiplyScalar(benchmark::State &state) {
+    runBinary<Backend>(state, [](const Tuple4 &a, const Tuple4 &b) { return Backend::multiply(a, b.x); });
+}
+
+template<typename Backend>
+static void BM_TupleCross(benchmark::State &state) {
+    runBinary<Backend>(state, [](const Tuple4 &a, const Tuple4 &b) { return Backend::cross(a, b); });
+}
+
+template<typename Backend>
+static void BM_TupleNormalize(benchmark::State &state) {
+    runBinary<Backend>(state, [](const Tuple4 &a, const Tuple4 &) {
+        return Backend::divide(a, Backend::magnitude(a));
+    });
+}
+
+template<typename Backend>
+static void BM_TupleDot(benchmark::State &state) {
+    runReduce<Backend>(state, [](const Tuple4 &a, const Tuple4 &b) { return Backend::dot(a, b); });
+}
+
+template<typename Backend>
+static void BM_TupleMagnitude(benchmark::State &state) {
+    runReduce<Backend>(state, [](const Tuple4 &a, const Tuple4 &) { return Backend::magnitude(a); });
+}
+
+#define TUPLE_BENCHMARKS(BACKEND)                               \
+    BENCHMARK_TEMPLATE(BM_TupleAdd, BACKEND);                   \
+    BENCHMARK_TEMPLATE(BM_TupleSubtract, BACKEND);              \
+    BENCHMARK_TEMPLATE(BM_TupleMultiplyScalar, BACKEND);        \
+    BENCHMARK_TEMPLATE(BM_TupleDot, BACKEND);                   \
+    BENCHMARK_TEMPLATE(BM_TupleCross, BACKEND);                 \
+    BENCHMARK_TEMPLATE(BM_TupleMagnitude, BACKEND);             \
+    BENCHMARK_TEMPLATE(BM_TupleNormalize, BACKEND)
+
+TUPLE_BENCHMARKS(tuple_kernels::Scalar);
+#if RAYTRACER_SSE
+TUPLE_BENCHMARKS(tuple_kernels::SSE);
+#endif
@@ -0,0 +1,16 @@
+# Writes OUTPUT from version.hpp.in with the `git describe` of SOURCE_DIR, run with `cmake -P` at
+# every build. The header is only rewritten when the version changed, so that an unchanged version
+# rebuilds nothing.
+set(RAYTRACER_VERSION "unknown")
+if (GIT_EXECUTABLE)
+    execute_process(COMMAND ${GIT_EXECUTABLE} describe --always --dirty
+                    WORKING_DIRECTORY ${SOURCE_DIR}
+                    OUTPUT_VARIABLE DESCRIBED
+                    OUTPUT_STRIP_TRAILING_WHITESPACE
+                    RESULT_VARIABLE RESULT
+                    ERROR_QUIET)
+    if (RESULT EQUAL 0 AND DESCRIBED)
+        set(RAYTRACER_VERSION "${DESCRIBED}")
+    endif ()
+endif ()
+configure_file(${CMAKE_CURRENT_LIST_DIR}/version.hpp.in ${OUTPUT} @ONLY)
@@ -0,0 +1,175 @@
+#ifndef RAYTRACERCHALLENGE_AABB_HPP
+#define RAYTRACERCHALLENGE_AABB_HPP
+
+#include <array>
+#include <limits>
+#include <algorithm>
+
+#include "../ray.hpp"
+#include "../math/matrix.hpp"
+
+namespace accel {
+
+    /***
+     * An axis-aligned bounding box. A default constructed box is empty (lower > upper), so that
+     * extending it by anything gives that thing's bounds.
+     */
+    struct AABB {
+
+        std::array<float, 3> lower {std::numeric_limits<float>::infinity(),
+                                    std::numeric_limits<float>::infinity(),
+                                    std::numeric_limits<float>::infinity()};
+        std::array<float, 3> upper {-std::numeric_limits<float>::infinity(),
+                                    -std::numeric_limits<float>::infinity(),
+                                    -std::numeric_limits<float>::infinity()};
+
+        constexpr AABB() = default;
+
+        constexpr AABB(const std::array<float, 3> &lower, const std::array<float, 3> &upper) : lower{lower}, upper{upper} {}
+
+        // [-1, 1] on every axis: the object space bounds of the unit shapes.
+        static constexpr AABB unit() {
+            return {{-1, -1, -1}, {1, 1, 1}};
+        }
+
+        [[nodiscard]] constexpr bool empty() const {
+            return lower[0] > upper[0] || lower[1] > upper[1] || lower[2] > upper[2];
+        }
+
+        constexpr void extend(const std::array<float, 3> &p) {
+            for (size_t i = 0; i < 3; i++) {
+                lower[i] = std::min(lower[i], p[i]);
+                upper[i] = std::max(upper[i], p[i]);
+            }
+        }
+
+        constexpr void extend(const AABB &box) {
+            for (size_t i = 0; i < 3; i++) {
+                lower[i] = std::min(lower[i], box.lower[i]);
+                upper[i] = std::max(upper[i], box.upper[i]);
+            }
+        }
+
+        [[nodiscard]] constexpr std::array<float, 3> centroid() const {
+            return {(lower[0] + upper[0]) * 0.5f, (lower[1] + upper[1]) * 0.5f, (lower[2] + upper[2]) * 0.5f};
+        }
+
+        [[nodiscard]] constexpr bool contains(const AABB &box) const {
+            for (size_t i = 0; i < 3; i++) {
+                if (box.lower[i] < lower[i] || box.upper[i] > upper[i]) return false;
+            }
+            return true;
+        }
+
+        // The axis (0, 1 or 2) along which the box is the longest.
+        [[nodiscard]] constexpr size_t longestAxis() const {
+            auto dx = upper[0] - lower[0], dy = upper[1] - lower[1], dz = upper[2] - lower[2];
+            if (dx >= dy && dx >= dz) return 0;
+            return dy >= dz ? 1 : 2;
+        }
+
+        // Half of the surface area, which is all the surface area heuristic needs. 0 for empty boxes.
+        [[nodiscard]] constexpr float halfArea() const {
+            if (empty()) return 0;
+            auto dx = upper[0] - lower[0], dy = upper[1] - lower[1], dz = upper[2] - lower[2];
+            return dx * dy + dy * dz + dz * dx;
+        }
+
+        /***
+         * The bounds of this box once transformed by `m`, which must be affine. Each output axis
+         * takes the smaller and the larger of the contributions of every input axis (J. Arvo,
+         * "Transforming Axis-Aligned Bounding Boxes").
+         */
+        [[nodiscard]] constexpr AABB transform(const Matrix4 &m) const {
+            AABB result;
+            for (size_t i = 0; i < 3; i++) {
+                result.lower[i] = result.upper[i] = m.at(i, 3);
+                for (size_t j = 0; j < 3; j++) {
+                    float a = m.at(i, j) * lower[j];
+                    float b = m.at(i, j) * upper[j];
+                    result.lower[i] += std::min(a, b);
+                    result.upper[i] += std::max(a, b);
+                }
+            }
+            return result;
+        }
+    };
+
+    /***
+     * A ray prepared for many box tests: the reciprocal of the direction is computed once, and
+     * axis-parallel rays get infinities that the slab test handles.
+     */
+    struct RayBoxQuery {
+
+        // What `enter` returns for a box the ray misses. Nothing compares less than it, even for tMax = infinity.
+        static constexpr float MISS = std::numeric_limits<float>::infinity();
+
+        std::array<float, 3> origin {};
+        std::array<float, 3> inverseDirection {};
+
+        explicit RayBoxQuery(const Ray &ray) : origin{ray.origin.x, ray.origin.y, ray.origin.z},
+                                               inverseDirection{1 / ray.direction.x, 1 / ray.direction.y, 1 / ray.direction.z} {}
+
+        /***
+         * Slab test of the ray against [lower, upper] restricted to t in [0, tMax].
+         * @return The distance at which the ray enters the box (0 if it starts inside), or
+         *         MISS if it misses.
+         */
+        [[nodiscard]] float enter(const float *lower, const float *upper, float tMax) const {
+            float tNear = 0;
+            float tFar = tMax;
+            for (size_t i = 0; i < 3; i++) {
+                float t0 = (lower[i] - origin[i]) * inverseDirection[i];
+                float t1 = (upper[i] - origin[i]) * inverseDirection[i];
+                // min/max written so that a NaN (0 * infinity, ray in the slab plane) is ignored.
+                tNear = std::max(tNear, t0 < t1 ? t0 : t1);
+                tFar = std::min(tFar, t0 < t1 ? t1 : t0);
+            }
+            return tNear <= tFar ? tNear : MISS;
+        }
+
+        [[nodiscard]] float enter(const AABB &box, float tMax) const {
+            return enter(box.lower.data(), box.upper.data(), tMax);
+        }
+    };
+
+    /***
+     * `RayBoxQuery` for the N rays of a packet. The lanes are independent; every loop has a fixed
+     * length so that the compiler can turn it into SIMD instructions.
+     */
+    template<size_t N>
+    struct RayPacketBoxQuery {
+
+        std::array<FloatxN<N>, 3> origin;
+        std::array<FloatxN<N>, 3> inverseDirection;
+
+        explicit RayPacketBoxQuery(const RayPacket<N> &rays) :
+                origin{rays.origin.x, rays.origin.y, rays.origin.z} {
+            const auto one = FloatxN<N>::broadcast(1);
+            inverseDirection = {one / rays.direction.x, one / rays.direction.y, one / rays.direction.z};
+        }
+
+        /***
+         * Slab test of every lane set in `active` against [lower, upper], for t in [0, tMax].
+         * @return The lanes whose ray enters the box.
+         */
+        [[nodiscard]] MaskxN<N> enter(const float *lower, const float *upper, const FloatxN<N> &tMax,
+                                      const MaskxN<N> &active) const {
+            FloatxN<N> tNear;
+            FloatxN<N> tFar = tMax;
+            for (size_t axis = 0; axis < 3; axis++) {
+                for (size_t i = 0; i < N; i++) {
+                    float t0 = (lower[axis] - origin[axis][i]) * inverseDirection[axis][i];
+                    float t1 = (upper[axis] - origin[axis][i]) * inverseDirection[axis][i];
+                    tNear[i] = std::max(tNear[i], t0 < t1 ? t0 : t1);
+                    tFar[i] = std::min(tFar[i], t0 < t1 ? t1 : t0);
+                }
+            }
+            MaskxN<N> result;
+            for (size_t i = 0; i < N; i++) result.lanes[i] = tNear[i] <= tFar[i] ? active.lanes[i] : 0;
+            return result;
+        }
+    };
+}
+
+#endif //RAYTRACERCHALLENGE_AABB_HPP
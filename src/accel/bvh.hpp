@@ -0,0 +1,498 @@
+#ifndef RAYTRACERCHALLENGE_BVH_HPP
+#define RAYTRACERCHALLENGE_BVH_HPP
+
+#include <array>
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <limits>
+#include <cstdint>
+#include <numeric>
+#include <algorithm>
+#include <stdexcept>
+
+#include "aabb.hpp"
+#include "../utility/span.hpp"
+#include "../concurrency/thread_pool.hpp"
+
+namespace accel {
+
+    /***
+     * A node of the flattened hierarchy, 32 bytes so that two fit in a cache line. Nodes are stored
+     * depth-first: the left child of an interior node is the next node, `offset` is the right one.
+     * For a leaf, `offset` is the first of its `count` entries in `BVH::primitives()`.
+     */
+    struct alignas(32) BVHNode {
+        float lower[3];
+        uint32_t offset;
+        float upper[3];
+        // 0 for interior nodes.
+        uint16_t count;
+        // The split axis of interior nodes, to visit the child nearer to the ray first.
+        uint16_t axis;
+
+        [[nodiscard]] bool isLeaf() const { return count != 0; }
+    };
+
+    static_assert(sizeof(BVHNode) == 32, "BVH nodes must be 32 bytes!");
+
+    struct BVHBuildOptions {
+        // Leaves hold at most this many primitives; nodes with more are always split.
+        uint32_t maxLeafSize {4};
+        // Candidate split planes per axis are the boundaries between this many bins, at most `BVH::MAX_BINS`.
+        uint32_t bins {16};
+        // Cost of visiting a node relative to intersecting one primitive.
+        float traversalCost {1.0f};
+        // With a thread pool, subtrees of at least this many primitives become tasks, and the binning
+        // of larger nodes is split in chunks of this size.
+        uint32_t taskSize {4096};
+    };
+
+    /***
+     * A bounding volume hierarchy over primitives known only by their bounds, built top-down with
+     * the binned surface area heuristic: at each node the centroids are sorted into `bins` slabs
+     * along each axis, and the node is split at the slab boundary minimizing
+     * traversalCost + (area(left) * count(left) + area(right) * count(right)) / area(node).
+     * A node of at most `maxLeafSize` primitives stays a leaf when that cost is not below its count.
+     *
+     * The build can run on a thread pool. Bounds are only ever combined with min and max, which are
+     * exact, so the order in which threads merge their partial results does not matter and the
+     * hierarchy is bit-identical to the one built by a single thread.
+     */
+    class BVH {
+
+    public:
+
+        // Past this depth nodes are split at the object median, which bounds the depth for any input.
+        static constexpr uint32_t SAH_MAX_DEPTH = 32;
+        static constexpr uint32_t MAX_DEPTH = 64;
+        static constexpr uint32_t MAX_BINS = 64;
+
+    private:
+
+        std::vector<BVHNode> nodes;
+        std::vector<uint32_t> indices;
+
+        struct Builder {
+
+            struct Bounds {
+                AABB box;
+                AABB centroidBox;
+
+                void merge(const Bounds &other) {
+                    box.extend(other.box);
+                    centroidBox.extend(other.centroidBox);
+                }
+            };
+
+            struct Bins {
+                std::array<std::array<AABB, MAX_BINS>, 3> bounds;
+                std::array<std::array<uint32_t, MAX_BINS>, 3> counts {};
+
+                void merge(const Bins &other) {
+                    for (size_t axis = 0; axis < 3; axis++) {
+                        for (size_t bin = 0; bin < MAX_BINS; bin++) {
+                            bounds[axis][bin].extend(other.bounds[axis][bin]);
+                            counts[axis][bin] += other.counts[axis][bin];
+                        }
+                    }
+                }
+            };
+
+            struct Split {
+                uint32_t axis {0};
+                // Primitives in bins [0, bin] go left.
+                uint32_t bin {0};
+                float cost {std::numeric_limits<float>::infinity()};
+            };
+
+            Span<const AABB> bounds;
+            BVHBuildOptions options;
+            concurrency::ThreadPool *pool;
+            std::vector<uint32_t> &indices;
+            std::vector<std::array<float, 3>> centroids;
+
+            Builder(Span<const AABB> bounds, const BVHBuildOptions &options,
+                    concurrency::ThreadPool *pool, std::vector<uint32_t> &indices) :
+                    bounds{bounds}, options{options}, pool{pool}, indices{indices}, centroids(bounds.size()) {
+                forChunks(0, static_cast<uint32_t>(bounds.size()), [this](uint32_t begin, uint32_t end) {
+                    for (uint32_t i = begin; i < end; i++) centroids[i] = this->bounds[i].centroid();
+                });
+            }
+
+            [[nodiscard]] size_t chunksOf(uint32_t count) const {
+                return pool ? std::min<size_t>(count / options.taskSize, pool->size() + 1) : 1;
+            }
+
+            // Call fn(begin, end) on chunks covering [begin, end), in parallel if the range is large enough.
+            template<typename Fn>
+            void forChunks(uint32_t begin, uint32_t end, Fn &&fn) {
+                auto count = end - begin;
+                auto chunks = chunksOf(count);
+                if (chunks < 2) {
+                    fn(begin, end);
+                    return;
+                }
+                // If the inline chunk throws, the group still waits for the others before `fn` goes away.
+                concurrency::TaskGroup group(*pool);
+                for (size_t chunk = 1; chunk < chunks; chunk++) {
+                    group.run([&fn, chunk, chunks, begin, count] {
+                        fn(begin + static_cast<uint32_t>(count * chunk / chunks),
+                           begin + static_cast<uint32_t>(count * (chunk + 1) / chunks));
+                    });
+                }
+                fn(begin, begin + static_cast<uint32_t>(count / chunks));
+                group.wait();
+            }
+
+            // measure(begin, end, result) over [begin, end), merging partial results of chunks if parallel.
+            template<typename T, typename Fn>
+            void reduce(uint32_t begin, uint32_t end, T &result, Fn &&measure) {
+                if (chunksOf(end - begin) < 2) {
+                    measure(begin, end, result);
+                    return;
+                }
+                std::mutex mutex;
+                forChunks(begin, end, [&](uint32_t chunkBegin, uint32_t chunkEnd) {
+                    auto partial = std::make_unique<T>();
+                    measure(chunkBegin, chunkEnd, *partial);
+                    std::lock_guard<std::mutex> lock(mutex);
+                    result.merge(*partial);
+                });
+            }
+
+            [[nodiscard]] uint32_t binOf(float centroid, float lower, float scale) const {
+                auto bin = static_cast<uint32_t>((centroid - lower) * scale);
+                return std::min(bin, options.bins - 1);
+            }
+
+            [[nodiscard]] std::array<float, 3> scales(const AABB &centroidBox) const {
+                std::array<float, 3> result {};
+                for (size_t axis = 0; axis < 3; axis++) {
+                    float extent = centroidBox.upper[axis] - centroidBox.lower[axis];
+                    result[axis] = extent > 0 ? static_cast<float>(options.bins) / extent : 0;
+                }
+                return result;
+            }
+
+            void measure(uint32_t begin, uint32_t end, Bounds &result) const {
+                for (uint32_t i = begin; i < end; i++) {
+                    result.box.extend(bounds[indices[i]]);
+                    result.centroidBox.extend(centroids[indices[i]]);
+                }
+            }
+
+            void fill(uint32_t begin, uint32_t end, const AABB &centroidBox, Bins &result) const {
+                auto scale = scales(centroidBox);
+                for (uint32_t i = begin; i < end; i++) {
+                    auto primitive = indices[i];
+                    for (uint32_t axis = 0; axis < 3; axis++) {
+                        auto bin = binOf(centroids[primitive][axis], centroidBox.lower[axis], scale[axis]);
+                        result.bounds[axis][bin].extend(bounds[primitive]);
+                        result.counts[axis][bin] += 1;
+                    }
+                }
+            }
+
+            [[nodiscard]] Split findSplit(uint32_t count, const Bounds &node, const Bins &bins) const {
+
+                Split best;
+                std::array<float, MAX_BINS> rightArea {};
+
+                for (uint32_t axis = 0; axis < 3; axis++) {
+
+                    if (!(node.centroidBox.upper[axis] > node.centroidBox.lower[axis])) continue;
+
+                    // Sweep from the right for the areas, then from the left for the costs.
+                    AABB right;
+                    for (uint32_t bin = options.bins - 1; bin > 0; bin--) {
+                        right.extend(bins.bounds[axis][bin]);
+                        rightArea[bin] = right.halfArea();
+                    }
+
+                    AABB left;
+                    uint32_t leftCount = 0;
+                    for (uint32_t bin = 0; bin + 1 < options.bins; bin++) {
+                        left.extend(bins.bounds[axis][bin]);
+                        leftCount += bins.counts[axis][bin];
+                        auto rightCount = count - leftCount;
+                        if (leftCount == 0 || rightCount == 0) continue;
+                        float cost = left.halfArea() * static_cast<float>(leftCount) +
+                                     rightArea[bin + 1] * static_cast<float>(rightCount);
+                        if (cost < best.cost) {
+                            best = {axis, bin, cost};
+                        }
+                    }
+                }
+
+                best.cost = options.traversalCost + best.cost / node.box.halfArea();
+                return best;
+            }
+
+            /***
+             * Append the subtree of indices[begin, end) to `out` in depth-first order. Interior node
+             * offsets are relative to the start of `out`, which `append` adjusts when subtrees built
+             * separately are joined.
+             */
+            void build(uint32_t begin, uint32_t end, uint32_t depth, std::vector<BVHNode> &out) {
+
+                Bounds node;
+                reduce(begin, end, node, [this](uint32_t chunkBegin, uint32_t chunkEnd, Bounds &partial) {
+                    measure(chunkBegin, chunkEnd, partial);
+                });
+                const auto &box = node.box;
+
+                auto nodeIndex = static_cast<uint32_t>(out.size());
+                out.push_back(BVHNode{{box.lower[0], box.lower[1], box.lower[2]}, begin,
+                                      {box.upper[0], box.upper[1], box.upper[2]},
+                                      static_cast<uint16_t>(end - begin), 0});
+
+                auto count = end - begin;
+                if (count == 1) return;
+
+                uint32_t middle = begin;
+                auto axis = static_cast<uint32_t>(node.centroidBox.longestAxis());
+
+                Split split;
+                if (depth < SAH_MAX_DEPTH && box.halfArea() > 0) {
+                    Bins bins;
+                    reduce(begin, end, bins, [&](uint32_t chunkBegin, uint32_t chunkEnd, Bins &partial) {
+                        fill(chunkBegin, chunkEnd, node.centroidBox, partial);
+                    });
+                    split = findSplit(count, node, bins);
+                }
+
+                // The split cost is in primitive intersections, so a leaf costs `count`: small nodes
+                // stay leaves unless splitting them is cheaper; larger ones are always split.
+                if (count <= options.maxLeafSize && !(split.cost < static_cast<float>(count))) return;
+
+                if (split.cost < std::numeric_limits<float>::infinity()) {
+                    axis = split.axis;
+                    float lower = node.centroidBox.lower[axis];
+                    float scale = scales(node.centroidBox)[axis];
+                    auto *first = indices.data() + begin;
+                    auto *last = indices.data() + end;
+                    middle = begin + static_cast<uint32_t>(std::partition(first, last, [&](uint32_t primitive) {
+                        return binOf(centroids[primitive][axis], lower, scale) <= split.bin;
+                    }) - first);
+                } else {
+                    // No usable plane (e.g. every centroid at the same place): split at the median.
+                    middle = begin + count / 2;
+                    std::nth_element(indices.data() + begin, indices.data() + middle, indices.data() + end,
+                                     [&](uint32_t a, uint32_t b) {
+                                         return centroids[a][axis] < centroids[b][axis] ||
+                                                (centroids[a][axis] == centroids[b][axis] && a < b);
+                                     });
+                }
+
+                if (pool && middle - begin >= options.taskSize && end - middle >= options.taskSize) {
+                    // Both halves own disjoint index ranges; each writes its own node array.
+                    std::vector<BVHNode> left, right;
+                    left.reserve(2 * (middle - begin));
+                    right.reserve(2 * (end - middle));
+                    // Declared after `left`: if the inline half throws, the group waits for the other one
+                    // before `left` is destroyed.
+                    concurrency::TaskGroup group(*pool);
+                    group.run([&] { build(begin, middle, depth + 1, left); });
+                    build(middle, end, depth + 1, right);
+                    group.wait();
+                    append(out, left);
+                    out[nodeIndex].offset = static_cast<uint32_t>(out.size());
+                    append(out, right);
+                } else {
+                    build(begin, middle, depth + 1, out);
+                    out[nodeIndex].offset = static_cast<uint32_t>(out.size());
+                    build(middle, end, depth + 1, out);
+                }
+
+                out[nodeIndex].count = 0;
+                out[nodeIndex].axis = static_cast<uint16_t>(axis);
+            }
+
+            static void append(std::vector<BVHNode> &out, const std::vector<BVHNode> &subtree) {
+                auto base = static_cast<uint32_t>(out.size());
+                for (auto node: subtree) {
+                    if (!node.isLeaf()) node.offset += base;
+                    out.push_back(node);
+                }
+            }
+        };
+
+    public:
+
+        BVH() = default;
+
+        /***
+         * Build the hierarchy of the primitives whose world space bounds are `bounds`; primitive `i`
+         * is the one with bounds `bounds[i]`.
+         */
+        static BVH build(Span<const AABB> bounds, const BVHBuildOptions &options = {}) {
+            return build(bounds, options, nullptr);
+        }
+
+        // The same hierarchy, built using the threads of `pool` as well as the calling thread.
+        static BVH build(Span<const AABB> bounds, const BVHBuildOptions &options, concurrency::ThreadPool &pool) {
+            return build(bounds, options, &pool);
+        }
+
+        [[nodiscard]] bool empty() const { return nodes.empty(); }
+
+        [[nodiscard]] Span<const BVHNode> nodeData() const { return nodes; }
+
+        // Primitive indices in leaf order; leaves reference ranges of this array.
+        [[nodiscard]] Span<const uint32_t> primitives() const { return indices; }
+
+        [[nodiscard]] AABB bounds() const {
+            if (nodes.empty()) return {};
+            const auto &root = nodes[0];
+            return {{root.lower[0], root.lower[1], root.lower[2]}, {root.upper[0], root.upper[1], root.upper[2]}};
+        }
+
+        /***
+         * Visit, nearest node first, the primitives of every leaf the ray reaches before `tMax`.
+         * `intersect(primitive, tMax)` tests one primitive and lowers `tMax` when it finds a closer
+         * hit, which prunes the nodes behind it; returning true stops the traversal (any-hit queries).
+         * @return true if `intersect` stopped the traversal.
+         */
+        template<typename Fn>
+        bool traverse(const Ray &ray, float tMax, Fn &&intersect) const {
+
+            if (nodes.empty()) return false;
+
+            const RayBoxQuery query(ray);
+            const bool negative[3] = {query.inverseDirection[0] < 0, query.inverseDirection[1] < 0,
+                                      query.inverseDirection[2] < 0};
+
+            // Pushed nodes keep their entry distance, to skip them if a closer hit was found meanwhile.
+            std::array<uint32_t, MAX_DEPTH> stack;
+            std::array<float, MAX_DEPTH> stackEnter;
+            size_t size = 0;
+            uint32_t current = 0;
+
+            if (query.enter(nodes[0].lower, nodes[0].upper, tMax) == RayBoxQuery::MISS) return false;
+
+            while (true) {
+                const auto &node = nodes[current];
+
+                if (node.isLeaf()) {
+                    for (uint32_t i = node.offset; i < node.offset + node.count; i++) {
+                        if (intersect(indices[i], tMax)) return true;
+                    }
+                } else {
+                    uint32_t near = current + 1;
+                    uint32_t far = node.offset;
+                    if (negative[node.axis]) std::swap(near, far);
+
+                    float tNear = query.enter(nodes[near].lower, nodes[near].upper, tMax);
+                    float tFar = query.enter(nodes[far].lower, nodes[far].upper, tMax);
+                    bool hitNear = tNear < RayBoxQuery::MISS;
+                    bool hitFar = tFar < RayBoxQuery::MISS;
+
+                    if (hitNear && hitFar) {
+                        // Visit the closer box first even when the split axis order says otherwise.
+                        if (tFar < tNear) {
+                            std::swap(near, far);
+                            std::swap(tNear, tFar);
+                        }
+                        stack[size] = far;
+                        stackEnter[size] = tFar;
+                        size += 1;
+                        current = near;
+                        continue;
+                    }
+                    if (hitNear) {
+                        current = near;
+                        continue;
+                    }
+                    if (hitFar) {
+                        current = far;
+                        continue;
+                    }
+                }
+
+                do {
+                    if (size == 0) return false;
+                    size -= 1;
+                } while (stackEnter[size] > tMax);
+                current = stack[size];
+            }
+        }
+
+        /***
+         * `traverse` for a packet of rays going down the hierarchy together: a node is visited if
+         * any lane set in `active` enters it before its `tMax`, and only those lanes are passed to
+         * `intersect(primitive, lanes, tMax)`, which lowers `tMax` for the lanes it hits. The near
+         * child is chosen from the direction of the first active lane, so the rays of a packet
+         * should be coherent (see `render::RayStream::sort`).
+         */
+        template<size_t N, typename Fn>
+        void traverse(const RayPacket<N> &rays, const MaskxN<N> &active, FloatxN<N> &tMax, Fn &&intersect) const {
+
+            if (nodes.empty() || active.none()) return;
+
+            const RayPacketBoxQuery<N> query(rays);
+            size_t lead = 0;
+            while (!active[lead]) lead++;
+            const bool negative[3] = {rays.direction.x[lead] < 0, rays.direction.y[lead] < 0,
+                                      rays.direction.z[lead] < 0};
+
+            // Nodes are tested when popped, against the tMax of that moment.
+            std::array<uint32_t, MAX_DEPTH + 1> stack;
+            size_t size = 1;
+            stack[0] = 0;
+
+            while (size != 0) {
+                const auto &node = nodes[stack[--size]];
+                auto lanes = query.enter(node.lower, node.upper, tMax, active);
+                if (lanes.none()) continue;
+
+                if (node.isLeaf()) {
+                    for (uint32_t i = node.offset; i < node.offset + node.count; i++) {
+                        intersect(indices[i], lanes, tMax);
+                    }
+                    continue;
+                }
+
+                uint32_t near = static_cast<uint32_t>(&node - nodes.data()) + 1;
+                uint32_t far = node.offset;
+                if (negative[node.axis]) std::swap(near, far);
+                stack[size++] = far;
+                stack[size++] = near;
+            }
+        }
+
+    private:
+
+        static BVH build(Span<const AABB> bounds, const BVHBuildOptions &options, concurrency::ThreadPool *pool) {
+
+            if (options.maxLeafSize == 0 || options.maxLeafSize > std::numeric_limits<uint16_t>::max()) {
+                throw std::runtime_error("Cannot build BVH. The maximum leaf size must be in [1, 65535].");
+            }
+            if (options.bins < 2 || options.bins > MAX_BINS) {
+                throw std::runtime_error("Cannot build BVH. The number of bins must be in [2, 64].");
+            }
+            if (options.taskSize == 0) {
+                throw std::runtime_error("Cannot build BVH. The task size must be positive.");
+            }
+            if (bounds.size() >= std::numeric_limits<uint32_t>::max()) {
+                throw std::runtime_error("Cannot build BVH. Too many primitives.");
+            }
+
+            BVH bvh;
+            if (bounds.empty()) return bvh;
+
+            // The index array is partitioned in place, so nodes never allocate; only subtrees built by
+            // other threads get their own node array, copied into place when they are done.
+            bvh.indices.resize(bounds.size());
+            std::iota(bvh.indices.begin(), bvh.indices.end(), 0u);
+            bvh.nodes.reserve(2 * bounds.size());
+
+            Builder builder(bounds, options, pool, bvh.indices);
+            builder.build(0, static_cast<uint32_t>(bounds.size()), 0, bvh.nodes);
+            bvh.nodes.shrink_to_fit();
+            return bvh;
+        }
+    };
+}
+
+#endif //RAYTRACERCHALLENGE_BVH_HPP
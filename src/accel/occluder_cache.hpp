@@ -0,0 +1,104 @@
+#ifndef RAYTRACERCHALLENGE_OCCLUDER_CACHE_HPP
+#define RAYTRACERCHALLENGE_OCCLUDER_CACHE_HPP
+
+#include <array>
+#include <limits>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <stdexcept>
+
+#include "bvh.hpp"
+#include "../ray.hpp"
+#include "../math/tuple.hpp"
+
+namespace accel {
+
+    /***
+     * The last object that blocked a shadow ray towards a light, remembered per thread. Neighbouring
+     * pixels tend to be shadowed by the same object, so testing it first often answers a shadow
+     * query without traversing the hierarchy. Entries are a hint: the cached object is always
+     * intersected again, so a stale entry only costs one test.
+     */
+    class OccluderCache {
+
+        struct Entry {
+            const void *owner {nullptr};
+            float light[3] {};
+            uint32_t object {NONE};
+        };
+
+        static constexpr size_t SLOTS = 16;
+
+        static std::array<Entry, SLOTS> &entries() {
+            thread_local std::array<Entry, SLOTS> slots {};
+            return slots;
+        }
+
+        static Entry &slot(const void *owner, const Point &light) {
+            uint32_t bits[3];
+            std::memcpy(bits, &light.x, sizeof(bits));
+            auto h = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(owner));
+            for (auto b: bits) h = (h ^ b) * 0x100000001b3ull;
+            return entries()[(h ^ (h >> 29)) % SLOTS];
+        }
+
+        static bool matches(const Entry &entry, const void *owner, const Point &light) {
+            return entry.owner == owner && entry.light[0] == light.x && entry.light[1] == light.y &&
+                   entry.light[2] == light.z;
+        }
+
+    public:
+
+        static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+        // The object this thread last found between a point of `owner` and `light`, or NONE.
+        static uint32_t get(const void *owner, const Point &light) {
+            const auto &entry = slot(owner, light);
+            return matches(entry, owner, light) ? entry.object : NONE;
+        }
+
+        static void set(const void *owner, const Point &light, uint32_t object) {
+            slot(owner, light) = Entry{owner, {light.x, light.y, light.z}, object};
+        }
+
+        // Forget every entry of this thread, e.g. before `owner` is destroyed.
+        static void clear() {
+            entries().fill(Entry{});
+        }
+    };
+
+    /***
+     * Whether one of the `count` objects of `owner` lies between `position` and `light`, with
+     * `occludes(index, ray)` telling whether object `index` of `bvh` is hit by `ray` within [0, 1). The object cached for
+     * this thread and light is tested first; the hierarchy is traversed only if it misses, and the
+     * occluder it finds replaces the cached one.
+     */
+    template<typename Occludes>
+    bool isShadowed(const void *owner, const BVH &bvh, size_t count, const Point &position, const Point &light,
+                    Occludes &&occludes) {
+        // Not normalized: the light is at t = 1.
+        Ray ray(position, light - position);
+        auto cached = OccluderCache::get(owner, light);
+        if (cached < count && occludes(cached, ray)) return true;
+
+        uint32_t found = OccluderCache::NONE;
+        bool blocked = bvh.traverse(ray, 1, [&](uint32_t index, float &) {
+            if (!occludes(index, ray)) return false;
+            found = index;
+            return true;
+        });
+        if (blocked) OccluderCache::set(owner, light, found);
+        return blocked;
+    }
+
+    // Throws unless the hierarchy of `what` (e.g. "world") was built after its last object was added.
+    inline void requireBuilt(bool built, const char *what) {
+        if (!built) {
+            throw std::runtime_error(std::string("Cannot intersect ") + what +
+                                     ". Objects were added since the last call to build().");
+        }
+    }
+}
+
+#endif //RAYTRACERCHALLENGE_OCCLUDER_CACHE_HPP
@@ -0,0 +1,117 @@
+#ifndef RAYTRACERCHALLENGE_CAMERA_HPP
+#define RAYTRACERCHALLENGE_CAMERA_HPP
+
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+
+#include "ray.hpp"
+#include "math/matrix.hpp"
+#include "utility/span.hpp"
+
+/***
+ * A pinhole camera whose canvas of `hsize` x `vsize` pixels sits one unit in front of the eye,
+ * `fieldOfView` radians wide along its longer side. `transform` is the view transformation
+ * (see `transformation::viewTransform`).
+ *
+ * Rays are generated without a matrix multiply per pixel: the inverse view transformation is
+ * applied once, to the direction of the first pixel and to the direction steps between two
+ * neighbouring pixels of a row and of a column. The direction of a pixel is then the first one
+ * plus whole steps, normalized.
+ */
+class Camera {
+
+    uint32_t width;
+    uint32_t height;
+    float fov;
+    Matrix4 view;
+    Matrix4 inverseView;
+
+    float halfWidth {0};
+    float halfHeight {0};
+    float size {0};
+
+    // World space: the eye, the direction of the center of pixel (0, 0) and the steps to the next pixel.
+    Point eye {point(0, 0, 0)};
+    Vector firstDirection {vector(0, 0, 0)};
+    Vector stepX {vector(0, 0, 0)};
+    Vector stepY {vector(0, 0, 0)};
+
+public:
+
+    Camera(uint32_t hsize, uint32_t vsize, float fieldOfView, const Matrix4 &transform = Matrix4::identity())
+            : width{hsize}, height{vsize}, fov{fieldOfView}, view{transform}, inverseView{transform} {
+        if (hsize == 0 || vsize == 0) throw std::runtime_error("Cannot create the camera. The canvas is empty.");
+        if (!(fieldOfView > 0 && fieldOfView < PI)) {
+            throw std::runtime_error("Cannot create the camera. The field of view must be between 0 and PI.");
+        }
+        setTransform(transform);
+    }
+
+    [[nodiscard]] uint32_t hsize() const { return width; }
+
+    [[nodiscard]] uint32_t vsize() const { return height; }
+
+    [[nodiscard]] float fieldOfView() const { return fov; }
+
+    // The side of a pixel on the canvas, in world units before the view transformation.
+    [[nodiscard]] float pixelSize() const { return size; }
+
+    [[nodiscard]] const Matrix4 &transform() const { return view; }
+
+    [[nodiscard]] const Matrix4 &inverse() const { return inverseView; }
+
+    void setTransform(const Matrix4 &transform) {
+        auto inverted = transform.inverse();
+        if (!inverted) throw std::runtime_error("Cannot set the camera transformation. The matrix is not invertible.");
+        view = transform;
+        inverseView = *inverted;
+
+        float halfView = std::tan(fov / 2);
+        float aspect = static_cast<float>(width) / static_cast<float>(height);
+        halfWidth = aspect >= 1 ? halfView : halfView * aspect;
+        halfHeight = aspect >= 1 ? halfView / aspect : halfView;
+        size = halfWidth * 2 / static_cast<float>(width);
+
+        eye = inverseView * point(0, 0, 0);
+        firstDirection = inverseView * point(halfWidth - size / 2, halfHeight - size / 2, -1) - eye;
+        stepX = inverseView * vector(-size, 0, 0);
+        stepY = inverseView * vector(0, -size, 0);
+    }
+
+    // The ray from the eye through the center of pixel (`px`, `py`), with a unit direction.
+    [[nodiscard]] Ray rayForPixel(uint32_t px, uint32_t py) const {
+        return rayAlong(firstDirection + stepY * static_cast<float>(py) + stepX * static_cast<float>(px));
+    }
+
+    /***
+     * Call `fn(px, py, ray)` for every pixel of the `w` x `h` rectangle at (`x`, `y`), row by row,
+     * with the ray of `rayForPixel`. Each pixel costs two vector additions and a normalization.
+     */
+    template<typename Fn>
+    void forEachRay(uint32_t x, uint32_t y, uint32_t w, uint32_t h, Fn &&fn) const {
+        for (uint32_t py = y; py < y + h; py++) {
+            // Steps are counted from the start of the row rather than added up, so that rounding
+            // errors do not pile up across a row thousands of pixels wide.
+            Vector rowStart = firstDirection + stepY * static_cast<float>(py) + stepX * static_cast<float>(x);
+            for (uint32_t i = 0; i < w; i++) fn(x + i, py, rayAlong(rowStart + stepX * static_cast<float>(i)));
+        }
+    }
+
+    // The rays of pixels (`x`, `y`) to (`x + rays.size() - 1`, `y`).
+    void row(uint32_t x, uint32_t y, Span<Ray> rays) const {
+        auto *out = rays.data();
+        forEachRay(x, y, static_cast<uint32_t>(rays.size()), 1, [out, x](uint32_t px, uint32_t, const Ray &ray) {
+            out[px - x] = ray;
+        });
+    }
+
+private:
+
+    [[nodiscard]] Ray rayAlong(const Vector &direction) const {
+        // Never null: the canvas is one unit in front of the eye.
+        return {eye, direction * (1 / direction.magnitude())};
+    }
+};
+
+#endif //RAYTRACERCHALLENGE_CAMERA_HPP
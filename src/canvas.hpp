@@ -3,40 +3,125 @@
 
 #include <vector>
 #include <cstdint>
+#include <algorithm>
 
 #include "pixel.hpp"
+#include "pixel_storage.hpp"
+#include "canvas_layout.hpp"
 
 #include "math/tuple.hpp"
 #include "io/ppm.hpp"
 
+/***
+ * A width x height grid of pixels, kept in memory in the compact representation chosen
+ * by `Storage` (see `pixel_storage.hpp`) and arranged according to `Layout` (see
+ * `canvas_layout.hpp`). Pixels are converted at `pixelAt`/`writePixelAt`.
+ */
+template<typename Storage, typename Layout = layout::RowMajor>
+class BasicCanvas {
 
-class Canvas {
+public:
+
+    using storage_type = Storage;
+    using layout_type = Layout;
+    using value_type = typename Storage::value_type;
+
+    // A rectangle of the canvas, at most `Layout::TILE_SIZE` pixels wide and high.
+    struct Tile {
+        uint32_t x {0};
+        uint32_t y {0};
+        uint32_t width {0};
+        uint32_t height {0};
+    };
 
-    std::vector<Pixel> pixels;
+private:
+
+    Layout layout;
+    std::vector<value_type> pixels;
 
 public:
 
     uint32_t width {0};
     uint32_t height {0};
 
-    Canvas(uint32_t width, uint32_t height) : width{width}, height{height} {
-        pixels.resize(width * height);
+    BasicCanvas(uint32_t width, uint32_t height) : layout{width, height}, width{width}, height{height} {
+        pixels.resize(layout.size(), Storage::encode(Pixel()));
     }
 
     [[nodiscard]] Pixel pixelAt(size_t x, size_t y) const {
-        return pixels[x + y * width];
+        return Storage::decode(pixels[layout.index(x, y)]);
     }
 
     void writePixelAt(size_t x, size_t y, Pixel pixel) {
-        pixels[x + y * width] = pixel;
+        pixels[layout.index(x, y)] = Storage::encode(pixel);
+    }
+
+    // The raw storage, in layout order (row-major only for `layout::RowMajor`).
+    [[nodiscard]] Span<const value_type> data() const {
+        return pixels;
+    }
+
+    [[nodiscard]] uint32_t tilesX() const { return (width + Layout::TILE_SIZE - 1) / Layout::TILE_SIZE; }
+
+    [[nodiscard]] uint32_t tilesY() const { return (height + Layout::TILE_SIZE - 1) / Layout::TILE_SIZE; }
+
+    [[nodiscard]] size_t tileCount() const { return static_cast<size_t>(tilesX()) * tilesY(); }
+
+    /***
+     * The `index`-th tile, counting in row-major order. Tiles on the right and bottom edges are
+     * clipped to the canvas. Distinct tiles never share pixels, so they can be written concurrently.
+     */
+    [[nodiscard]] Tile tile(size_t index) const {
+        const auto tx = static_cast<uint32_t>(index % tilesX()) * Layout::TILE_SIZE;
+        const auto ty = static_cast<uint32_t>(index / tilesX()) * Layout::TILE_SIZE;
+        return {tx, ty, std::min(Layout::TILE_SIZE, width - tx), std::min(Layout::TILE_SIZE, height - ty)};
     }
 
-    io::PPM ppm() const {
-        return io::PPM(
-                io::PPMHeader(io::PPMIdentifier::COLORMAP, width, height, 0xff),
-                pixels);
+    /***
+     * The storage of the `index`-th tile, `TILE_SIZE * TILE_SIZE` values (including padding) laid out
+     * by the layout. Only available when tiles are contiguous in memory.
+     */
+    [[nodiscard]] Span<value_type> tileData(size_t index) {
+        static_assert(Layout::CONTIGUOUS_TILES, "Tiles of this layout are not contiguous in memory!");
+        constexpr size_t tilePixels = static_cast<size_t>(Layout::TILE_SIZE) * Layout::TILE_SIZE;
+        return Span<value_type>(pixels.data() + index * tilePixels, tilePixels);
+    }
+
+    /***
+     * Write every pixel of `tile` with `shade(x, y)`, walking the tile storage in order instead of
+     * computing the index of each pixel, which is what makes blocked layouts worth it for tile workers.
+     */
+    template<typename Fn>
+    void fillTile(const Tile &tile, Fn &&shade) {
+        for (size_t y = tile.y; y < tile.y + tile.height; y++) {
+            if constexpr (Layout::CONTIGUOUS_TILE_ROWS) {
+                value_type *row = pixels.data() + layout.index(tile.x, y);
+                for (size_t x = tile.x; x < tile.x + tile.width; x++) {
+                    *row++ = Storage::encode(shade(x, y));
+                }
+            } else {
+                for (size_t x = tile.x; x < tile.x + tile.width; x++) {
+                    pixels[layout.index(x, y)] = Storage::encode(shade(x, y));
+                }
+            }
+        }
+    }
+
+    template<typename Fn>
+    void forEachTile(Fn &&fn) const {
+        for (size_t i = 0; i < tileCount(); i++) {
+            fn(tile(i));
+        }
+    }
+
+    io::BasicPPM<Storage, Layout> ppm(io::PPMIdentifier magic = io::PPMIdentifier::COLORMAP) const {
+        return io::BasicPPM<Storage, Layout>(
+                io::PPMHeader(magic, width, height, 0xff),
+                pixels, layout);
     }
 
 };
 
+using Canvas = BasicCanvas<storage::RGBA32F>;
+
 #endif //RAYTRACERCHALLENGE_CANVAS_HPP
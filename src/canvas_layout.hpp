@@ -0,0 +1,124 @@
+#ifndef RAYTRACERCHALLENGE_CANVAS_LAYOUT_HPP
+#define RAYTRACERCHALLENGE_CANVAS_LAYOUT_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+/***
+ * Memory layouts for `BasicCanvas`. A layout maps a pixel coordinate to its position in the
+ * canvas storage (`index`) and tells how much storage the canvas needs (`size`), which may
+ * include padding. `TILE_SIZE` is the side of the square tiles the canvas is iterated by;
+ * `CONTIGUOUS_TILE_ROWS` tells whether the pixels of a row inside a tile are adjacent in memory.
+ */
+namespace layout {
+
+    // Plain `x + y * width` indexing. Tiles are only a unit of iteration, their rows are not adjacent in memory.
+    struct RowMajor {
+
+        static constexpr bool ROW_MAJOR = true;
+        static constexpr bool CONTIGUOUS_TILES = false;
+        static constexpr bool CONTIGUOUS_TILE_ROWS = true;
+        static constexpr uint32_t TILE_SIZE = 16;
+
+        uint32_t width {0};
+        uint32_t height {0};
+
+        constexpr RowMajor(uint32_t width, uint32_t height) : width{width}, height{height} {}
+
+        [[nodiscard]] constexpr size_t size() const { return static_cast<size_t>(width) * height; }
+
+        [[nodiscard]] constexpr size_t index(size_t x, size_t y) const { return x + y * width; }
+    };
+
+    namespace detail {
+
+        constexpr uint32_t log2(uint32_t value) {
+            uint32_t result = 0;
+            while (value > 1) {
+                value >>= 1;
+                result += 1;
+            }
+            return result;
+        }
+
+        // Spread the low 8 bits of `value` over the even bits of the result.
+        constexpr uint32_t spreadBits(uint32_t value) {
+            value = (value | (value << 4)) & 0x0f0f;
+            value = (value | (value << 2)) & 0x3333;
+            value = (value | (value << 1)) & 0x5555;
+            return value;
+        }
+
+        /***
+         * Square blocks of TILE x TILE pixels stored one after the other, in row-major block order.
+         * `Local` orders the pixels inside a block. Edge blocks are padded to full size.
+         */
+        template<uint32_t TILE, typename Local>
+        struct Blocked {
+
+            static_assert(TILE != 0 && (TILE & (TILE - 1)) == 0, "Tile size must be a power of two!");
+
+            static constexpr bool ROW_MAJOR = false;
+            static constexpr bool CONTIGUOUS_TILES = true;
+            static constexpr bool CONTIGUOUS_TILE_ROWS = Local::CONTIGUOUS_ROWS;
+            static constexpr uint32_t TILE_SIZE = TILE;
+
+            uint32_t width {0};
+            uint32_t height {0};
+            uint32_t tilesX {0};
+            uint32_t tilesY {0};
+
+            constexpr Blocked(uint32_t width, uint32_t height) : width{width}, height{height},
+                                                                 tilesX{(width + TILE - 1) / TILE},
+                                                                 tilesY{(height + TILE - 1) / TILE} {}
+
+            [[nodiscard]] constexpr size_t size() const {
+                return static_cast<size_t>(tilesX) * tilesY * TILE * TILE;
+            }
+
+            // Split in a row and a column term so that the compiler can hoist the row term out of x loops.
+            [[nodiscard]] constexpr size_t index(size_t x, size_t y) const {
+                return rowOffset(y) + columnOffset(x);
+            }
+
+        private:
+
+            static constexpr uint32_t SHIFT = log2(TILE);
+            static constexpr size_t MASK = TILE - 1;
+
+            [[nodiscard]] constexpr size_t rowOffset(size_t y) const {
+                return ((y >> SHIFT) * tilesX << (2 * SHIFT)) + Local::rowOffset(y & MASK);
+            }
+
+            [[nodiscard]] static constexpr size_t columnOffset(size_t x) {
+                return ((x >> SHIFT) << (2 * SHIFT)) + Local::columnOffset(x & MASK);
+            }
+        };
+
+        template<uint32_t TILE>
+        struct RowMajorLocal {
+            static constexpr bool CONTIGUOUS_ROWS = true;
+            static constexpr size_t rowOffset(size_t y) { return y * TILE; }
+            static constexpr size_t columnOffset(size_t x) { return x; }
+        };
+
+        template<uint32_t TILE>
+        struct MortonLocal {
+            static constexpr bool CONTIGUOUS_ROWS = false;
+            static_assert(TILE <= 256, "Morton tiles larger than 256 pixels are not supported!");
+            // x and y land on disjoint bits, so the two terms can simply be added.
+            static constexpr size_t rowOffset(size_t y) { return spreadBits(static_cast<uint32_t>(y)) << 1; }
+            static constexpr size_t columnOffset(size_t x) { return spreadBits(static_cast<uint32_t>(x)); }
+        };
+    }
+
+    // 2D blocks, row-major inside each block.
+    template<uint32_t TILE = 8>
+    using Tiled = detail::Blocked<TILE, detail::RowMajorLocal<TILE>>;
+
+    // 2D blocks, Z-order (Morton) inside each block.
+    template<uint32_t TILE = 16>
+    using MortonTiled = detail::Blocked<TILE, detail::MortonLocal<TILE>>;
+}
+
+#endif //RAYTRACERCHALLENGE_CANVAS_LAYOUT_HPP
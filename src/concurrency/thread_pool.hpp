@@ -0,0 +1,150 @@
+#ifndef RAYTRACERCHALLENGE_THREAD_POOL_HPP
+#define RAYTRACERCHALLENGE_THREAD_POOL_HPP
+
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <utility>
+#include <exception>
+#include <functional>
+#include <condition_variable>
+
+namespace concurrency {
+
+    /***
+     * A fixed set of worker threads running tasks from a shared queue. Tasks are usually submitted
+     * through a `TaskGroup`, whose `wait()` runs queued tasks instead of blocking, so that tasks may
+     * themselves spawn and wait for subtasks without starving the pool. A pool of 0 threads is valid:
+     * every task then runs in the thread that waits for it.
+     */
+    class ThreadPool {
+
+        std::vector<std::thread> workers;
+        std::deque<std::function<void()>> queue;
+        std::mutex mutex;
+        std::condition_variable available;
+        bool stopping {false};
+
+        void work() {
+            while (true) {
+                std::function<void()> task;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    available.wait(lock, [this] { return stopping || !queue.empty(); });
+                    if (queue.empty()) return;
+                    task = std::move(queue.front());
+                    queue.pop_front();
+                }
+                task();
+            }
+        }
+
+    public:
+
+        explicit ThreadPool(size_t threads = std::thread::hardware_concurrency()) {
+            workers.reserve(threads);
+            for (size_t i = 0; i < threads; i++) {
+                workers.emplace_back([this] { work(); });
+            }
+        }
+
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        // Runs the tasks still queued, then joins the workers.
+        ~ThreadPool() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            available.notify_all();
+            for (auto &worker: workers) worker.join();
+        }
+
+        [[nodiscard]] size_t size() const { return workers.size(); }
+
+        // Tasks must not throw: use a `TaskGroup` to get their exceptions back.
+        void submit(std::function<void()> task) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                queue.push_back(std::move(task));
+            }
+            available.notify_one();
+        }
+
+        /***
+         * Run one queued task in the calling thread.
+         * @return false if the queue was empty.
+         */
+        bool runPending() {
+            std::function<void()> task;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (queue.empty()) return false;
+                task = std::move(queue.back());
+                queue.pop_back();
+            }
+            task();
+            return true;
+        }
+    };
+
+    /***
+     * Tasks submitted to a pool that are waited for together. The first exception thrown by a task
+     * is rethrown by `wait()`. A group that is destroyed, e.g. while an exception thrown between
+     * `run()` and `wait()` unwinds the stack, waits for its tasks first and drops their exceptions:
+     * declared after the state its tasks capture, it never lets them outlive it.
+     */
+    class TaskGroup {
+
+        ThreadPool &pool;
+        std::atomic<size_t> pending {0};
+        std::mutex mutex;
+        std::exception_ptr error;
+
+    public:
+
+        explicit TaskGroup(ThreadPool &pool) : pool{pool} {}
+
+        TaskGroup(const TaskGroup &) = delete;
+        TaskGroup &operator=(const TaskGroup &) = delete;
+
+        ~TaskGroup() { join(); }
+
+        template<typename Fn>
+        void run(Fn &&fn) {
+            pending.fetch_add(1, std::memory_order_relaxed);
+            pool.submit([this, fn = std::forward<Fn>(fn)]() mutable {
+                try {
+                    fn();
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (!error) error = std::current_exception();
+                }
+                pending.fetch_sub(1, std::memory_order_release);
+            });
+        }
+
+        // Help running queued tasks (of any group) until every task of this group has finished.
+        void wait() {
+            join();
+            if (error) {
+                auto e = error;
+                error = nullptr;
+                std::rethrow_exception(e);
+            }
+        }
+
+    private:
+
+        void join() {
+            while (pending.load(std::memory_order_acquire) != 0) {
+                if (!pool.runPending()) std::this_thread::yield();
+            }
+        }
+    };
+}
+
+#endif //RAYTRACERCHALLENGE_THREAD_POOL_HPP
@@ -0,0 +1,98 @@
+#ifndef RAYTRACERCHALLENGE_INTERSECTION_HPP
+#define RAYTRACERCHALLENGE_INTERSECTION_HPP
+
+#include <array>
+#include <limits>
+#include <cstddef>
+#include <optional>
+
+#include "math/tuple_packet.hpp"
+
+class Sphere;
+
+struct Intersection {
+    // Distance along the ray, in units of its direction.
+    float t {0};
+    const Sphere *object {nullptr};
+};
+
+/***
+ * Up to `CAPACITY` intersections sorted by `t`, stored inline so that collecting hits never
+ * allocates. When full, the farthest intersection is dropped to make room for a closer one.
+ */
+template<size_t CAPACITY>
+class Intersections {
+
+    static_assert(CAPACITY != 0, "Intersections must hold at least one intersection!");
+
+    std::array<Intersection, CAPACITY> items {};
+    size_t count {0};
+
+public:
+
+    constexpr Intersections() = default;
+
+    /***
+     * Insert `intersection` keeping the order by `t`.
+     * @return false if it was dropped because it is farther than every kept intersection of a full buffer.
+     */
+    constexpr bool add(const Intersection &intersection) {
+        if (count == CAPACITY) {
+            if (!(intersection.t < items[CAPACITY - 1].t)) return false;
+            count -= 1;
+        }
+        size_t i = count;
+        while (i > 0 && intersection.t < items[i - 1].t) {
+            items[i] = items[i - 1];
+            i -= 1;
+        }
+        items[i] = intersection;
+        count += 1;
+        return true;
+    }
+
+    constexpr void clear() { count = 0; }
+
+    [[nodiscard]] constexpr size_t size() const { return count; }
+
+    [[nodiscard]] constexpr bool empty() const { return count == 0; }
+
+    [[nodiscard]] static constexpr size_t capacity() { return CAPACITY; }
+
+    constexpr const Intersection &operator[](size_t i) const { return items[i]; }
+
+    [[nodiscard]] constexpr const Intersection *begin() const { return items.data(); }
+
+    [[nodiscard]] constexpr const Intersection *end() const { return items.data() + count; }
+
+    // The visible intersection: the one with the lowest non-negative `t`.
+    [[nodiscard]] constexpr std::optional<Intersection> hit() const {
+        for (size_t i = 0; i < count; i++) {
+            if (items[i].t >= 0) return items[i];
+        }
+        return {};
+    }
+};
+
+/***
+ * The intersections of a packet of rays with one object: the entry and exit distances of every
+ * lane, valid where `mask` is set.
+ */
+template<size_t N>
+struct IntersectionPacket {
+
+    FloatxN<N> t0;
+    FloatxN<N> t1;
+    MaskxN<N> mask;
+
+    // The lowest non-negative `t` of every lane, infinity for the lanes without a hit.
+    [[nodiscard]] FloatxN<N> hit() const {
+        const auto zero = FloatxN<N>::broadcast(0);
+        const auto none = FloatxN<N>::broadcast(std::numeric_limits<float>::infinity());
+        auto front = mask & ~t0.less(zero);
+        auto back = mask & ~t1.less(zero);
+        return select(front, t0, select(back, t1, none));
+    }
+};
+
+#endif //RAYTRACERCHALLENGE_INTERSECTION_HPP
@@ -0,0 +1,90 @@
+#ifndef RAYTRACERCHALLENGE_MAPPED_FILE_HPP
+#define RAYTRACERCHALLENGE_MAPPED_FILE_HPP
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <utility>
+#include <stdexcept>
+#include <filesystem>
+#include <string_view>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define RAYTRACER_MMAP 1
+#else
+#define RAYTRACER_MMAP 0
+#endif
+
+namespace io {
+
+    /***
+     * The read-only contents of a file. On POSIX systems the file is memory mapped, so the pages are
+     * read by the kernel as they are touched and never copied; elsewhere it is read into a buffer.
+     */
+    class MappedFile {
+
+        const char *bytes {nullptr};
+        size_t length {0};
+#if !RAYTRACER_MMAP
+        std::vector<char> buffer;
+#endif
+
+    public:
+
+        explicit MappedFile(const std::filesystem::path &path) {
+#if RAYTRACER_MMAP
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0) {
+                throw std::runtime_error("Cannot open " + path.string() + ".");
+            }
+            struct stat status {};
+            if (::fstat(fd, &status) != 0) {
+                ::close(fd);
+                throw std::runtime_error("Cannot read " + path.string() + ".");
+            }
+            length = static_cast<size_t>(status.st_size);
+            if (length != 0) {
+                void *mapped = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (mapped == MAP_FAILED) {
+                    ::close(fd);
+                    throw std::runtime_error("Cannot map " + path.string() + ".");
+                }
+                // Parsers read front to back.
+                ::madvise(mapped, length, MADV_SEQUENTIAL);
+                bytes = static_cast<const char *>(mapped);
+            }
+            ::close(fd);
+#else
+            std::FILE *file = std::fopen(path.string().c_str(), "rb");
+            if (!file) {
+                throw std::runtime_error("Cannot open " + path.string() + ".");
+            }
+            buffer.resize(static_cast<size_t>(std::filesystem::file_size(path)));
+            length = std::fread(buffer.data(), 1, buffer.size(), file);
+            std::fclose(file);
+            bytes = buffer.data();
+#endif
+        }
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        ~MappedFile() {
+#if RAYTRACER_MMAP
+            if (bytes) ::munmap(const_cast<char *>(bytes), length);
+#endif
+        }
+
+        [[nodiscard]] const char *data() const { return bytes; }
+
+        [[nodiscard]] size_t size() const { return length; }
+
+        [[nodiscard]] std::string_view view() const { return {bytes, length}; }
+    };
+}
+
+#endif //RAYTRACERCHALLENGE_MAPPED_FILE_HPP
@@ -0,0 +1,175 @@
+#ifndef RAYTRACERCHALLENGE_OBJ_HPP
+#define RAYTRACERCHALLENGE_OBJ_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <charconv>
+#include <stdexcept>
+#include <filesystem>
+#include <string_view>
+
+#include "mapped_file.hpp"
+#include "../shapes/mesh.hpp"
+
+namespace io {
+
+    namespace obj {
+
+        inline bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+        inline const char *skipSpaces(const char *p, const char *end) {
+            while (p != end && isSpace(*p)) p++;
+            return p;
+        }
+
+        // The start of the line after the one at `p`, or `end`.
+        inline const char *nextLine(const char *p, const char *end) {
+            while (p != end && *p != '\n') p++;
+            return p == end ? end : p + 1;
+        }
+
+        [[noreturn]] inline void fail(const char *what, size_t line) {
+            throw std::runtime_error("Cannot parse OBJ. " + std::string(what) + " at line " + std::to_string(line) + ".");
+        }
+
+        inline const char *parseFloat(const char *p, const char *end, float &value, size_t line) {
+            p = skipSpaces(p, end);
+            // from_chars does not accept the leading '+' that some exporters write.
+            if (p != end && *p == '+') p++;
+            auto [next, error] = std::from_chars(p, end, value);
+            if (error != std::errc()) fail("Invalid number", line);
+            return next;
+        }
+
+        // Turn a 1-based (or negative, relative to the end) OBJ index into a 0-based one.
+        inline uint32_t resolve(int64_t index, size_t count, size_t line) {
+            int64_t resolved = index < 0 ? static_cast<int64_t>(count) + index : index - 1;
+            if (index == 0 || resolved < 0 || resolved >= static_cast<int64_t>(count)) fail("Index out of range", line);
+            return static_cast<uint32_t>(resolved);
+        }
+
+        inline const char *parseIndex(const char *p, const char *end, int64_t &value, size_t line) {
+            auto [next, error] = std::from_chars(p, end, value);
+            if (error != std::errc()) fail("Invalid index", line);
+            return next;
+        }
+
+        // The vertices of the face whose first one is at or after `p`: the words up to the end of the line or a comment.
+        inline size_t countVertices(const char *p, const char *end) {
+            size_t count = 0;
+            while (true) {
+                p = skipSpaces(p, end);
+                if (p == end || *p == '\n' || *p == '#') return count;
+                count++;
+                while (p != end && !isSpace(*p) && *p != '\n' && *p != '#') p++;
+            }
+        }
+
+        // Whether the line at `p` starts with the keyword `keyword` followed by a space.
+        inline bool startsWith(const char *p, const char *end, std::string_view keyword) {
+            return static_cast<size_t>(end - p) > keyword.size() &&
+                   std::string_view(p, keyword.size()) == keyword && isSpace(p[keyword.size()]);
+        }
+    }
+
+    /***
+     * Parse the geometry of a Wavefront OBJ file: vertices (`v`), normals (`vn`) and faces (`f`), in
+     * any of the `v`, `v/vt`, `v//vn` and `v/vt/vn` forms, with 1-based or negative indices. Polygons
+     * are split in fans of triangles; faces without normals keep their geometric normal, even in a file
+     * where other faces have normals. Everything else (texture coordinates, groups, materials) is
+     * skipped. The text is scanned in place and numbers are parsed with `std::from_chars`, so no
+     * string or stream is created per token.
+     */
+    inline Mesh parseObj(std::string_view text) {
+
+        using namespace obj;
+
+        const char *p = text.data();
+        const char *end = text.data() + text.size();
+
+        // A first quick pass counts the records, and the triangles of each face, so that the mesh
+        // arrays are allocated once.
+        size_t vertices = 0, normals = 0, triangles = 0;
+        for (const char *line = p; line < end; line = nextLine(line, end)) {
+            line = skipSpaces(line, end);
+            if (startsWith(line, end, "v")) {
+                vertices++;
+            } else if (startsWith(line, end, "vn")) {
+                normals++;
+            } else if (startsWith(line, end, "f")) {
+                auto corners = countVertices(line + 1, end);
+                if (corners >= 3) triangles += corners - 2;
+            }
+        }
+
+        Mesh mesh;
+        mesh.reserve(vertices, normals, triangles);
+
+        std::vector<uint32_t> positions, faceNormals;
+        size_t lineNumber = 0;
+
+        for (; p < end; p = nextLine(p, end)) {
+            lineNumber++;
+            p = skipSpaces(p, end);
+
+            if (startsWith(p, end, "v")) {
+                float x, y, z;
+                p = parseFloat(p + 1, end, x, lineNumber);
+                p = parseFloat(p, end, y, lineNumber);
+                p = parseFloat(p, end, z, lineNumber);
+                mesh.addVertex(x, y, z);
+            } else if (startsWith(p, end, "vn")) {
+                float x, y, z;
+                p = parseFloat(p + 2, end, x, lineNumber);
+                p = parseFloat(p, end, y, lineNumber);
+                p = parseFloat(p, end, z, lineNumber);
+                mesh.addNormal(x, y, z);
+            } else if (startsWith(p, end, "f")) {
+                positions.clear();
+                faceNormals.clear();
+                p = skipSpaces(p + 1, end);
+                while (p != end && *p != '\n' && *p != '#') {
+                    int64_t index;
+                    p = parseIndex(p, end, index, lineNumber);
+                    positions.push_back(resolve(index, mesh.vertexCount(), lineNumber));
+                    if (p != end && *p == '/') {
+                        p++;
+                        // The texture coordinate, if any, is not used.
+                        if (p != end && *p != '/' && *p != '#') p = parseIndex(p, end, index, lineNumber);
+                        if (p != end && *p == '/') {
+                            p = parseIndex(p + 1, end, index, lineNumber);
+                            faceNormals.push_back(resolve(index, mesh.normalCount(), lineNumber));
+                        }
+                    }
+                    // A comment may follow the last index directly, as in `f 1 2 3#x`.
+                    if (p != end && !isSpace(*p) && *p != '\n' && *p != '#') fail("Invalid face", lineNumber);
+                    p = skipSpaces(p, end);
+                }
+
+                if (positions.size() < 3) fail("Face with less than 3 vertices", lineNumber);
+                // A face with a normal missing on any of its vertices gets the geometric normal.
+                bool withNormals = !faceNormals.empty() && faceNormals.size() == positions.size();
+
+                for (size_t k = 1; k + 1 < positions.size(); k++) {
+                    if (withNormals) {
+                        mesh.addTriangle(positions[0], positions[k], positions[k + 1],
+                                         faceNormals[0], faceNormals[k], faceNormals[k + 1]);
+                    } else {
+                        mesh.addTriangle(positions[0], positions[k], positions[k + 1]);
+                    }
+                }
+            }
+        }
+
+        return mesh;
+    }
+
+    // Map and parse the OBJ file at `path` (see `parseObj`).
+    inline Mesh loadObj(const std::filesystem::path &path) {
+        MappedFile file(path);
+        return parseObj(file.view());
+    }
+}
+
+#endif //RAYTRACERCHALLENGE_OBJ_HPP
@@ -2,17 +2,24 @@
 #define RAYTRACERCHALLENGE_PPM_HPP
 
 #include <string>
+#include <vector>
+#include <cstdint>
 #include <ostream>
 #include <algorithm>
+#include <type_traits>
 
 #include "../pixel.hpp"
+#include "../pixel_storage.hpp"
+#include "../canvas_layout.hpp"
+#include "../utility/span.hpp"
 
 namespace io {
 
     enum class PPMIdentifier {
         BITMAP,
         GRAYMAP,
-        COLORMAP
+        COLORMAP,
+        COLORMAP_BINARY
     };
 
     struct PPMHeader {
@@ -31,7 +38,9 @@ namespace io {
                 case PPMIdentifier::BITMAP: return "P1";
                 case PPMIdentifier::GRAYMAP: return "P2";
                 case PPMIdentifier::COLORMAP: return "P3";
+                case PPMIdentifier::COLORMAP_BINARY: return "P6";
             }
+            return "";
         }
 
         friend std::ostream &operator<<(std::ostream &os, const PPMHeader &header) {
@@ -42,33 +51,234 @@ namespace io {
         }
     };
 
-    struct PPM {
-        PPMHeader header;
-        std::vector<Pixel> data;
+    namespace ppm {
+
+        // The PPM specification asks for lines no longer than 70 characters.
+        static constexpr size_t MAX_LINE_LENGTH = 70;
+
+        // Size of the scratch buffer used by the ASCII encoder, flushed to the stream whenever it fills up.
+        static constexpr size_t ASCII_CHUNK_SIZE = 64 * 1024;
+
+        // Upper bound of the scratch buffer used by the binary encoder (it always holds at least one row).
+        static constexpr size_t BINARY_CHUNK_SIZE = 256 * 1024;
+
+        /***
+         * Scale a color channel in [0, 1] to [0, maximumColorValue], clamping values out of range.
+         * @param channel The channel value to quantize.
+         * @param maximumColorValue The maximum value allowed by the PPM header.
+         * @return The quantized channel, rounded to the nearest integer.
+         */
+        inline uint32_t quantize(float channel, uint32_t maximumColorValue) {
+            // Written this way so that NaN maps to 0 too.
+            if (!(channel > 0.f)) return 0;
+            if (channel >= 1.f) return maximumColorValue;
+            return static_cast<uint32_t>(channel * static_cast<float>(maximumColorValue) + 0.5f);
+        }
 
-        explicit PPM(const PPMHeader header, const std::vector<Pixel> &_data) : header(header) {
-            std::copy(_data.begin(), _data.end(), std::back_inserter(data));
+        /***
+         * Write the decimal representation of `value` to `out`, without any terminator.
+         * @return The number of characters written (at most 10).
+         */
+        inline size_t formatUnsigned(char *out, uint32_t value) {
+            char digits[10];
+            size_t length = 0;
+            do {
+                digits[length++] = static_cast<char>('0' + value % 10);
+                value /= 10;
+            } while (value != 0);
+            for (size_t i = 0; i < length; i++) {
+                out[i] = digits[length - i - 1];
+            }
+            return length;
         }
 
-        friend std::ostream &operator<<(std::ostream &os, const PPM &ppm) {
-            os << ppm.header << "\n";
-            for (std::size_t i = 0; i < ppm.header.height; i += 1) {
-                for (std::size_t j = 0; j < ppm.header.width; j += 1) {
-                    auto pixel = &ppm.data[j + i * ppm.header.width];
+        /***
+         * Encode pixels as P3 samples. Every row starts on a new line and lines are wrapped
+         * at `MAX_LINE_LENGTH` characters. Samples are formatted into a fixed-size buffer which
+         * is handed to the stream in bulk, instead of going through `operator<<` per sample.
+         */
+        template<typename Storage = storage::RGBA32F>
+        void writeAscii(std::ostream &os, const typename Storage::value_type *pixels, uint32_t width, uint32_t height,
+                        uint32_t maximumColorValue) {
+
+            std::vector<char> buffer(ASCII_CHUNK_SIZE);
+            size_t used = 0;
+
+            for (size_t i = 0; i < height; i += 1) {
+                size_t lineLength = 0;
+                for (size_t j = 0; j < width; j += 1) {
+                    const auto color = Storage::decode(pixels[j + i * width]).color;
+                    const uint32_t samples[3] = {
+                            quantize(color.x, maximumColorValue),
+                            quantize(color.y, maximumColorValue),
+                            quantize(color.z, maximumColorValue)
+                    };
+
+                    // Three samples with their separators never need more than this.
+                    if (buffer.size() - used < 3 * 11) {
+                        os.write(buffer.data(), static_cast<std::streamsize>(used));
+                        used = 0;
+                    }
+
+                    for (auto sample: samples) {
+                        char token[10];
+                        auto tokenLength = formatUnsigned(token, sample);
+
+                        if (lineLength != 0) {
+                            if (lineLength + 1 + tokenLength > MAX_LINE_LENGTH) {
+                                buffer[used++] = '\n';
+                                lineLength = 0;
+                            } else {
+                                buffer[used++] = ' ';
+                                lineLength += 1;
+                            }
+                        }
 
-                    auto red = static_cast<int>(pixel->color.x * ppm.header.maximumColorValue);
-                    auto green = static_cast<int>(pixel->color.y * ppm.header.maximumColorValue);
-                    auto blue = static_cast<int>(pixel->color.z * ppm.header.maximumColorValue);
+                        std::copy(token, token + tokenLength, buffer.data() + used);
+                        used += tokenLength;
+                        lineLength += tokenLength;
+                    }
+                }
+                if (used == buffer.size()) {
+                    os.write(buffer.data(), static_cast<std::streamsize>(used));
+                    used = 0;
+                }
+                buffer[used++] = '\n';
+            }
+
+            os.write(buffer.data(), static_cast<std::streamsize>(used));
+        }
+
+        /***
+         * Quantize `count` pixels into P6 samples at `out`, which must hold `count * 3 * bytesPerSample(maximumColorValue)` bytes.
+         * Samples take two bytes (most significant first) when `maximumColorValue` does not fit in a byte.
+         */
+        template<typename Storage = storage::RGBA32F>
+        void encodeBinary(const typename Storage::value_type *pixels, size_t count, uint8_t *out,
+                          uint32_t maximumColorValue) {
+            if constexpr (std::is_same_v<Storage, storage::RGBA8>) {
+                if (maximumColorValue == 0xff) {
+                    // Already quantized, only the alpha channel has to be dropped.
+                    for (size_t i = 0; i < count; i++) {
+                        const auto &value = pixels[i];
+                        *out++ = value.r;
+                        *out++ = value.g;
+                        *out++ = value.b;
+                    }
+                    return;
+                }
+            }
 
-                    os << std::clamp(red, 0, static_cast<int>(ppm.header.maximumColorValue)) << " "
-                       << std::clamp(green, 0, static_cast<int>(ppm.header.maximumColorValue)) << " "
-                       << std::clamp(blue, 0, static_cast<int>(ppm.header.maximumColorValue)) << "\t";
+            if (maximumColorValue <= 0xff) {
+                for (size_t i = 0; i < count; i++) {
+                    const auto color = Storage::decode(pixels[i]).color;
+                    *out++ = static_cast<uint8_t>(quantize(color.x, maximumColorValue));
+                    *out++ = static_cast<uint8_t>(quantize(color.y, maximumColorValue));
+                    *out++ = static_cast<uint8_t>(quantize(color.z, maximumColorValue));
+                }
+            } else {
+                for (size_t i = 0; i < count; i++) {
+                    const auto color = Storage::decode(pixels[i]).color;
+                    for (auto channel: {color.x, color.y, color.z}) {
+                        auto sample = quantize(channel, maximumColorValue);
+                        *out++ = static_cast<uint8_t>(sample >> 8);
+                        *out++ = static_cast<uint8_t>(sample & 0xff);
+                    }
+                }
+            }
+        }
+
+        inline size_t bytesPerSample(uint32_t maximumColorValue) {
+            return maximumColorValue > 0xff ? 2 : 1;
+        }
+
+        /***
+         * Encode pixels as P6 samples. Whole rows are quantized into one contiguous buffer of at most
+         * `BINARY_CHUNK_SIZE` bytes and written with a single call per band, so frames that fit the
+         * buffer are written at once and larger ones never need a copy of the whole image.
+         */
+        template<typename Storage = storage::RGBA32F>
+        void writeBinary(std::ostream &os, const typename Storage::value_type *pixels, uint32_t width, uint32_t height,
+                         uint32_t maximumColorValue) {
+
+            const size_t rowSize = static_cast<size_t>(width) * 3 * bytesPerSample(maximumColorValue);
+            if (rowSize == 0 || height == 0) return;
+
+            const size_t rowsPerBand = std::clamp<size_t>(BINARY_CHUNK_SIZE / rowSize, 1, height);
+            std::vector<uint8_t> buffer(rowsPerBand * rowSize);
+
+            for (size_t row = 0; row < height; row += rowsPerBand) {
+                const size_t rows = std::min(rowsPerBand, height - row);
+                encodeBinary<Storage>(pixels + row * width, rows * width, buffer.data(), maximumColorValue);
+                os.write(reinterpret_cast<const char *>(buffer.data()), static_cast<std::streamsize>(rows * rowSize));
+            }
+        }
+    }
+
+    /***
+     * A PPM image borrowing its pixels, stored according to `Storage` and `Layout`, from the caller
+     * (usually a `Canvas`), which must outlive it. Serializing it never copies the whole pixel data:
+     * row-major pixels are encoded in place, other layouts are gathered a band of rows at a time.
+     */
+    template<typename Storage, typename Layout = layout::RowMajor>
+    struct BasicPPM {
+        using value_type = typename Storage::value_type;
+
+        PPMHeader header;
+        Span<const value_type> data;
+        Layout layout;
+
+        explicit BasicPPM(const PPMHeader header, Span<const value_type> data) : BasicPPM(
+                header, data, Layout(header.width, header.height)) {}
+
+        BasicPPM(const PPMHeader header, Span<const value_type> data, const Layout &layout) : header(header),
+                                                                                             data(data),
+                                                                                             layout(layout) {}
+
+        friend std::ostream &operator<<(std::ostream &os, const BasicPPM &ppm) {
+            const auto &header = ppm.header;
+            os << header << "\n";
+
+            if constexpr (Layout::ROW_MAJOR) {
+                ppm.writeRows(os, ppm.data.data(), header.height);
+            } else {
+                if (header.width == 0) return os;
+
+                const size_t rowsPerBand = std::clamp<size_t>(
+                        GATHER_BAND_PIXELS / header.width, 1, std::max<size_t>(header.height, 1));
+                std::vector<value_type> band(rowsPerBand * header.width);
+
+                for (size_t row = 0; row < header.height; row += rowsPerBand) {
+                    const size_t rows = std::min<size_t>(rowsPerBand, header.height - row);
+                    for (size_t y = 0; y < rows; y++) {
+                        for (size_t x = 0; x < header.width; x++) {
+                            band[x + y * header.width] = ppm.data[ppm.layout.index(x, row + y)];
+                        }
+                    }
+                    ppm.writeRows(os, band.data(), static_cast<uint32_t>(rows));
                 }
             }
-            os << "\n";
             return os;
         }
+
+    private:
+
+        // Upper bound of the pixels gathered at once when the layout is not row-major.
+        static constexpr size_t GATHER_BAND_PIXELS = 64 * 1024;
+
+        void writeRows(std::ostream &os, const value_type *rows, uint32_t count) const {
+            switch (header.magic) {
+                case PPMIdentifier::COLORMAP_BINARY:
+                    ppm::writeBinary<Storage>(os, rows, header.width, count, header.maximumColorValue);
+                    break;
+                default:
+                    ppm::writeAscii<Storage>(os, rows, header.width, count, header.maximumColorValue);
+                    break;
+            }
+        }
     };
+
+    using PPM = BasicPPM<storage::RGBA32F>;
 }
 
 #endif //RAYTRACERCHALLENGE_PPM_HPP
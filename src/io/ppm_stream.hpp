@@ -0,0 +1,90 @@
+#ifndef RAYTRACERCHALLENGE_PPM_STREAM_HPP
+#define RAYTRACERCHALLENGE_PPM_STREAM_HPP
+
+#include <vector>
+#include <cstdint>
+#include <ostream>
+#include <stdexcept>
+
+#include "ppm.hpp"
+#include "../canvas.hpp"
+
+namespace io {
+
+    /***
+     * Incremental PPM encoder for frames that do not fit in memory. The header is written on
+     * construction, then renderers push completed bands of rows (top to bottom) which are encoded
+     * and flushed right away. Memory usage is bounded by the largest band pushed, not by the image.
+     */
+    class PPMStream {
+
+        std::ostream &os;
+        PPMHeader header;
+        uint32_t rowsWritten {0};
+        std::vector<uint8_t> scratch;
+
+    public:
+
+        PPMStream(std::ostream &os, const PPMHeader &header) : os(os), header(header) {
+            if (header.magic != PPMIdentifier::COLORMAP && header.magic != PPMIdentifier::COLORMAP_BINARY) {
+                throw std::runtime_error("Cannot stream PPM. Only P3 and P6 images are supported.");
+            }
+            os << header << "\n";
+        }
+
+        /***
+         * Encode and flush a band of rows.
+         * @param rows Row-major pixels of one or more complete rows, continuing where the previous band ended.
+         */
+        template<typename Storage = storage::RGBA32F>
+        void writeRows(Span<const typename Storage::value_type> rows) {
+
+            if (header.width == 0 || rows.size() % header.width != 0) {
+                throw std::runtime_error("Cannot write PPM band. Band must be made of complete rows.");
+            }
+
+            const auto count = static_cast<uint32_t>(rows.size() / header.width);
+            if (count > rowsRemaining()) {
+                throw std::runtime_error("Cannot write PPM band. Band exceeds image height.");
+            }
+
+            if (header.magic == PPMIdentifier::COLORMAP_BINARY) {
+                scratch.resize(rows.size() * 3 * ppm::bytesPerSample(header.maximumColorValue));
+                ppm::encodeBinary<Storage>(rows.data(), rows.size(), scratch.data(), header.maximumColorValue);
+                os.write(reinterpret_cast<const char *>(scratch.data()), static_cast<std::streamsize>(scratch.size()));
+            } else {
+                ppm::writeAscii<Storage>(os, rows.data(), header.width, count, header.maximumColorValue);
+            }
+
+            os.flush();
+            rowsWritten += count;
+        }
+
+        /***
+         * Encode and flush a band rendered into its own canvas, as wide as the image.
+         */
+        template<typename Storage, typename Layout>
+        void writeRows(const BasicCanvas<Storage, Layout> &band) {
+            if (band.width != header.width) {
+                throw std::runtime_error("Cannot write PPM band. Band width differs from image width.");
+            }
+            if constexpr (Layout::ROW_MAJOR) {
+                writeRows<Storage>(band.data());
+            } else {
+                std::vector<typename Storage::value_type> rows(static_cast<size_t>(band.width) * band.height);
+                for (size_t y = 0; y < band.height; y++) {
+                    for (size_t x = 0; x < band.width; x++) {
+                        rows[x + y * band.width] = Storage::encode(band.pixelAt(x, y));
+                    }
+                }
+                writeRows<Storage>(rows);
+            }
+        }
+
+        [[nodiscard]] uint32_t rowsRemaining() const { return header.height - rowsWritten; }
+
+        [[nodiscard]] bool complete() const { return rowsWritten == header.height; }
+    };
+}
+
+#endif //RAYTRACERCHALLENGE_PPM_STREAM_HPP
@@ -0,0 +1,48 @@
+#ifndef RAYTRACERCHALLENGE_SNAPSHOT_HPP
+#define RAYTRACERCHALLENGE_SNAPSHOT_HPP
+
+#include <string>
+#include <fstream>
+#include <stdexcept>
+#include <filesystem>
+#include <system_error>
+
+#include "ppm.hpp"
+#include "../canvas.hpp"
+
+namespace io {
+
+    /***
+     * Write `canvas` as a PPM file at `path`, atomically: the image is written to a temporary file
+     * next to it, which then replaces `path` in one rename. Readers, or a render interrupted while
+     * writing, see either the previous snapshot or the new one, never a truncated file.
+     */
+    template<typename Storage, typename Layout>
+    void writeSnapshot(const std::filesystem::path &path, const BasicCanvas<Storage, Layout> &canvas,
+                       PPMIdentifier magic = PPMIdentifier::COLORMAP_BINARY) {
+
+        auto temporary = path;
+        temporary += ".partial";
+
+        {
+            std::ofstream file(temporary, std::ofstream::out | std::ofstream::trunc | std::ofstream::binary);
+            if (!file) {
+                throw std::runtime_error("Cannot write snapshot. Unable to open " + temporary.string() + ".");
+            }
+            file << canvas.ppm(magic);
+            file.flush();
+            if (!file) {
+                throw std::runtime_error("Cannot write snapshot. Unable to write " + temporary.string() + ".");
+            }
+        }
+
+        std::error_code error;
+        std::filesystem::rename(temporary, path, error);
+        if (error) {
+            std::filesystem::remove(temporary, error);
+            throw std::runtime_error("Cannot write snapshot. Unable to replace " + path.string() + ".");
+        }
+    }
+}
+
+#endif //RAYTRACERCHALLENGE_SNAPSHOT_HPP
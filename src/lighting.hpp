@@ -0,0 +1,139 @@
+#ifndef RAYTRACERCHALLENGE_LIGHTING_HPP
+#define RAYTRACERCHALLENGE_LIGHTING_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+
+#include "material.hpp"
+#include "math/tuple_packet.hpp"
+#include "utility/span.hpp"
+
+// `in` reflected around `normal`, which must be normalized.
+inline Vector reflect(const Vector &in, const Vector &normal) {
+    return in - normal * (2 * in.dot(normal));
+}
+
+/***
+ * The Phong reflection model: the color of `position`, on a surface of `material` with `normal`,
+ * lit by `light` and seen along `eye` (from the point towards the eye). Both vectors must be
+ * normalized. A point in shadow only gets the ambient term.
+ */
+inline Color lighting(const Material &material, const PointLight &light, const Point &position,
+                      const Vector &eye, const Vector &normal, bool inShadow = false) {
+
+    auto effective = material.color * light.intensity;
+    auto toLight = light.position - position;
+    toLight = toLight.normalize().value_or(toLight);
+    auto ambient = effective * material.ambient;
+    if (inShadow) return ambient;
+
+    // A negative cosine means the light is on the other side of the surface.
+    float lightDotNormal = toLight.dot(normal);
+    if (lightDotNormal < 0) return ambient;
+
+    auto diffuse = effective * (material.diffuse * lightDotNormal);
+    float reflectDotEye = reflect(-toLight, normal).dot(eye);
+    if (reflectDotEye <= 0) return ambient + diffuse;
+
+    float factor = std::pow(reflectDotEye, material.shininess);
+    return ambient + diffuse + light.intensity * (material.specular * factor);
+}
+
+// What shading needs to know about a hit.
+struct HitRecord {
+    Point position {point(0, 0, 0)};
+    Vector eye {vector(0, 0, 0)};
+    Vector normal {vector(0, 0, 0)};
+    const Material *material {nullptr};
+    bool inShadow {false};
+};
+
+/***
+ * N hit records in structure-of-arrays layout, so that `lighting` computes N colors with the
+ * packet operations used by intersection. Lanes not set in `active` are shaded black.
+ */
+template<size_t N>
+struct HitBatch {
+
+    Tuple4xN<N> position;
+    Tuple4xN<N> eye;
+    Tuple4xN<N> normal;
+    Tuple4xN<N> color;
+    FloatxN<N> ambient;
+    FloatxN<N> diffuse;
+    FloatxN<N> specular;
+    FloatxN<N> shininess;
+    MaskxN<N> active;
+    MaskxN<N> inShadow;
+
+    void setLane(size_t i, const HitRecord &hit) {
+        position.setLane(i, hit.position);
+        eye.setLane(i, hit.eye);
+        normal.setLane(i, hit.normal);
+        color.setLane(i, hit.material->color);
+        ambient[i] = hit.material->ambient;
+        diffuse[i] = hit.material->diffuse;
+        specular[i] = hit.material->specular;
+        shininess[i] = hit.material->shininess;
+        active.lanes[i] = -1;
+        inShadow.lanes[i] = hit.inShadow ? -1 : 0;
+    }
+
+    // Load `hits[offset]` onward; lanes past the end of `hits` stay inactive.
+    static HitBatch gather(Span<const HitRecord> hits, size_t offset = 0) {
+        HitBatch batch;
+        for (size_t i = 0; i < N && offset + i < hits.size(); i++) batch.setLane(i, hits[offset + i]);
+        return batch;
+    }
+};
+
+// `lighting` for every lane of `hits`, all lit by `light`.
+template<size_t N>
+Tuple4xN<N> lighting(const HitBatch<N> &hits, const PointLight &light) {
+
+    const auto zero = FloatxN<N>{};
+    const auto intensity = Tuple4xN<N>::broadcast(light.intensity);
+
+    auto effective = hits.color * intensity;
+    auto toLight = (Tuple4xN<N>::broadcast(light.position) - hits.position).normalize();
+    auto ambient = effective * hits.ambient;
+
+    auto lightDotNormal = toLight.dot(hits.normal);
+    auto lit = hits.active & ~hits.inShadow & ~lightDotNormal.less(zero);
+    auto diffuse = effective * (hits.diffuse * lightDotNormal);
+
+    // reflect(-toLight, normal) . eye
+    auto reflected = hits.normal * (lightDotNormal * FloatxN<N>::broadcast(2)) - toLight;
+    auto reflectDotEye = reflected.dot(hits.eye);
+    auto highlight = lit & reflectDotEye.greater(zero);
+
+    // There is no packet `pow`; only the lanes with a highlight pay for the scalar one.
+    FloatxN<N> factor;
+    for (size_t i = 0; i < N; i++) {
+        factor[i] = highlight[i] ? std::pow(reflectDotEye[i], hits.shininess[i]) : 0.f;
+    }
+    auto specular = intensity * (hits.specular * factor);
+
+    auto black = Tuple4xN<N>{};
+    return select(hits.active, ambient, black) + select(lit, diffuse + specular, black);
+}
+
+/***
+ * Shade every record of `hits`, lit by `light`, N at a time, into `colors`.
+ * @param colors Where to write the colors, as many as `hits`.
+ */
+template<size_t N = 8>
+void shade(Span<const HitRecord> hits, const PointLight &light, Span<Color> colors) {
+
+    if (hits.size() != colors.size()) {
+        throw std::runtime_error("Cannot shade hits. Input and output sizes are different.");
+    }
+
+    for (size_t offset = 0; offset < hits.size(); offset += N) {
+        auto result = lighting(HitBatch<N>::gather(hits, offset), light);
+        for (size_t i = 0; i < N && offset + i < hits.size(); i++) colors[offset + i] = result.lane(i);
+    }
+}
+
+#endif //RAYTRACERCHALLENGE_LIGHTING_HPP
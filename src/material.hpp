@@ -0,0 +1,38 @@
+#ifndef RAYTRACERCHALLENGE_MATERIAL_HPP
+#define RAYTRACERCHALLENGE_MATERIAL_HPP
+
+#include "color.hpp"
+
+/***
+ * The surface attributes of the Phong reflection model. `ambient`, `diffuse` and `specular` are
+ * the fractions of light reflected by each term, `shininess` the size of the specular highlight
+ * (the larger, the smaller and tighter).
+ */
+struct Material {
+
+    Color color {Colors::WHITE};
+    float ambient {0.1f};
+    float diffuse {0.9f};
+    float specular {0.9f};
+    float shininess {200.f};
+
+    friend bool operator==(const Material &a, const Material &b) {
+        return a.color == b.color && a.ambient == b.ambient && a.diffuse == b.diffuse &&
+               a.specular == b.specular && a.shininess == b.shininess;
+    }
+
+    friend bool operator!=(const Material &a, const Material &b) { return !(a == b); }
+};
+
+// A light with no size, shining `intensity` in every direction from `position`.
+struct PointLight {
+
+    Point position {point(0, 0, 0)};
+    Color intensity {Colors::WHITE};
+
+    constexpr PointLight() = default;
+
+    constexpr PointLight(const Point &position, const Color &intensity) : position{position}, intensity{intensity} {}
+};
+
+#endif //RAYTRACERCHALLENGE_MATERIAL_HPP
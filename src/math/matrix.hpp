@@ -3,7 +3,13 @@
 
 #include "utility.hpp"
 #include "tuple.hpp"
+#include "tuple_packet.hpp"
+#include "simd.hpp"
+#include "../utility/span.hpp"
 
+#include <array>
+#include <optional>
+#include <stdexcept>
 #include <initializer_list>
 #include <ostream>
 
@@ -13,10 +19,12 @@ class Matrix {
     static_assert(MATRIX_SIZE != 0, "Matrix size 0x0 are not allowed!");
 
 private:
-    std::array<float, MATRIX_SIZE * MATRIX_SIZE> data{0};
+    // Row-major. Aligned so that the SSE kernels can load a row with a single instruction.
+    alignas(16) std::array<float, MATRIX_SIZE * MATRIX_SIZE> data{0};
 public:
 
     static constexpr size_t SIZE = MATRIX_SIZE;
+    static constexpr size_t matrixSize() { return SIZE; }
     constexpr explicit Matrix() = default;
 
     constexpr Matrix(std::initializer_list<std::initializer_list<float>> values) {
@@ -36,7 +44,7 @@ public:
         }
     }
 
-    static Matrix<MATRIX_SIZE> identity() {
+    static constexpr Matrix<MATRIX_SIZE> identity() {
         Matrix<MATRIX_SIZE> id;
         for (size_t i = 0; i < SIZE; i++) {
             id.set(i, i, 1.f);
@@ -44,11 +52,11 @@ public:
         return id;
     }
 
-    [[nodiscard]] bool isInvertible() const {
+    [[nodiscard]] constexpr bool isInvertible() const {
         return !compareFloat(determinant(), 0);
     }
 
-    [[nodiscard]] float determinant() const {
+    [[nodiscard]] constexpr float determinant() const {
 
         float det = 0;
 
@@ -59,14 +67,14 @@ public:
         return det;
     }
 
-    [[nodiscard]] std::optional<float> minor(size_t row, size_t col) const {
+    [[nodiscard]] constexpr std::optional<float> minor(size_t row, size_t col) const {
         if (auto B = subMatrix(row, col)) {
             return B->determinant();
         }
         return {};
     }
 
-    [[nodiscard]] std::optional<float> cofactor(size_t row, size_t col) const {
+    [[nodiscard]] constexpr std::optional<float> cofactor(size_t row, size_t col) const {
 
         if (auto minorOpt = minor(row, col)) {
 
@@ -81,7 +89,7 @@ public:
         return {};
     }
 
-    [[nodiscard]] std::optional<Matrix<MATRIX_SIZE - 1>> subMatrix(size_t row, size_t col) const {
+    [[nodiscard]] constexpr std::optional<Matrix<MATRIX_SIZE - 1>> subMatrix(size_t row, size_t col) const {
 
         if (row >= SIZE || col >= SIZE) {
             return {};
@@ -105,7 +113,7 @@ public:
         return sub;
     }
 
-    [[nodiscard]] Matrix<MATRIX_SIZE> transpose() const {
+    [[nodiscard]] constexpr Matrix<MATRIX_SIZE> transpose() const {
         Matrix<MATRIX_SIZE> transposed;
 
         for (size_t i = 0; i < SIZE; i++) {
@@ -117,7 +125,24 @@ public:
         return transposed;
     }
 
-    [[nodiscard]] std::optional<Matrix<MATRIX_SIZE>> inverse() const {
+    // `Matrix4` specializes this with closed-form kernels, see `matrix_kernels`.
+    [[nodiscard]] constexpr std::optional<Matrix<MATRIX_SIZE>> inverse() const {
+        return cofactorInverse();
+    }
+
+    /***
+     * True when the last row is exactly (0, ..., 0, 1), as for every combination of
+     * translations, rotations, scalings and shearings.
+     */
+    [[nodiscard]] constexpr bool isAffine() const {
+        for (size_t col = 0; col + 1 < SIZE; col++) {
+            if (at(SIZE - 1, col) != 0) return false;
+        }
+        return at(SIZE - 1, SIZE - 1) == 1;
+    }
+
+    // The inverse computed as the transposed matrix of cofactors divided by the determinant.
+    [[nodiscard]] constexpr std::optional<Matrix<MATRIX_SIZE>> cofactorInverse() const {
 
         auto det = determinant();
         if (det == 0) return {};
@@ -134,24 +159,29 @@ public:
         return inv;
     }
 
-    [[nodiscard]] float at(size_t x, size_t y) const { return data[x * MATRIX_SIZE + y]; }
+    [[nodiscard]] constexpr float at(size_t x, size_t y) const { return data[x * MATRIX_SIZE + y]; }
 
-    void set(size_t x, size_t y, float value) {
+    constexpr void set(size_t x, size_t y, float value) {
         data[x * MATRIX_SIZE + y] = value;
     }
 
-    bool operator==(const Matrix<MATRIX_SIZE> &rhs) const {
-        for (size_t i = 0; i < SIZE; i++) {
+    // The SIZE * SIZE entries, row after row.
+    [[nodiscard]] constexpr const float *values() const { return data.data(); }
+
+    [[nodiscard]] constexpr float *values() { return data.data(); }
+
+    constexpr bool operator==(const Matrix<MATRIX_SIZE> &rhs) const {
+        for (size_t i = 0; i < SIZE * SIZE; i++) {
             if (!compareFloat(data[i], rhs.data[i])) return false;
         }
         return true;
     }
 
-    bool operator!=(const Matrix &rhs) const {
-        return rhs != *this;
+    constexpr bool operator!=(const Matrix &rhs) const {
+        return !(rhs == *this);
     }
 
-    Matrix<MATRIX_SIZE> operator-() const {
+    constexpr Matrix<MATRIX_SIZE> operator-() const {
 
         Matrix<MATRIX_SIZE> result;
 
@@ -164,7 +194,7 @@ public:
         return result;
     }
 
-    Matrix<MATRIX_SIZE> operator+(const Matrix<MATRIX_SIZE> &rhs) const {
+    constexpr Matrix<MATRIX_SIZE> operator+(const Matrix<MATRIX_SIZE> &rhs) const {
 
         Matrix<MATRIX_SIZE> result;
 
@@ -177,7 +207,7 @@ public:
         return result;
     }
 
-    Matrix<MATRIX_SIZE> operator-(const Matrix<MATRIX_SIZE> &rhs) const {
+    constexpr Matrix<MATRIX_SIZE> operator-(const Matrix<MATRIX_SIZE> &rhs) const {
 
         Matrix<MATRIX_SIZE> result;
 
@@ -190,15 +220,17 @@ public:
         return result;
     }
 
-    Matrix<MATRIX_SIZE> operator*(const Matrix &rhs) const {
+    // `Matrix4` specializes this with the kernels of `matrix_kernels`.
+    constexpr Matrix<MATRIX_SIZE> operator*(const Matrix &rhs) const {
         Matrix<MATRIX_SIZE> result;
 
         for (size_t i = 0; i < SIZE; i++) {
             for (size_t j = 0; j < SIZE; j++) {
+                float sum = 0;
                 for (size_t k = 0; k < SIZE; k++) {
-                    float curr = result.at(i, j);
-                    result.set(i, j, curr + at(i, k) * rhs.at(k, j));
+                    sum += at(i, k) * rhs.at(k, j);
                 }
+                result.set(i, j, sum);
             }
         }
 
@@ -225,8 +257,400 @@ using Matrix4 = Matrix<4>;
 using Matrix3 = Matrix<3>;
 using Matrix2 = Matrix<2>;
 
+/***
+ * Implementations of the `Matrix4` operations. `Scalar` is always available, `SSE` only when
+ * `RAYTRACER_SSE` is enabled; `Active` is the one `Matrix4` forwards to. `AVX` only provides the
+ * batched transform, and is picked at run time by `transform(const Matrix4 &, Span, Span)`.
+ */
+namespace matrix_kernels {
+
+    // The inverse is the closed-form cofactor expansion: 12 2x2 sub-determinants shared by the determinant and the 16 cofactors.
+    struct Scalar {
+        static constexpr float determinant(const Matrix4 &m);
+        static constexpr std::optional<Matrix4> inverse(const Matrix4 &m);
+        // Only valid when `m.isAffine()`: inverts the upper 3x3 block and the translation separately.
+        static constexpr std::optional<Matrix4> inverseAffine(const Matrix4 &m);
+
+        static constexpr Matrix4 multiply(const Matrix4 &a, const Matrix4 &b);
+        static constexpr Tuple4 transform(const Matrix4 &m, const Tuple4 &t);
+        // out[i] = m * in[i]; `in` and `out` may be the same array.
+        static void transform(const Matrix4 &m, const Tuple4 *in, Tuple4 *out, size_t count);
+    };
+
+#if RAYTRACER_SSE
+    // One `__m128` per row; the inverse works block-wise on 2x2 sub-matrices.
+    struct SSE : Scalar {
+        static std::optional<Matrix4> inverse(const Matrix4 &m);
+
+        static Matrix4 multiply(const Matrix4 &a, const Matrix4 &b);
+        // A single tuple needs the transposed matrix, which costs more than the scalar code the
+        // compiler already vectorizes, so only arrays of tuples have an SSE version.
+        using Scalar::transform;
+        static void transform(const Matrix4 &m, const Tuple4 *in, Tuple4 *out, size_t count);
+    };
+
+    using Active = SSE;
+#else
+    using Active = Scalar;
+#endif
+
+#if RAYTRACER_AVX_DISPATCH
+    // Two tuples per `__m256`. Only call when `supported()`.
+    struct AVX {
+        static bool supported();
+        static void transform(const Matrix4 &m, const Tuple4 *in, Tuple4 *out, size_t count);
+    };
+#endif
+
+    constexpr float Scalar::determinant(const Matrix4 &m) {
+        const float *a = m.values();
+
+        // 2x2 determinants of the first two rows (s) and of the last two rows (c)
+        float s0 = a[0] * a[5] - a[4] * a[1];
+        float s1 = a[0] * a[6] - a[4] * a[2];
+        float s2 = a[0] * a[7] - a[4] * a[3];
+        float s3 = a[1] * a[6] - a[5] * a[2];
+        float s4 = a[1] * a[7] - a[5] * a[3];
+        float s5 = a[2] * a[7] - a[6] * a[3];
+
+        float c5 = a[10] * a[15] - a[14] * a[11];
+        float c4 = a[9] * a[15] - a[13] * a[11];
+        float c3 = a[9] * a[14] - a[13] * a[10];
+        float c2 = a[8] * a[15] - a[12] * a[11];
+        float c1 = a[8] * a[14] - a[12] * a[10];
+        float c0 = a[8] * a[13] - a[12] * a[9];
+
+        return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+    }
+
+    constexpr std::optional<Matrix4> Scalar::inverse(const Matrix4 &m) {
+        const float *a = m.values();
+
+        float s0 = a[0] * a[5] - a[4] * a[1];
+        float s1 = a[0] * a[6] - a[4] * a[2];
+        float s2 = a[0] * a[7] - a[4] * a[3];
+        float s3 = a[1] * a[6] - a[5] * a[2];
+        float s4 = a[1] * a[7] - a[5] * a[3];
+        float s5 = a[2] * a[7] - a[6] * a[3];
+
+        float c5 = a[10] * a[15] - a[14] * a[11];
+        float c4 = a[9] * a[15] - a[13] * a[11];
+        float c3 = a[9] * a[14] - a[13] * a[10];
+        float c2 = a[8] * a[15] - a[12] * a[11];
+        float c1 = a[8] * a[14] - a[12] * a[10];
+        float c0 = a[8] * a[13] - a[12] * a[9];
+
+        float det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+        if (det == 0) return {};
+
+        float r = 1.f / det;
+        Matrix4 inv;
+        float *b = inv.values();
+
+        b[0] = (a[5] * c5 - a[6] * c4 + a[7] * c3) * r;
+        b[1] = (-a[1] * c5 + a[2] * c4 - a[3] * c3) * r;
+        b[2] = (a[13] * s5 - a[14] * s4 + a[15] * s3) * r;
+        b[3] = (-a[9] * s5 + a[10] * s4 - a[11] * s3) * r;
+
+        b[4] = (-a[4] * c5 + a[6] * c2 - a[7] * c1) * r;
+        b[5] = (a[0] * c5 - a[2] * c2 + a[3] * c1) * r;
+        b[6] = (-a[12] * s5 + a[14] * s2 - a[15] * s1) * r;
+        b[7] = (a[8] * s5 - a[10] * s2 + a[11] * s1) * r;
+
+        b[8] = (a[4] * c4 - a[5] * c2 + a[7] * c0) * r;
+        b[9] = (-a[0] * c4 + a[1] * c2 - a[3] * c0) * r;
+        b[10] = (a[12] * s4 - a[13] * s2 + a[15] * s0) * r;
+        b[11] = (-a[8] * s4 + a[9] * s2 - a[11] * s0) * r;
+
+        b[12] = (-a[4] * c3 + a[5] * c1 - a[6] * c0) * r;
+        b[13] = (a[0] * c3 - a[1] * c1 + a[2] * c0) * r;
+        b[14] = (-a[12] * s3 + a[13] * s1 - a[14] * s0) * r;
+        b[15] = (a[8] * s3 - a[9] * s1 + a[10] * s0) * r;
+
+        return inv;
+    }
+
+    constexpr std::optional<Matrix4> Scalar::inverseAffine(const Matrix4 &m) {
+        const float *a = m.values();
+
+        // With rows u, v, w the inverse of the 3x3 block has columns v x w, w x u, u x v over det = u . (v x w)
+        float vw0 = a[5] * a[10] - a[6] * a[9];
+        float vw1 = a[6] * a[8] - a[4] * a[10];
+        float vw2 = a[4] * a[9] - a[5] * a[8];
+
+        float det = a[0] * vw0 + a[1] * vw1 + a[2] * vw2;
+        if (det == 0) return {};
+
+        float r = 1.f / det;
+        Matrix4 inv;
+        float *b = inv.values();
+
+        b[0] = vw0 * r;
+        b[1] = (a[9] * a[2] - a[10] * a[1]) * r;
+        b[2] = (a[1] * a[6] - a[2] * a[5]) * r;
+
+        b[4] = vw1 * r;
+        b[5] = (a[10] * a[0] - a[8] * a[2]) * r;
+        b[6] = (a[2] * a[4] - a[0] * a[6]) * r;
+
+        b[8] = vw2 * r;
+        b[9] = (a[8] * a[1] - a[9] * a[0]) * r;
+        b[10] = (a[0] * a[5] - a[1] * a[4]) * r;
+
+        // The translation is moved back by the inverse of the 3x3 block.
+        float tx = a[3], ty = a[7], tz = a[11];
+        b[3] = -(b[0] * tx + b[1] * ty + b[2] * tz);
+        b[7] = -(b[4] * tx + b[5] * ty + b[6] * tz);
+        b[11] = -(b[8] * tx + b[9] * ty + b[10] * tz);
+        b[15] = 1.f;
+
+        return inv;
+    }
+
+    constexpr Matrix4 Scalar::multiply(const Matrix4 &a, const Matrix4 &b) {
+        const float *x = a.values();
+        const float *y = b.values();
+        Matrix4 result;
+        float *r = result.values();
+
+        for (size_t i = 0; i < 4; i++) {
+            const float *row = x + i * 4;
+            for (size_t j = 0; j < 4; j++) {
+                r[i * 4 + j] = row[0] * y[j] + row[1] * y[4 + j] + row[2] * y[8 + j] + row[3] * y[12 + j];
+            }
+        }
+
+        return result;
+    }
+
+    constexpr Tuple4 Scalar::transform(const Matrix4 &m, const Tuple4 &t) {
+        const float *a = m.values();
+        return {a[0] * t.x + a[1] * t.y + a[2] * t.z + a[3] * t.w,
+                a[4] * t.x + a[5] * t.y + a[6] * t.z + a[7] * t.w,
+                a[8] * t.x + a[9] * t.y + a[10] * t.z + a[11] * t.w,
+                a[12] * t.x + a[13] * t.y + a[14] * t.z + a[15] * t.w};
+    }
+
+    inline void Scalar::transform(const Matrix4 &m, const Tuple4 *in, Tuple4 *out, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            out[i] = transform(m, in[i]);
+        }
+    }
+
+#if RAYTRACER_SSE
+
+    namespace detail {
+
+        template<int X, int Y, int Z, int W>
+        inline __m128 shuffle(__m128 a, __m128 b) {
+            return _mm_shuffle_ps(a, b, X | (Y << 2) | (Z << 4) | (W << 6));
+        }
+
+        template<int X, int Y, int Z, int W>
+        inline __m128 swizzle(__m128 a) {
+            return shuffle<X, Y, Z, W>(a, a);
+        }
+
+        // Products of row-major 2x2 matrices stored as (m00, m01, m10, m11); `#` is the adjugate.
+        inline __m128 mul2(__m128 a, __m128 b) {
+            return _mm_add_ps(_mm_mul_ps(a, swizzle<0, 3, 0, 3>(b)),
+                              _mm_mul_ps(swizzle<1, 0, 3, 2>(a), swizzle<2, 1, 2, 1>(b)));
+        }
+
+        // a# * b
+        inline __m128 adjMul2(__m128 a, __m128 b) {
+            return _mm_sub_ps(_mm_mul_ps(swizzle<3, 3, 0, 0>(a), b),
+                              _mm_mul_ps(swizzle<1, 1, 2, 2>(a), swizzle<2, 3, 0, 1>(b)));
+        }
+
+        // a * b#
+        inline __m128 mulAdj2(__m128 a, __m128 b) {
+            return _mm_sub_ps(_mm_mul_ps(a, swizzle<3, 0, 3, 0>(b)),
+                              _mm_mul_ps(swizzle<1, 0, 3, 2>(a), swizzle<2, 1, 2, 1>(b)));
+        }
+    }
+
+    inline std::optional<Matrix4> SSE::inverse(const Matrix4 &m) {
+        using namespace detail;
+
+        const float *a = m.values();
+        __m128 row0 = _mm_load_ps(a);
+        __m128 row1 = _mm_load_ps(a + 4);
+        __m128 row2 = _mm_load_ps(a + 8);
+        __m128 row3 = _mm_load_ps(a + 12);
+
+        // M = | A B |
+        //     | C D |
+        __m128 A = _mm_movelh_ps(row0, row1);
+        __m128 B = _mm_movehl_ps(row1, row0);
+        __m128 C = _mm_movelh_ps(row2, row3);
+        __m128 D = _mm_movehl_ps(row3, row2);
+
+        // (|A|, |B|, |C|, |D|)
+        __m128 detSub = _mm_sub_ps(
+                _mm_mul_ps(shuffle<0, 2, 0, 2>(row0, row2), shuffle<1, 3, 1, 3>(row1, row3)),
+                _mm_mul_ps(shuffle<1, 3, 1, 3>(row0, row2), shuffle<0, 2, 0, 2>(row1, row3)));
+        __m128 detA = swizzle<0, 0, 0, 0>(detSub);
+        __m128 detB = swizzle<1, 1, 1, 1>(detSub);
+        __m128 detC = swizzle<2, 2, 2, 2>(detSub);
+        __m128 detD = swizzle<3, 3, 3, 3>(detSub);
+
+        __m128 DC = adjMul2(D, C);
+        __m128 AB = adjMul2(A, B);
+
+        // Adjugates of the blocks of |M| * M^-1 = | X Y |
+        //                                         | Z W |
+        __m128 X = _mm_sub_ps(_mm_mul_ps(detD, A), mul2(B, DC));
+        __m128 W = _mm_sub_ps(_mm_mul_ps(detA, D), mul2(C, AB));
+        __m128 Y = _mm_sub_ps(_mm_mul_ps(detB, C), mulAdj2(D, AB));
+        __m128 Z = _mm_sub_ps(_mm_mul_ps(detC, B), mulAdj2(A, DC));
+
+        // |M| = |A| |D| + |B| |C| - tr((A# B) (D# C))
+        __m128 trace = _mm_mul_ps(AB, swizzle<0, 2, 1, 3>(DC));
+        trace = _mm_add_ps(trace, swizzle<1, 0, 3, 2>(trace));
+        trace = _mm_add_ps(trace, swizzle<2, 3, 0, 1>(trace));
+        __m128 det = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), trace);
+
+        if (_mm_cvtss_f32(det) == 0) return {};
+
+        // The sign pattern turns the adjugates of the blocks back into the blocks.
+        __m128 r = _mm_div_ps(_mm_setr_ps(1.f, -1.f, -1.f, 1.f), det);
+        X = _mm_mul_ps(X, r);
+        Y = _mm_mul_ps(Y, r);
+        Z = _mm_mul_ps(Z, r);
+        W = _mm_mul_ps(W, r);
+
+        Matrix4 inv;
+        float *b = inv.values();
+        _mm_store_ps(b, shuffle<3, 1, 3, 1>(X, Y));
+        _mm_store_ps(b + 4, shuffle<2, 0, 2, 0>(X, Y));
+        _mm_store_ps(b + 8, shuffle<3, 1, 3, 1>(Z, W));
+        _mm_store_ps(b + 12, shuffle<2, 0, 2, 0>(Z, W));
+
+        return inv;
+    }
+
+    inline Matrix4 SSE::multiply(const Matrix4 &a, const Matrix4 &b) {
+        const float *x = a.values();
+        const float *y = b.values();
+        __m128 b0 = _mm_load_ps(y);
+        __m128 b1 = _mm_load_ps(y + 4);
+        __m128 b2 = _mm_load_ps(y + 8);
+        __m128 b3 = _mm_load_ps(y + 12);
+
+        Matrix4 result;
+        float *r = result.values();
+
+        // Each row of the result is a combination of the rows of `b`, weighted by the row of `a`.
+        for (size_t i = 0; i < 4; i++) {
+            __m128 row = _mm_load_ps(x + i * 4);
+            __m128 sum = _mm_mul_ps(detail::swizzle<0, 0, 0, 0>(row), b0);
+            sum = _mm_add_ps(sum, _mm_mul_ps(detail::swizzle<1, 1, 1, 1>(row), b1));
+            sum = _mm_add_ps(sum, _mm_mul_ps(detail::swizzle<2, 2, 2, 2>(row), b2));
+            sum = _mm_add_ps(sum, _mm_mul_ps(detail::swizzle<3, 3, 3, 3>(row), b3));
+            _mm_store_ps(r + i * 4, sum);
+        }
+
+        return result;
+    }
+
+    inline void SSE::transform(const Matrix4 &m, const Tuple4 *in, Tuple4 *out, size_t count) {
+        // Transpose once, then every tuple is a combination of the columns.
+        const float *a = m.values();
+        __m128 c0 = _mm_load_ps(a);
+        __m128 c1 = _mm_load_ps(a + 4);
+        __m128 c2 = _mm_load_ps(a + 8);
+        __m128 c3 = _mm_load_ps(a + 12);
+        _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+        for (size_t i = 0; i < count; i++) {
+            __m128 v = tuple_kernels::SSE::load(in[i]);
+            __m128 sum = _mm_mul_ps(detail::swizzle<0, 0, 0, 0>(v), c0);
+            sum = _mm_add_ps(sum, _mm_mul_ps(detail::swizzle<1, 1, 1, 1>(v), c1));
+            sum = _mm_add_ps(sum, _mm_mul_ps(detail::swizzle<2, 2, 2, 2>(v), c2));
+            sum = _mm_add_ps(sum, _mm_mul_ps(detail::swizzle<3, 3, 3, 3>(v), c3));
+            _mm_store_ps(&out[i].x, sum);
+        }
+    }
+
+#endif
+
+#if RAYTRACER_AVX_DISPATCH
+
+    inline bool AVX::supported() {
+        return __builtin_cpu_supports("avx");
+    }
+
+    __attribute__((target("avx")))
+    inline void AVX::transform(const Matrix4 &m, const Tuple4 *in, Tuple4 *out, size_t count) {
+        const float *a = m.values();
+        __m128 c0 = _mm_load_ps(a);
+        __m128 c1 = _mm_load_ps(a + 4);
+        __m128 c2 = _mm_load_ps(a + 8);
+        __m128 c3 = _mm_load_ps(a + 12);
+        _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+        // The same column in both 128-bit halves, one tuple per half.
+        __m256 w0 = _mm256_insertf128_ps(_mm256_castps128_ps256(c0), c0, 1);
+        __m256 w1 = _mm256_insertf128_ps(_mm256_castps128_ps256(c1), c1, 1);
+        __m256 w2 = _mm256_insertf128_ps(_mm256_castps128_ps256(c2), c2, 1);
+        __m256 w3 = _mm256_insertf128_ps(_mm256_castps128_ps256(c3), c3, 1);
+
+        size_t i = 0;
+        for (; i + 2 <= count; i += 2) {
+            __m256 v = _mm256_loadu_ps(&in[i].x);
+            __m256 sum = _mm256_mul_ps(_mm256_permute_ps(v, 0x00), w0);
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_permute_ps(v, 0x55), w1));
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_permute_ps(v, 0xaa), w2));
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_permute_ps(v, 0xff), w3));
+            _mm256_storeu_ps(&out[i].x, sum);
+        }
+
+        if (i < count) {
+            __m128 v = _mm_load_ps(&in[i].x);
+            __m128 sum = _mm_mul_ps(_mm_permute_ps(v, 0x00), c0);
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_permute_ps(v, 0x55), c1));
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_permute_ps(v, 0xaa), c2));
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_permute_ps(v, 0xff), c3));
+            _mm_store_ps(&out[i].x, sum);
+        }
+    }
+
+#endif
+
+    using BatchTransform = void (*)(const Matrix4 &, const Tuple4 *, Tuple4 *, size_t);
+
+    // The fastest batched transform the CPU running the program supports.
+    inline BatchTransform selectBatchTransform() {
+#if RAYTRACER_AVX_DISPATCH
+        if (AVX::supported()) return &AVX::transform;
+#endif
+        return &Active::transform;
+    }
+}
+
+// The SIMD kernels cannot run in constant expressions, the scalar ones take over there.
+
 template<>
-float Matrix2::determinant() const {
+constexpr float Matrix4::determinant() const {
+    return matrix_kernels::Scalar::determinant(*this);
+}
+
+template<>
+constexpr std::optional<Matrix4> Matrix4::inverse() const {
+    if (isAffine()) return matrix_kernels::Scalar::inverseAffine(*this);
+    if (isConstantEvaluated()) return matrix_kernels::Scalar::inverse(*this);
+    return matrix_kernels::Active::inverse(*this);
+}
+
+template<>
+constexpr Matrix4 Matrix4::operator*(const Matrix4 &rhs) const {
+    if (isConstantEvaluated()) return matrix_kernels::Scalar::multiply(*this, rhs);
+    return matrix_kernels::Active::multiply(*this, rhs);
+}
+
+template<>
+constexpr float Matrix2::determinant() const {
 
     float a = at(0, 0);
     float b = at(0, 1);
@@ -243,15 +667,40 @@ float Matrix2::determinant() const {
  * @param rhs The vector to multiply with.
  * @return A new column vector, as the multiplication result.
  */
-Tuple4 operator*(const Matrix4& m, const Tuple4& rhs) {
+constexpr Tuple4 operator*(const Matrix4& m, const Tuple4& rhs) {
+    return matrix_kernels::Scalar::transform(m, rhs);
+}
 
-    float x = 0, y = 0, z = 0, w = 0;
-    x = m.at(0, 0) * rhs.x + m.at(0, 1) * rhs.y + m.at(0, 2) * rhs.z + m.at(0, 3) * rhs.w;
-    y = m.at(1, 0) * rhs.x + m.at(1, 1) * rhs.y + m.at(1, 2) * rhs.z + m.at(1, 3) * rhs.w;
-    z = m.at(2, 0) * rhs.x + m.at(2, 1) * rhs.y + m.at(2, 2) * rhs.z + m.at(2, 3) * rhs.w;
-    w = m.at(3, 0) * rhs.x + m.at(3, 1) * rhs.y + m.at(3, 2) * rhs.z + m.at(3, 3) * rhs.w;
+/***
+ * Multiply a matrix for every lane of a packet, one broadcast entry at a time.
+ * @param m The matrix to multiply.
+ * @param t The tuples to transform.
+ * @return The packet of `m * t.lane(i)`.
+ */
+template<size_t N>
+Tuple4xN<N> operator*(const Matrix4 &m, const Tuple4xN<N> &t) {
+    const float *a = m.values();
+    auto row = [&t](const float *r) {
+        return t.x * FloatxN<N>::broadcast(r[0]) + t.y * FloatxN<N>::broadcast(r[1]) +
+               t.z * FloatxN<N>::broadcast(r[2]) + t.w * FloatxN<N>::broadcast(r[3]);
+    };
+    return {row(a), row(a + 4), row(a + 8), row(a + 12)};
+}
+
+/***
+ * Multiply a matrix for every tuple of an array, with the widest kernel the CPU supports.
+ * @param m The matrix to multiply.
+ * @param in The tuples to transform.
+ * @param out Where to write `m * in[i]`, as many tuples as `in`. May be `in` itself.
+ */
+inline void transform(const Matrix4 &m, Span<const Tuple4> in, Span<Tuple4> out) {
+
+    if (in.size() != out.size()) {
+        throw std::runtime_error("Cannot transform tuples. Input and output sizes are different.");
+    }
 
-    return {x, y, z, w};
+    static const matrix_kernels::BatchTransform kernel = matrix_kernels::selectBatchTransform();
+    kernel(m, in.data(), out.data(), in.size());
 }
 
 #endif //RAYTRACERCHALLENGE_MATRIX_HPP
@@ -0,0 +1,26 @@
+#ifndef RAYTRACERCHALLENGE_SIMD_HPP
+#define RAYTRACERCHALLENGE_SIMD_HPP
+
+/***
+ * `RAYTRACER_SIMD` (set by the CMake option of the same name) asks for the SSE backends of the
+ * math types. They are only used when the target actually has SSE2, otherwise every type
+ * falls back to its scalar implementation.
+ */
+#if defined(RAYTRACER_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define RAYTRACER_SSE 1
+#include <immintrin.h>
+#else
+#define RAYTRACER_SSE 0
+#endif
+
+/***
+ * On top of SSE, GCC and Clang can compile single functions for AVX (`target` attribute) and
+ * check the CPU at run time, so batched kernels can use AVX without requiring it to run.
+ */
+#if RAYTRACER_SSE && (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define RAYTRACER_AVX_DISPATCH 1
+#else
+#define RAYTRACER_AVX_DISPATCH 0
+#endif
+
+#endif //RAYTRACERCHALLENGE_SIMD_HPP
@@ -0,0 +1,177 @@
+#ifndef RAYTRACERCHALLENGE_TRANSFORM_HPP
+#define RAYTRACERCHALLENGE_TRANSFORM_HPP
+
+#include <cstdint>
+#include <optional>
+
+#include "matrix.hpp"
+#include "transformation.hpp"
+
+namespace transformation {
+
+    /***
+     * A chain of transformations composed once, with a fluent API. Each call applies its
+     * transformation after the previous ones, so `Transform().rotateX(r).scale(s, s, s).translate(x, y, z)`
+     * is `translation(x, y, z) * scale(s, s, s) * rotationX(r)`.
+     *
+     * The inverse and the inverse-transpose (the normal matrix) are computed on first use and
+     * cached until the chain changes. `kind()` tracks the simplest family of matrices the chain
+     * belongs to, so that cheaper inverses are used when possible. The caches are not synchronized:
+     * fill them (e.g. with `inverseTranspose()`) before sharing a `Transform` between threads.
+     */
+    class Transform {
+
+    public:
+
+        // Ordered from the cheapest to invert to the most expensive.
+        enum class Kind : uint8_t {
+            IDENTITY,
+            TRANSLATION,
+            // Axis-aligned scaling (reflections included) and translation: a diagonal 3x3 block.
+            SCALE,
+            // Rotations and translations: an orthonormal 3x3 block, inverted by transposing it.
+            RIGID,
+            AFFINE,
+            GENERAL
+        };
+
+    private:
+
+        static constexpr uint8_t INVERSE_CACHED = 1;
+        static constexpr uint8_t INVERSE_TRANSPOSE_CACHED = 2;
+
+        Matrix4 m {Matrix4::identity()};
+        Kind k {Kind::IDENTITY};
+
+        mutable uint8_t cached {0};
+        mutable std::optional<Matrix4> inverseCache;
+        mutable std::optional<Matrix4> inverseTransposeCache;
+
+        static constexpr Kind combine(Kind a, Kind b) {
+            if ((a == Kind::SCALE && b == Kind::RIGID) || (a == Kind::RIGID && b == Kind::SCALE)) {
+                return Kind::AFFINE;
+            }
+            return a < b ? b : a;
+        }
+
+        constexpr Transform &append(const Matrix4 &next, Kind nextKind) {
+            m = next * m;
+            k = combine(k, nextKind);
+            cached = 0;
+            return *this;
+        }
+
+        [[nodiscard]] std::optional<Matrix4> computeInverse() const {
+
+            switch (k) {
+                case Kind::IDENTITY:
+                    return m;
+                case Kind::TRANSLATION:
+                    return translation(-m.at(0, 3), -m.at(1, 3), -m.at(2, 3));
+                case Kind::SCALE: {
+                    const float *a = m.values();
+                    if (a[0] == 0 || a[5] == 0 || a[10] == 0) return {};
+                    Matrix4 inv = Matrix4::identity();
+                    float *b = inv.values();
+                    b[0] = 1 / a[0];
+                    b[5] = 1 / a[5];
+                    b[10] = 1 / a[10];
+                    b[3] = -a[3] * b[0];
+                    b[7] = -a[7] * b[5];
+                    b[11] = -a[11] * b[10];
+                    return inv;
+                }
+                case Kind::RIGID: {
+                    // Transposed rotation, and the translation rotated back.
+                    const float *a = m.values();
+                    Matrix4 inv = Matrix4::identity();
+                    float *b = inv.values();
+                    b[0] = a[0], b[1] = a[4], b[2] = a[8];
+                    b[4] = a[1], b[5] = a[5], b[6] = a[9];
+                    b[8] = a[2], b[9] = a[6], b[10] = a[10];
+                    b[3] = -(b[0] * a[3] + b[1] * a[7] + b[2] * a[11]);
+                    b[7] = -(b[4] * a[3] + b[5] * a[7] + b[6] * a[11]);
+                    b[11] = -(b[8] * a[3] + b[9] * a[7] + b[10] * a[11]);
+                    return inv;
+                }
+                case Kind::AFFINE:
+                    return matrix_kernels::Active::inverseAffine(m);
+                case Kind::GENERAL:
+                    break;
+            }
+
+            return m.inverse();
+        }
+
+    public:
+
+        constexpr Transform() = default;
+
+        // Any matrix; only its affinity is known.
+        constexpr explicit Transform(const Matrix4 &matrix) : m{matrix}, k{matrix.isAffine() ? Kind::AFFINE : Kind::GENERAL} {}
+
+        constexpr Transform &translate(float x, float y, float z) {
+            return append(translation(x, y, z), Kind::TRANSLATION);
+        }
+
+        constexpr Transform &scale(float x, float y, float z) {
+            return append(transformation::scale(x, y, z), Kind::SCALE);
+        }
+
+        constexpr Transform &rotateX(float r) {
+            return append(rotationX(r), Kind::RIGID);
+        }
+
+        constexpr Transform &rotateY(float r) {
+            return append(rotationY(r), Kind::RIGID);
+        }
+
+        constexpr Transform &rotateZ(float r) {
+            return append(rotationZ(r), Kind::RIGID);
+        }
+
+        constexpr Transform &shear(float xy, float xz, float yx, float yz, float zx, float zy) {
+            return append(shearing(xy, xz, yx, yz, zx, zy), Kind::AFFINE);
+        }
+
+        // Apply `next` after this chain.
+        constexpr Transform &then(const Transform &next) {
+            return append(next.m, next.k);
+        }
+
+        [[nodiscard]] constexpr const Matrix4 &matrix() const { return m; }
+
+        [[nodiscard]] constexpr Kind kind() const { return k; }
+
+        // Empty when the chain is not invertible (e.g. a scaling by 0).
+        [[nodiscard]] const std::optional<Matrix4> &inverse() const {
+            if (!(cached & INVERSE_CACHED)) {
+                inverseCache = computeInverse();
+                cached |= INVERSE_CACHED;
+            }
+            return inverseCache;
+        }
+
+        // The matrix that transforms normals. Empty when the chain is not invertible.
+        [[nodiscard]] const std::optional<Matrix4> &inverseTranspose() const {
+            if (!(cached & INVERSE_TRANSPOSE_CACHED)) {
+                if (const auto &inv = inverse()) {
+                    inverseTransposeCache = inv->transpose();
+                } else {
+                    inverseTransposeCache.reset();
+                }
+                cached |= INVERSE_TRANSPOSE_CACHED;
+            }
+            return inverseTransposeCache;
+        }
+
+        // `a` then `b`, the same order as a matrix product.
+        friend constexpr Transform operator*(const Transform &b, const Transform &a) {
+            Transform result = a;
+            result.then(b);
+            return result;
+        }
+    };
+}
+
+#endif //RAYTRACERCHALLENGE_TRANSFORM_HPP
@@ -1,11 +1,13 @@
 #ifndef RAYTRACERCHALLENGE_TRANSFORMATION_HPP
 #define RAYTRACERCHALLENGE_TRANSFORMATION_HPP
 
+#include <stdexcept>
+
 #include "matrix.hpp"
 
 namespace transformation {
 
-    [[nodiscard]] Matrix4 translation(float x, float y, float z) {
+    [[nodiscard]] constexpr Matrix4 translation(float x, float y, float z) {
 
         /**
          * Translation matrix
@@ -33,28 +35,28 @@ namespace transformation {
 
     [[nodiscard]] constexpr Matrix4 rotationX(float r) {
         return {
-                {1, 0,      0,       0},
-                {0, cos(r), -sin(r), 0},
-                {0, sin(r), cos(r),  0},
-                {0, 0,      0,       1}
+                {1, 0,         0,         0},
+                {0, cosine(r), -sine(r),  0},
+                {0, sine(r),   cosine(r), 0},
+                {0, 0,         0,         1}
         };
     }
 
     [[nodiscard]] constexpr Matrix4 rotationY(float r) {
         return {
-                {cos(r),  0, sin(r), 0},
-                {0,       1, 0,      0},
-                {-sin(r), 0, cos(r), 0},
-                {0,       0, 0,      1}
+                {cosine(r), 0, sine(r),   0},
+                {0,         1, 0,         0},
+                {-sine(r),  0, cosine(r), 0},
+                {0,         0, 0,         1}
         };
     }
 
     [[nodiscard]] constexpr Matrix4 rotationZ(float r) {
         return {
-                {cos(r), -sin(r), 0, 0},
-                {sin(r), cos(r),  0, 0},
-                {0,      0,       1, 0},
-                {0,      0,       0, 1}
+                {cosine(r), -sine(r),  0, 0},
+                {sine(r),   cosine(r), 0, 0},
+                {0,         0,         1, 0},
+                {0,         0,         0, 1}
         };
     }
 
@@ -67,6 +69,27 @@ namespace transformation {
         };
     }
 
+    /***
+     * The transformation of the world seen by an eye at `from` looking towards `to`, with `up`
+     * roughly upwards: the eye ends at the origin looking down -z, with +y up.
+     */
+    [[nodiscard]] inline Matrix4 viewTransform(const Point &from, const Point &to, const Vector &up) {
+        auto forward = (to - from).normalize();
+        if (!forward) throw std::runtime_error("Cannot build a view transform. The eye and the target are the same point.");
+        auto upward = up.normalize();
+        if (!upward) throw std::runtime_error("Cannot build a view transform. The up vector is null.");
+        auto left = forward->cross(*upward);
+        if (left.magnitude() == 0) throw std::runtime_error("Cannot build a view transform. The up vector is parallel to the view direction.");
+        auto trueUp = left.cross(*forward);
+        Matrix4 orientation = {
+                {left.x,       left.y,       left.z,       0},
+                {trueUp.x,     trueUp.y,     trueUp.z,     0},
+                {-forward->x,  -forward->y,  -forward->z,  0},
+                {0,            0,            0,            1}
+        };
+        return orientation * translation(-from.x, -from.y, -from.z);
+    }
+
 }
 
 #endif //RAYTRACERCHALLENGE_TRANSFORMATION_HPP
@@ -5,6 +5,7 @@
 #include <optional>
 
 #include "utility.hpp"
+#include "simd.hpp"
 
 struct Tuple4;
 
@@ -12,7 +13,52 @@ using Vector    = Tuple4;
 using Point     = Tuple4;
 using Color     = Tuple4;
 
-struct Tuple4 {
+/***
+ * Implementations of the `Tuple4` operations. `Scalar` is always available, `SSE` only when
+ * `RAYTRACER_SSE` is enabled; `Active` is the one `Tuple4` operators forward to.
+ */
+namespace tuple_kernels {
+
+    // Component by component.
+    struct Scalar {
+        static Tuple4 add(const Tuple4 &a, const Tuple4 &b);
+        static Tuple4 subtract(const Tuple4 &a, const Tuple4 &b);
+        static Tuple4 negate(const Tuple4 &a);
+        static Tuple4 multiply(const Tuple4 &a, float scalar);
+        static Tuple4 multiply(const Tuple4 &a, const Tuple4 &b);
+        static Tuple4 divide(const Tuple4 &a, float scalar);
+        static float dot(const Tuple4 &a, const Tuple4 &b);
+        static Tuple4 cross(const Tuple4 &a, const Tuple4 &b);
+        static float magnitude(const Tuple4 &a);
+        static constexpr bool equal(const Tuple4 &a, const Tuple4 &b);
+    };
+
+#if RAYTRACER_SSE
+    // One `__m128` per tuple.
+    struct SSE {
+        static Tuple4 add(const Tuple4 &a, const Tuple4 &b);
+        static Tuple4 subtract(const Tuple4 &a, const Tuple4 &b);
+        static Tuple4 negate(const Tuple4 &a);
+        static Tuple4 multiply(const Tuple4 &a, float scalar);
+        static Tuple4 multiply(const Tuple4 &a, const Tuple4 &b);
+        static Tuple4 divide(const Tuple4 &a, float scalar);
+        static float dot(const Tuple4 &a, const Tuple4 &b);
+        static Tuple4 cross(const Tuple4 &a, const Tuple4 &b);
+        static float magnitude(const Tuple4 &a);
+        static bool equal(const Tuple4 &a, const Tuple4 &b);
+
+        static __m128 load(const Tuple4 &a);
+        static Tuple4 store(__m128 v);
+    };
+
+    using Active = SSE;
+#else
+    using Active = Scalar;
+#endif
+}
+
+// Aligned to 16 bytes so that the SSE backend can load a tuple with a single instruction.
+struct alignas(16) Tuple4 {
 
     float x{0.0f};
     float y{0.0f};
@@ -21,11 +67,9 @@ struct Tuple4 {
 
     constexpr Tuple4(float x, float y, float z, float w) : x{x}, y{y}, z{z}, w{w} {}
 
-    friend bool operator==(const Tuple4 &c1, const Tuple4 &c2) {
-        return compareFloat(c1.x, c2.x) &&
-               compareFloat(c1.y, c2.y) &&
-               compareFloat(c1.z, c2.z)  &&
-               compareFloat(c1.w, c2.w);
+    friend constexpr bool operator==(const Tuple4 &c1, const Tuple4 &c2) {
+        if (isConstantEvaluated()) return tuple_kernels::Scalar::equal(c1, c2);
+        return tuple_kernels::Active::equal(c1, c2);
     }
 
     friend std::ostream &operator<<(std::ostream &os, const Tuple4 &tuple4) {
@@ -34,53 +78,51 @@ struct Tuple4 {
     }
 
     friend Tuple4 operator+(const Tuple4 &c1, const Tuple4 &c2) {
-        return {c1.x + c2.x, c1.y + c2.y, c1.z + c2.z, c1.w + c2.w};
+        return tuple_kernels::Active::add(c1, c2);
     }
 
     friend Tuple4 operator-(const Tuple4 &c1) {
-        return {-c1.x, -c1.y, -c1.z, -c1.w};
+        return tuple_kernels::Active::negate(c1);
     }
 
     friend Tuple4 operator-(const Tuple4 &c1, const Tuple4 &c2) {
-        return {c1.x - c2.x, c1.y - c2.y, c1.z - c2.z, c1.w - c2.w};
+        return tuple_kernels::Active::subtract(c1, c2);
     }
 
     friend Tuple4 operator*(const Tuple4& c1, const float scalar) {
-        return {c1.x * scalar, c1.y * scalar, c1.z * scalar, c1.w * scalar};
+        return tuple_kernels::Active::multiply(c1, scalar);
     }
 
     [[nodiscard]]
     float dot(const Tuple4& c1) const {
-        return ((c1.x * x )+ (c1.y * y) + (c1.z * z) + (c1.w * w));
+        return tuple_kernels::Active::dot(*this, c1);
     }
 
     friend Tuple4 operator*(const Tuple4& c1, const Tuple4& c2) {
-        return {c2.x * c1.x, c2.y * c1.y, c2.z * c1.z, c1.w * c2.w};
+        return tuple_kernels::Active::multiply(c1, c2);
     }
 
     [[nodiscard]]
     Vector cross(const Tuple4& b) const {
         // Returns a new vector that is perpendicular to `this` and `b`
-        return Tuple4(y * b.z - z * b.y,
-                      z * b.x - x * b.z,
-                      x * b.y - y * b.x, 0.0f);
+        return tuple_kernels::Active::cross(*this, b);
     }
 
     friend std::optional<Tuple4> operator/(const Tuple4& c1, const float scalar) {
         if (scalar == 0) return {};
-        return std::optional<Tuple4>({c1.x / scalar, c1.y / scalar, c1.z / scalar, c1.w / scalar});
+        return std::optional<Tuple4>(tuple_kernels::Active::divide(c1, scalar));
     }
 
     [[nodiscard]]
     float magnitude() const {
-        return std::sqrt((x * x) + (y * y) + (z * z) + (w * w));
+        return tuple_kernels::Active::magnitude(*this);
     }
 
     [[nodiscard]]
     std::optional<Tuple4> normalize() const {
         auto norm = magnitude();
         if (norm == 0) { return {}; }
-        return std::optional<Tuple4>({x / norm, y / norm, z / norm, w / norm});
+        return std::optional<Tuple4>(tuple_kernels::Active::divide(*this, norm));
     }
 
     [[nodiscard]]
@@ -90,6 +132,125 @@ struct Tuple4 {
     bool isVector() const { return this->w == 0.0f; }
 };
 
+static_assert(sizeof(Tuple4) == 4 * sizeof(float), "Tuple4 components must be packed!");
+
+namespace tuple_kernels {
+
+    inline Tuple4 Scalar::add(const Tuple4 &a, const Tuple4 &b) {
+        return {a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w};
+    }
+
+    inline Tuple4 Scalar::subtract(const Tuple4 &a, const Tuple4 &b) {
+        return {a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w};
+    }
+
+    inline Tuple4 Scalar::negate(const Tuple4 &a) {
+        return {-a.x, -a.y, -a.z, -a.w};
+    }
+
+    inline Tuple4 Scalar::multiply(const Tuple4 &a, float scalar) {
+        return {a.x * scalar, a.y * scalar, a.z * scalar, a.w * scalar};
+    }
+
+    inline Tuple4 Scalar::multiply(const Tuple4 &a, const Tuple4 &b) {
+        return {a.x * b.x, a.y * b.y, a.z * b.z, a.w * b.w};
+    }
+
+    inline Tuple4 Scalar::divide(const Tuple4 &a, float scalar) {
+        return {a.x / scalar, a.y / scalar, a.z / scalar, a.w / scalar};
+    }
+
+    inline float Scalar::dot(const Tuple4 &a, const Tuple4 &b) {
+        return ((a.x * b.x) + (a.y * b.y) + (a.z * b.z) + (a.w * b.w));
+    }
+
+    inline Tuple4 Scalar::cross(const Tuple4 &a, const Tuple4 &b) {
+        return {a.y * b.z - a.z * b.y,
+                a.z * b.x - a.x * b.z,
+                a.x * b.y - a.y * b.x, 0.0f};
+    }
+
+    inline float Scalar::magnitude(const Tuple4 &a) {
+        return std::sqrt((a.x * a.x) + (a.y * a.y) + (a.z * a.z) + (a.w * a.w));
+    }
+
+    constexpr bool Scalar::equal(const Tuple4 &a, const Tuple4 &b) {
+        return compareFloat(a.x, b.x) &&
+               compareFloat(a.y, b.y) &&
+               compareFloat(a.z, b.z) &&
+               compareFloat(a.w, b.w);
+    }
+
+#if RAYTRACER_SSE
+
+    inline __m128 SSE::load(const Tuple4 &a) {
+        return _mm_load_ps(&a.x);
+    }
+
+    inline Tuple4 SSE::store(__m128 v) {
+        Tuple4 result(0, 0, 0, 0);
+        _mm_store_ps(&result.x, v);
+        return result;
+    }
+
+    inline Tuple4 SSE::add(const Tuple4 &a, const Tuple4 &b) {
+        return store(_mm_add_ps(load(a), load(b)));
+    }
+
+    inline Tuple4 SSE::subtract(const Tuple4 &a, const Tuple4 &b) {
+        return store(_mm_sub_ps(load(a), load(b)));
+    }
+
+    inline Tuple4 SSE::negate(const Tuple4 &a) {
+        return store(_mm_xor_ps(load(a), _mm_set1_ps(-0.0f)));
+    }
+
+    inline Tuple4 SSE::multiply(const Tuple4 &a, float scalar) {
+        return store(_mm_mul_ps(load(a), _mm_set1_ps(scalar)));
+    }
+
+    inline Tuple4 SSE::multiply(const Tuple4 &a, const Tuple4 &b) {
+        return store(_mm_mul_ps(load(a), load(b)));
+    }
+
+    inline Tuple4 SSE::divide(const Tuple4 &a, float scalar) {
+        return store(_mm_div_ps(load(a), _mm_set1_ps(scalar)));
+    }
+
+    inline float SSE::dot(const Tuple4 &a, const Tuple4 &b) {
+        // Horizontal sum of the products: (x + y) + (z + w)
+        __m128 products = _mm_mul_ps(load(a), load(b));
+        __m128 swapped = _mm_shuffle_ps(products, products, _MM_SHUFFLE(2, 3, 0, 1));
+        __m128 sums = _mm_add_ps(products, swapped);
+        __m128 high = _mm_movehl_ps(swapped, sums);
+        return _mm_cvtss_f32(_mm_add_ss(sums, high));
+    }
+
+    inline Tuple4 SSE::cross(const Tuple4 &a, const Tuple4 &b) {
+        // a.yzx * b.zxy - a.zxy * b.yzx, with w forced to 0
+        __m128 va = load(a);
+        __m128 vb = load(b);
+        __m128 aYZX = _mm_shuffle_ps(va, va, _MM_SHUFFLE(3, 0, 2, 1));
+        __m128 bYZX = _mm_shuffle_ps(vb, vb, _MM_SHUFFLE(3, 0, 2, 1));
+        __m128 c = _mm_sub_ps(_mm_mul_ps(va, bYZX), _mm_mul_ps(aYZX, vb));
+        c = _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1));
+        const __m128 xyzMask = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+        return store(_mm_and_ps(c, xyzMask));
+    }
+
+    inline float SSE::magnitude(const Tuple4 &a) {
+        return _mm_cvtss_f32(_mm_sqrt_ss(_mm_set_ss(dot(a, a))));
+    }
+
+    inline bool SSE::equal(const Tuple4 &a, const Tuple4 &b) {
+        // Same as `compareFloat` on every component: |a - b| <= EPSILON
+        __m128 difference = _mm_andnot_ps(_mm_set1_ps(-0.0f), _mm_sub_ps(load(a), load(b)));
+        return _mm_movemask_ps(_mm_cmple_ps(difference, _mm_set1_ps(EPSILON))) == 0xf;
+    }
+
+#endif
+}
+
 static constexpr Color color(float x, float y, float z) {
     return {x, y, z, 0.f};
 }
@@ -0,0 +1,301 @@
+#ifndef RAYTRACERCHALLENGE_TUPLE_PACKET_HPP
+#define RAYTRACERCHALLENGE_TUPLE_PACKET_HPP
+
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+#include "utility.hpp"
+#include "tuple.hpp"
+
+/***
+ * Packets of N values processed in lock-step, in structure-of-arrays layout. Every operation is
+ * a fixed-length loop over the lanes, which the compiler turns into SIMD instructions as wide as
+ * the target allows (8 floats per instruction with AVX2, 16 with AVX-512).
+ */
+
+// One boolean per lane, stored as all-ones / all-zeros 32-bit words like SIMD compare results.
+template<size_t N>
+struct MaskxN {
+
+    alignas(32) std::array<int32_t, N> lanes {};
+
+    static MaskxN broadcast(bool value) {
+        MaskxN mask;
+        for (size_t i = 0; i < N; i++) mask.lanes[i] = value ? -1 : 0;
+        return mask;
+    }
+
+    // The first `count` lanes set, the others cleared (e.g. the active lanes of a partial packet).
+    static MaskxN first(size_t count) {
+        MaskxN mask;
+        for (size_t i = 0; i < N; i++) mask.lanes[i] = i < count ? -1 : 0;
+        return mask;
+    }
+
+    bool operator[](size_t lane) const { return lanes[lane] != 0; }
+
+    void set(size_t lane, bool value) { lanes[lane] = value ? -1 : 0; }
+
+    [[nodiscard]] bool any() const {
+        int32_t result = 0;
+        for (size_t i = 0; i < N; i++) result |= lanes[i];
+        return result != 0;
+    }
+
+    [[nodiscard]] bool all() const {
+        int32_t result = -1;
+        for (size_t i = 0; i < N; i++) result &= lanes[i];
+        return result != 0;
+    }
+
+    [[nodiscard]] bool none() const { return !any(); }
+
+    [[nodiscard]] size_t count() const {
+        size_t result = 0;
+        for (size_t i = 0; i < N; i++) result += lanes[i] != 0;
+        return result;
+    }
+
+    friend MaskxN operator&(const MaskxN &a, const MaskxN &b) {
+        MaskxN result;
+        for (size_t i = 0; i < N; i++) result.lanes[i] = a.lanes[i] & b.lanes[i];
+        return result;
+    }
+
+    friend MaskxN operator|(const MaskxN &a, const MaskxN &b) {
+        MaskxN result;
+        for (size_t i = 0; i < N; i++) result.lanes[i] = a.lanes[i] | b.lanes[i];
+        return result;
+    }
+
+    friend MaskxN operator~(const MaskxN &a) {
+        MaskxN result;
+        for (size_t i = 0; i < N; i++) result.lanes[i] = ~a.lanes[i];
+        return result;
+    }
+};
+
+// One float per lane.
+template<size_t N>
+struct FloatxN {
+
+    alignas(32) std::array<float, N> lanes {};
+
+    static FloatxN broadcast(float value) {
+        FloatxN result;
+        for (size_t i = 0; i < N; i++) result.lanes[i] = value;
+        return result;
+    }
+
+    float operator[](size_t lane) const { return lanes[lane]; }
+    float &operator[](size_t lane) { return lanes[lane]; }
+
+    friend FloatxN operator+(const FloatxN &a, const FloatxN &b) {
+        FloatxN result;
+        for (size_t i = 0; i < N; i++) result.lanes[i] = a.lanes[i] + b.lanes[i];
+        return result;
+    }
+
+    friend FloatxN operator-(const FloatxN &a, const FloatxN &b) {
+        FloatxN result;
+        for (size_t i = 0; i < N; i++) result.lanes[i] = a.lanes[i] - b.lanes[i];
+        return result;
+    }
+
+    friend FloatxN operator-(const FloatxN &a) {
+        FloatxN result;
+        for (size_t i = 0; i < N; i++) result.lanes[i] = -a.lanes[i];
+        return result;
+    }
+
+    friend FloatxN operator*(const FloatxN &a, const FloatxN &b) {
+        FloatxN result;
+        for (size_t i = 0; i < N; i++) result.lanes[i] = a.lanes[i] * b.lanes[i];
+        return result;
+    }
+
+    friend FloatxN operator/(const FloatxN &a, const FloatxN &b) {
+        FloatxN result;
+        for (size_t i = 0; i < N; i++) result.lanes[i] = a.lanes[i] / b.lanes[i];
+        return result;
+    }
+
+    [[nodiscard]] FloatxN sqrt() const {
+        FloatxN result;
+#if RAYTRACER_SSE
+        // `std::sqrt` may set errno, which keeps the compiler from vectorizing the loop.
+        if constexpr (N % 4 == 0) {
+            for (size_t i = 0; i < N; i += 4) {
+                _mm_store_ps(&result.lanes[i], _mm_sqrt_ps(_mm_load_ps(&lanes[i])));
+            }
+            return result;
+        }
+#endif
+        for (size_t i = 0; i < N; i++) result.lanes[i] = std::sqrt(lanes[i]);
+        return result;
+    }
+
+    // `compareFloat` on every lane: |a - b| <= EPSILON
+    [[nodiscard]] MaskxN<N> equal(const FloatxN &rhs) const {
+        MaskxN<N> mask;
+        for (size_t i = 0; i < N; i++) mask.lanes[i] = std::abs(lanes[i] - rhs.lanes[i]) <= EPSILON ? -1 : 0;
+        return mask;
+    }
+
+    [[nodiscard]] MaskxN<N> less(const FloatxN &rhs) const {
+        MaskxN<N> mask;
+        for (size_t i = 0; i < N; i++) mask.lanes[i] = lanes[i] < rhs.lanes[i] ? -1 : 0;
+        return mask;
+    }
+
+    [[nodiscard]] MaskxN<N> greater(const FloatxN &rhs) const {
+        MaskxN<N> mask;
+        for (size_t i = 0; i < N; i++) mask.lanes[i] = lanes[i] > rhs.lanes[i] ? -1 : 0;
+        return mask;
+    }
+
+    // Lanes of `a` where `mask` is set, lanes of `b` elsewhere.
+    friend FloatxN select(const MaskxN<N> &mask, const FloatxN &a, const FloatxN &b) {
+        // Blended bitwise: compilers keep `mask ? a : b` as one branch per lane.
+        std::array<int32_t, N> bitsA, bitsB;
+        std::memcpy(bitsA.data(), a.lanes.data(), sizeof(bitsA));
+        std::memcpy(bitsB.data(), b.lanes.data(), sizeof(bitsB));
+        for (size_t i = 0; i < N; i++) bitsA[i] = (bitsA[i] & mask.lanes[i]) | (bitsB[i] & ~mask.lanes[i]);
+        FloatxN result;
+        std::memcpy(result.lanes.data(), bitsA.data(), sizeof(bitsA));
+        return result;
+    }
+};
+
+// N `Tuple4`s, one array per component, offering the same operations as `Tuple4` lane by lane.
+template<size_t N>
+struct Tuple4xN {
+
+    static_assert(N != 0, "Packets of 0 tuples are not allowed!");
+
+    static constexpr size_t SIZE = N;
+
+    FloatxN<N> x;
+    FloatxN<N> y;
+    FloatxN<N> z;
+    FloatxN<N> w;
+
+    static Tuple4xN broadcast(const Tuple4 &t) {
+        return {FloatxN<N>::broadcast(t.x), FloatxN<N>::broadcast(t.y),
+                FloatxN<N>::broadcast(t.z), FloatxN<N>::broadcast(t.w)};
+    }
+
+    [[nodiscard]] Tuple4 lane(size_t i) const { return {x[i], y[i], z[i], w[i]}; }
+
+    void setLane(size_t i, const Tuple4 &t) {
+        x[i] = t.x;
+        y[i] = t.y;
+        z[i] = t.z;
+        w[i] = t.w;
+    }
+
+    /***
+     * Load `tuples[offset]` to `tuples[offset + N - 1]` into the lanes. Lanes past the end of
+     * `tuples` are set to zero; `MaskxN<N>::first` gives the lanes that were loaded.
+     */
+    static Tuple4xN gather(const std::vector<Tuple4> &tuples, size_t offset = 0) {
+        Tuple4xN result;
+        for (size_t i = 0; i < N && offset + i < tuples.size(); i++) {
+            result.setLane(i, tuples[offset + i]);
+        }
+        return result;
+    }
+
+    // Load `tuples[indices[i]]` into lane `i`.
+    static Tuple4xN gather(const std::vector<Tuple4> &tuples, const std::array<uint32_t, N> &indices) {
+        Tuple4xN result;
+        for (size_t i = 0; i < N; i++) {
+            result.setLane(i, tuples[indices[i]]);
+        }
+        return result;
+    }
+
+    // Store the lanes to `tuples[offset]` onward, skipping the lanes past the end of `tuples`.
+    void scatter(std::vector<Tuple4> &tuples, size_t offset = 0) const {
+        for (size_t i = 0; i < N && offset + i < tuples.size(); i++) {
+            tuples[offset + i] = lane(i);
+        }
+    }
+
+    // Store lane `i` to `tuples[indices[i]]`, for the lanes set in `mask` only.
+    void scatter(std::vector<Tuple4> &tuples, const std::array<uint32_t, N> &indices, const MaskxN<N> &mask) const {
+        for (size_t i = 0; i < N; i++) {
+            if (mask[i]) tuples[indices[i]] = lane(i);
+        }
+    }
+
+    friend Tuple4xN operator+(const Tuple4xN &a, const Tuple4xN &b) {
+        return {a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w};
+    }
+
+    friend Tuple4xN operator-(const Tuple4xN &a) {
+        return {-a.x, -a.y, -a.z, -a.w};
+    }
+
+    friend Tuple4xN operator-(const Tuple4xN &a, const Tuple4xN &b) {
+        return {a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w};
+    }
+
+    friend Tuple4xN operator*(const Tuple4xN &a, const float scalar) {
+        auto s = FloatxN<N>::broadcast(scalar);
+        return {a.x * s, a.y * s, a.z * s, a.w * s};
+    }
+
+    // Scale each lane by its own factor.
+    friend Tuple4xN operator*(const Tuple4xN &a, const FloatxN<N> &s) {
+        return {a.x * s, a.y * s, a.z * s, a.w * s};
+    }
+
+    friend Tuple4xN operator*(const Tuple4xN &a, const Tuple4xN &b) {
+        return {a.x * b.x, a.y * b.y, a.z * b.z, a.w * b.w};
+    }
+
+    [[nodiscard]] FloatxN<N> dot(const Tuple4xN &b) const {
+        return x * b.x + y * b.y + z * b.z + w * b.w;
+    }
+
+    [[nodiscard]] Tuple4xN cross(const Tuple4xN &b) const {
+        return {y * b.z - z * b.y,
+                z * b.x - x * b.z,
+                x * b.y - y * b.x,
+                FloatxN<N>{}};
+    }
+
+    [[nodiscard]] FloatxN<N> magnitude() const {
+        return dot(*this).sqrt();
+    }
+
+    /***
+     * Normalize every lane. Unlike `Tuple4::normalize` there is no optional: lanes with a zero
+     * magnitude are left as they are.
+     */
+    [[nodiscard]] Tuple4xN normalize() const {
+        auto norm = magnitude();
+        FloatxN<N> scale;
+        for (size_t i = 0; i < N; i++) scale.lanes[i] = norm.lanes[i] == 0 ? 1.f : 1.f / norm.lanes[i];
+        return *this * scale;
+    }
+
+    // `Tuple4::operator==` on every lane.
+    [[nodiscard]] MaskxN<N> equal(const Tuple4xN &b) const {
+        return x.equal(b.x) & y.equal(b.y) & z.equal(b.z) & w.equal(b.w);
+    }
+
+    friend Tuple4xN select(const MaskxN<N> &mask, const Tuple4xN &a, const Tuple4xN &b) {
+        return {select(mask, a.x, b.x), select(mask, a.y, b.y), select(mask, a.z, b.z), select(mask, a.w, b.w)};
+    }
+};
+
+using Tuple4x4 = Tuple4xN<4>;
+using Tuple4x8 = Tuple4xN<8>;
+using Tuple4x16 = Tuple4xN<16>;
+
+#endif //RAYTRACERCHALLENGE_TUPLE_PACKET_HPP
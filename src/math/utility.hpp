@@ -8,13 +8,64 @@ constexpr float EPSILON = 1e-5;
 constexpr float PI = M_PI;
 constexpr float SQR_TWO = 1.4142135623730951;
 
-bool compareFloat(float x, float y) {
+/***
+ * True while the caller is evaluated at compile time, so that constexpr functions can keep their
+ * SIMD or library implementation for run time (`std::is_constant_evaluated` is C++20). Compilers
+ * without the builtin always take the constexpr implementation.
+ */
+constexpr bool isConstantEvaluated() {
+#if defined(__GNUC__) || defined(__clang__) || (defined(_MSC_VER) && _MSC_VER >= 1925)
+    return __builtin_is_constant_evaluated();
+#else
+    return true;
+#endif
+}
+
+constexpr bool compareFloat(float x, float y) {
+    float difference = x < y ? y - x : x - y;
 #ifdef _DEBUG
-    std::fprintf(stderr, "x: %4.20f, y: %4.20f, abs(x - y) = %.20f (%d)\n", x, y, std::abs(x - y), std::abs(x - y) <= EPSILON);
+    if (!isConstantEvaluated()) {
+        std::fprintf(stderr, "x: %4.20f, y: %4.20f, abs(x - y) = %.20f (%d)\n", x, y, difference, difference <= EPSILON);
+    }
 #endif
-    return std::abs(x - y) <= EPSILON;
+    return difference <= EPSILON;
+}
+
+constexpr float radians(float deg) { return (deg / 180.0f) * M_PI; }
+
+namespace detail {
+
+    // Taylor series of sin on [-PI/2, PI/2] after reducing the angle, in double: error below 1e-12.
+    constexpr double sinReduced(double x) {
+        constexpr double TWO_PI = 2.0 * M_PI;
+        double turns = x / TWO_PI;
+        auto k = static_cast<long long>(turns < 0 ? turns - 0.5 : turns + 0.5);
+        x -= static_cast<double>(k) * TWO_PI;
+
+        // sin(PI - x) = sin(x)
+        if (x > M_PI / 2) x = M_PI - x;
+        if (x < -M_PI / 2) x = -M_PI - x;
+
+        double term = x;
+        double sum = x;
+        for (int n = 1; n <= 10; n++) {
+            term *= -x * x / ((2.0 * n) * (2.0 * n + 1));
+            sum += term;
+        }
+        return sum;
+    }
 }
 
-float radians(float deg) { return (deg / 180.0f) * M_PI; }
+// `std::sin` at run time, a series usable in constant expressions at compile time.
+constexpr float sine(float angle) {
+    if (isConstantEvaluated()) return static_cast<float>(detail::sinReduced(angle));
+    return std::sin(angle);
+}
+
+// `std::cos` at run time, a series usable in constant expressions at compile time.
+constexpr float cosine(float angle) {
+    if (isConstantEvaluated()) return static_cast<float>(detail::sinReduced(static_cast<double>(angle) + M_PI / 2));
+    return std::cos(angle);
+}
 
 #endif //RAYTRACERCHALLENGE_UTILITY_HPP
@@ -0,0 +1,229 @@
+#ifndef RAYTRACERCHALLENGE_ARENA_HPP
+#define RAYTRACERCHALLENGE_ARENA_HPP
+
+#include <new>
+#include <cstdint>
+#include <cstdlib>
+#include <cstddef>
+#include <algorithm>
+#include <memory_resource>
+
+namespace memory {
+
+    struct ArenaStats {
+        // Bytes handed out since the arena was created, padding included.
+        size_t bytes {0};
+        // The most bytes in use at once.
+        size_t peak {0};
+        // Bytes of the blocks owned by the arena.
+        size_t reserved {0};
+        size_t blocks {0};
+        // Calls to `reset` (one per frame) and to `rewind` (one per tile).
+        size_t resets {0};
+        size_t rewinds {0};
+    };
+
+    class Arena;
+
+    /***
+     * A `std::pmr::memory_resource` that allocates from an arena, so that `std::pmr` containers
+     * (e.g. `std::pmr::vector`) can hold transient render data. Deallocation does nothing: the
+     * memory comes back when the enclosing scope rewinds the arena.
+     */
+    class ArenaResource final : public std::pmr::memory_resource {
+
+        Arena *owner;
+
+    public:
+
+        explicit ArenaResource(Arena &arena) : owner{&arena} {}
+
+    private:
+
+        void *do_allocate(size_t bytes, size_t alignment) override;
+
+        void do_deallocate(void *, size_t, size_t) override {}
+
+        [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+            return this == &other;
+        }
+    };
+
+    /***
+     * A bump allocator for short-lived render data: an allocation moves a pointer forward in the
+     * current block, and memory is given back all at once, by `rewind`ing to a `Marker` or by
+     * `reset`ting the arena. Blocks are kept when rewound, so once an arena has grown to the size
+     * a frame needs, rendering more frames allocates nothing from the system.
+     *
+     * Blocks come from `std::malloc` rather than the global `operator new`. An arena is not
+     * thread-safe: each thread uses its own, `Arena::local()`.
+     */
+    class Arena {
+
+        // Blocks are linked in the order they are used, the memory follows the header.
+        struct alignas(std::max_align_t) Block {
+            Block *next;
+            size_t size;
+
+            [[nodiscard]] std::byte *data() { return reinterpret_cast<std::byte *>(this + 1); }
+        };
+
+        size_t blockSize;
+        Block *first {nullptr};
+        Block *current {nullptr};
+        size_t offset {0};
+        size_t used {0};
+        ArenaStats counters;
+        ArenaResource adapter {*this};
+
+    public:
+
+        static constexpr size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+        // A position in the arena to rewind to.
+        struct Marker {
+            Block *block {nullptr};
+            size_t offset {0};
+            size_t used {0};
+        };
+
+        explicit Arena(size_t blockSize = DEFAULT_BLOCK_SIZE) : blockSize{std::max<size_t>(blockSize, 64)} {}
+
+        Arena(const Arena &) = delete;
+
+        Arena &operator=(const Arena &) = delete;
+
+        ~Arena() {
+            while (first) {
+                auto *next = first->next;
+                std::free(first);
+                first = next;
+            }
+        }
+
+        // The arena of the calling thread.
+        static Arena &local() {
+            thread_local Arena arena;
+            return arena;
+        }
+
+        /***
+         * `bytes` bytes aligned to `alignment`, a power of two. A request larger than a block gets
+         * a block of its own.
+         */
+        [[nodiscard]] void *allocate(size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+            if (!current || !fits(current, bytes, alignment, offset)) advance(bytes, alignment);
+            auto address = reinterpret_cast<uintptr_t>(current->data() + offset);
+            size_t padding = (alignment - address % alignment) % alignment;
+            void *ptr = current->data() + offset + padding;
+            offset += padding + bytes;
+            used += padding + bytes;
+            counters.bytes += padding + bytes;
+            counters.peak = std::max(counters.peak, used);
+            return ptr;
+        }
+
+        // Storage for `count` objects of type `T`, not constructed.
+        template<typename T>
+        [[nodiscard]] T *allocate(size_t count) {
+            return static_cast<T *>(allocate(count * sizeof(T), alignof(T)));
+        }
+
+        [[nodiscard]] Marker mark() const { return {current, offset, used}; }
+
+        // Give back everything allocated since `marker` was taken.
+        void rewind(const Marker &marker) {
+            current = marker.block;
+            offset = marker.offset;
+            used = marker.used;
+            counters.rewinds += 1;
+        }
+
+        // Give back everything, keeping the blocks for the next frame.
+        void reset() {
+            current = first;
+            offset = 0;
+            used = 0;
+            counters.resets += 1;
+        }
+
+        // Bytes allocated since the last reset (or since the marker rewound to).
+        [[nodiscard]] size_t bytesInUse() const { return used; }
+
+        [[nodiscard]] const ArenaStats &stats() const { return counters; }
+
+        // The arena as a memory resource for `std::pmr` containers.
+        [[nodiscard]] std::pmr::memory_resource *resource() { return &adapter; }
+
+    private:
+
+        static bool fits(Block *block, size_t bytes, size_t alignment, size_t from) {
+            auto address = reinterpret_cast<uintptr_t>(block->data() + from);
+            size_t padding = (alignment - address % alignment) % alignment;
+            return from + padding + bytes <= block->size;
+        }
+
+        // Move on to a block with room for the allocation: the next kept block, or a new one.
+        void advance(size_t bytes, size_t alignment) {
+            Block *next = current ? current->next : first;
+            if (!next || !fits(next, bytes, alignment, 0)) {
+                size_t size = std::max(blockSize, bytes + alignment);
+                auto *block = static_cast<Block *>(std::malloc(sizeof(Block) + size));
+                if (!block) throw std::bad_alloc();
+                // Inserted after the current block: blocks past it hold nothing live, and markers
+                // only refer to blocks up to the current one.
+                *block = Block{next, size};
+                (current ? current->next : first) = block;
+                next = block;
+                counters.reserved += size;
+                counters.blocks += 1;
+            }
+            // The end of the block left behind is wasted until the arena is rewound past it.
+            if (current) used += current->size - offset;
+            current = next;
+            offset = 0;
+        }
+    };
+
+    inline void *ArenaResource::do_allocate(size_t bytes, size_t alignment) {
+        return owner->allocate(bytes, alignment);
+    }
+
+    /***
+     * Rewinds an arena, by default the thread's, to where it was when the scope was opened: what
+     * a tile allocates is given back when the tile is done.
+     */
+    class TileScope {
+
+        Arena &arena;
+        Arena::Marker marker;
+
+    public:
+
+        explicit TileScope(Arena &arena = Arena::local()) : arena{arena}, marker{arena.mark()} {}
+
+        TileScope(const TileScope &) = delete;
+
+        TileScope &operator=(const TileScope &) = delete;
+
+        ~TileScope() { arena.rewind(marker); }
+    };
+
+    // Resets an arena, by default the thread's, when a frame is done.
+    class FrameScope {
+
+        Arena &arena;
+
+    public:
+
+        explicit FrameScope(Arena &arena = Arena::local()) : arena{arena} {}
+
+        FrameScope(const FrameScope &) = delete;
+
+        FrameScope &operator=(const FrameScope &) = delete;
+
+        ~FrameScope() { arena.reset(); }
+    };
+}
+
+#endif //RAYTRACERCHALLENGE_ARENA_HPP
@@ -0,0 +1,179 @@
+#ifndef RAYTRACERCHALLENGE_PIXEL_STORAGE_HPP
+#define RAYTRACERCHALLENGE_PIXEL_STORAGE_HPP
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__F16C__)
+#include <immintrin.h>
+#endif
+
+#include "pixel.hpp"
+
+/***
+ * Pixel storage policies for `BasicCanvas`. Each policy names the compact per-pixel
+ * representation kept in memory (`value_type`) and converts it from and to a `Pixel`
+ * at the canvas accessors (`encode`/`decode`).
+ */
+namespace storage {
+
+    /***
+     * Convert a float to an IEEE 754 binary16 value, rounding to nearest even.
+     */
+    inline uint16_t floatToHalf(float value) {
+#if defined(__F16C__)
+        return static_cast<uint16_t>(_cvtss_sh(value, _MM_FROUND_TO_NEAREST_INT));
+#else
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+
+        const uint32_t sign = (bits >> 16) & 0x8000;
+        const uint32_t exponent = (bits >> 23) & 0xff;
+        uint32_t mantissa = bits & 0x7fffff;
+
+        // Infinity and NaN (keeping NaN quiet)
+        if (exponent == 0xff) {
+            return static_cast<uint16_t>(sign | 0x7c00 | (mantissa != 0 ? 0x200 : 0));
+        }
+
+        const int32_t halfExponent = static_cast<int32_t>(exponent) - 127 + 15;
+
+        // Too large, becomes infinity
+        if (halfExponent >= 0x1f) {
+            return static_cast<uint16_t>(sign | 0x7c00);
+        }
+
+        // Subnormal half, or too small to be represented at all
+        if (halfExponent <= 0) {
+            if (halfExponent < -10) return static_cast<uint16_t>(sign);
+            mantissa |= 0x800000;
+            const uint32_t shift = static_cast<uint32_t>(14 - halfExponent);
+            uint32_t half = mantissa >> shift;
+            const uint32_t remainder = mantissa & ((1u << shift) - 1);
+            const uint32_t halfway = 1u << (shift - 1);
+            if (remainder > halfway || (remainder == halfway && (half & 1))) half++;
+            return static_cast<uint16_t>(sign | half);
+        }
+
+        // A carry out of the mantissa correctly bumps the exponent (up to infinity).
+        uint32_t half = sign | (static_cast<uint32_t>(halfExponent) << 10) | (mantissa >> 13);
+        const uint32_t remainder = mantissa & 0x1fff;
+        if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1))) half++;
+        return static_cast<uint16_t>(half);
+#endif
+    }
+
+    /***
+     * Convert an IEEE 754 binary16 value to a float (exact).
+     */
+    inline float halfToFloat(uint16_t half) {
+#if defined(__F16C__)
+        return _cvtsh_ss(half);
+#else
+        const uint32_t sign = static_cast<uint32_t>(half & 0x8000) << 16;
+        uint32_t exponent = (half >> 10) & 0x1f;
+        uint32_t mantissa = half & 0x3ff;
+        uint32_t bits;
+
+        if (exponent == 0x1f) {
+            bits = sign | 0x7f800000 | (mantissa << 13);
+        } else if (exponent != 0) {
+            bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+        } else if (mantissa == 0) {
+            bits = sign;
+        } else {
+            // Normalize the subnormal half
+            exponent = 1;
+            while ((mantissa & 0x400) == 0) {
+                mantissa <<= 1;
+                exponent -= 1;
+            }
+            bits = sign | ((exponent + 112) << 23) | ((mantissa & 0x3ff) << 13);
+        }
+
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+#endif
+    }
+
+    /***
+     * Scale a channel in [0, 1] to [0, 255], clamping and rounding to nearest.
+     */
+    inline uint8_t floatToUnorm8(float channel) {
+        if (!(channel > 0.f)) return 0;
+        if (channel >= 1.f) return 0xff;
+        return static_cast<uint8_t>(channel * 255.f + 0.5f);
+    }
+
+    inline float unorm8ToFloat(uint8_t channel) {
+        return static_cast<float>(channel) * (1.f / 255.f);
+    }
+
+    // The full `Pixel` (four floats, 16 bytes). Lossless.
+    struct RGBA32F {
+        using value_type = Pixel;
+
+        static value_type encode(const Pixel &pixel) { return pixel; }
+        static Pixel decode(const value_type &value) { return value; }
+    };
+
+    // Three linear floats (12 bytes). Lossless for colors.
+    struct RGB32F {
+        struct value_type {
+            float r {0.f};
+            float g {0.f};
+            float b {0.f};
+        };
+
+        static value_type encode(const Pixel &pixel) {
+            return {pixel.color.x, pixel.color.y, pixel.color.z};
+        }
+
+        static Pixel decode(const value_type &value) {
+            return Pixel(color(value.r, value.g, value.b));
+        }
+    };
+
+    // Three half floats (6 bytes). Keeps HDR range with ~3 significant digits.
+    struct RGB16F {
+        struct value_type {
+            uint16_t r {0};
+            uint16_t g {0};
+            uint16_t b {0};
+        };
+
+        static value_type encode(const Pixel &pixel) {
+            return {floatToHalf(pixel.color.x), floatToHalf(pixel.color.y), floatToHalf(pixel.color.z)};
+        }
+
+        static Pixel decode(const value_type &value) {
+            return Pixel(color(halfToFloat(value.r), halfToFloat(value.g), halfToFloat(value.b)));
+        }
+    };
+
+    // Display-ready 8 bits per channel (4 bytes), clamped to [0, 1].
+    struct RGBA8 {
+        struct value_type {
+            uint8_t r {0};
+            uint8_t g {0};
+            uint8_t b {0};
+            uint8_t a {0xff};
+        };
+
+        static value_type encode(const Pixel &pixel) {
+            return {floatToUnorm8(pixel.color.x), floatToUnorm8(pixel.color.y), floatToUnorm8(pixel.color.z), 0xff};
+        }
+
+        static Pixel decode(const value_type &value) {
+            return Pixel(color(unorm8ToFloat(value.r), unorm8ToFloat(value.g), unorm8ToFloat(value.b)));
+        }
+    };
+
+    static_assert(sizeof(RGBA32F::value_type) == 16);
+    static_assert(sizeof(RGB32F::value_type) == 12);
+    static_assert(sizeof(RGB16F::value_type) == 6);
+    static_assert(sizeof(RGBA8::value_type) == 4);
+}
+
+#endif //RAYTRACERCHALLENGE_PIXEL_STORAGE_HPP
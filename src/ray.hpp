@@ -0,0 +1,56 @@
+#ifndef RAYTRACERCHALLENGE_RAY_HPP
+#define RAYTRACERCHALLENGE_RAY_HPP
+
+#include "math/tuple.hpp"
+#include "math/tuple_packet.hpp"
+#include "math/matrix.hpp"
+
+struct Ray {
+
+    Point origin {point(0, 0, 0)};
+    Vector direction {vector(0, 0, 0)};
+
+    constexpr Ray() = default;
+
+    constexpr Ray(const Point &origin, const Vector &direction) : origin{origin}, direction{direction} {}
+
+    // The point at distance `t` along the ray.
+    [[nodiscard]] Point position(float t) const {
+        return origin + direction * t;
+    }
+
+    // The ray in the space `m` maps to. The direction is not normalized, so `t` values are preserved.
+    [[nodiscard]] constexpr Ray transform(const Matrix4 &m) const {
+        return {m * origin, m * direction};
+    }
+};
+
+/***
+ * N rays in structure-of-arrays layout, traced in lock-step (see `tuple_packet.hpp`).
+ */
+template<size_t N>
+struct RayPacket {
+
+    Tuple4xN<N> origin;
+    Tuple4xN<N> direction;
+
+    [[nodiscard]] Ray lane(size_t i) const { return {origin.lane(i), direction.lane(i)}; }
+
+    void setLane(size_t i, const Ray &ray) {
+        origin.setLane(i, ray.origin);
+        direction.setLane(i, ray.direction);
+    }
+
+    [[nodiscard]] Tuple4xN<N> position(const FloatxN<N> &t) const {
+        return origin + direction * t;
+    }
+
+    // Every ray transformed by the same matrix, one broadcast entry at a time.
+    [[nodiscard]] RayPacket transform(const Matrix4 &m) const {
+        return {m * origin, m * direction};
+    }
+};
+
+using RayPacket8 = RayPacket<8>;
+
+#endif //RAYTRACERCHALLENGE_RAY_HPP
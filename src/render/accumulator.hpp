@@ -0,0 +1,88 @@
+#ifndef RAYTRACERCHALLENGE_ACCUMULATOR_HPP
+#define RAYTRACERCHALLENGE_ACCUMULATOR_HPP
+
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+
+#include "../color.hpp"
+#include "../canvas.hpp"
+#include "tile_renderer.hpp"
+
+namespace render {
+
+    /***
+     * Per-pixel sums of samples and sample counts, kept next to a canvas so that passes of
+     * samples can be added over time and the canvas shows their average. Pixels are independent,
+     * so distinct tiles can be accumulated concurrently.
+     */
+    class Accumulator {
+
+        std::vector<Tuple4> sums;
+        std::vector<uint32_t> counts;
+
+    public:
+
+        uint32_t width {0};
+        uint32_t height {0};
+
+        Accumulator(uint32_t width, uint32_t height) : sums(static_cast<size_t>(width) * height, Colors::BLACK),
+                                                       counts(static_cast<size_t>(width) * height, 0),
+                                                       width{width}, height{height} {}
+
+        // Add `samples` samples whose colors add up to `sum`.
+        void add(size_t x, size_t y, const Tuple4 &sum, uint32_t samples = 1) {
+            auto i = x + y * width;
+            sums[i] = sums[i] + sum;
+            counts[i] += samples;
+        }
+
+        [[nodiscard]] uint32_t samples(size_t x, size_t y) const { return counts[x + y * width]; }
+
+        // The mean of the samples of a pixel, black if it has none.
+        [[nodiscard]] Tuple4 average(size_t x, size_t y) const {
+            auto i = x + y * width;
+            if (counts[i] == 0) return Colors::BLACK;
+            return sums[i] * (1.f / static_cast<float>(counts[i]));
+        }
+
+        // Move the samples of `tile` from `other`, which must have the same size, into this accumulator.
+        void take(Accumulator &other, const Tile &tile) {
+            for (uint32_t y = tile.y; y < tile.y + tile.height; y++) {
+                for (uint32_t x = tile.x; x < tile.x + tile.width; x++) {
+                    auto i = x + y * width;
+                    sums[i] = sums[i] + other.sums[i];
+                    counts[i] += other.counts[i];
+                    other.sums[i] = Colors::BLACK;
+                    other.counts[i] = 0;
+                }
+            }
+        }
+
+        void clear() {
+            std::fill(sums.begin(), sums.end(), Colors::BLACK);
+            std::fill(counts.begin(), counts.end(), 0);
+        }
+
+        // Write the averages of `tile` to `canvas`, which must have the size of the accumulator.
+        template<typename Storage, typename Layout>
+        void resolve(BasicCanvas<Storage, Layout> &canvas, const Tile &tile) const {
+            auto shade = [this](size_t x, size_t y) { return Pixel(average(x, y)); };
+            TileRenderer::fill(canvas, tile, shade);
+        }
+
+        template<typename Storage, typename Layout>
+        void resolve(BasicCanvas<Storage, Layout> &canvas) const {
+            if (canvas.width != width || canvas.height != height) {
+                throw std::runtime_error("Cannot resolve accumulator. The canvas has a different size.");
+            }
+            for (uint32_t y = 0; y < height; y += Layout::TILE_SIZE) {
+                for (uint32_t x = 0; x < width; x += Layout::TILE_SIZE) {
+                    resolve(canvas, {x, y, std::min(Layout::TILE_SIZE, width - x), std::min(Layout::TILE_SIZE, height - y)});
+                }
+            }
+        }
+    };
+}
+
+#endif //RAYTRACERCHALLENGE_ACCUMULATOR_HPP
@@ -0,0 +1,165 @@
+#ifndef RAYTRACERCHALLENGE_ADAPTIVE_HPP
+#define RAYTRACERCHALLENGE_ADAPTIVE_HPP
+
+#include <cmath>
+#include <atomic>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <stdexcept>
+
+#include "sampling.hpp"
+#include "accumulator.hpp"
+#include "tile_renderer.hpp"
+
+namespace render {
+
+    struct AdaptiveOptions {
+        // Samples every pixel gets before its variance is estimated.
+        uint32_t baseSamples {4};
+        uint32_t maxSamples {64};
+        // Samples added to each pixel that still needs them, per refinement round.
+        uint32_t batchSamples {4};
+        // A pixel is refined while the standard error of its mean luminance is above this...
+        float errorThreshold {0.01f};
+        // ...or while its mean luminance differs from a neighbour's by more than this.
+        float contrastThreshold {0.1f};
+        Sequence sequence {Sequence::SOBOL};
+    };
+
+    struct AdaptiveResult {
+        uint64_t samples {0};
+        // Refinement rounds after the base pass.
+        uint32_t rounds {0};
+    };
+
+    /***
+     * Anti-aliasing that spends samples where they matter: every pixel gets `baseSamples`, then in
+     * rounds, pixels whose estimate is still noisy (standard error of the mean luminance) or which
+     * sit on an edge (contrast with a neighbour) get `batchSamples` more, up to `maxSamples`. Flat
+     * regions stop at the base count. Sample positions inside a pixel follow a scrambled
+     * low-discrepancy sequence, so even few samples cover the pixel evenly.
+     */
+    class AdaptiveSampler {
+
+        TileRenderer renderer;
+        AdaptiveOptions options;
+
+        static float luminance(const Tuple4 &c) {
+            return 0.2126f * c.x + 0.7152f * c.y + 0.0722f * c.z;
+        }
+
+    public:
+
+        explicit AdaptiveSampler(const AdaptiveOptions &options = {}, const TileRendererOptions &tiles = {}) :
+                renderer{tiles}, options{options} {
+            if (options.baseSamples == 0 || options.batchSamples == 0) {
+                throw std::runtime_error("Cannot create sampler. Base and batch sample counts must be positive.");
+            }
+            if (options.maxSamples < options.baseSamples) {
+                throw std::runtime_error("Cannot create sampler. The maximum sample count is below the base one.");
+            }
+        }
+
+        /***
+         * Render `canvas` with the colors returned by `sample(px, py)` for points of the image plane,
+         * where pixel (x, y) covers [x, x + 1) x [y, y + 1). `sample` is called concurrently and must
+         * be thread-safe. `accumulator`, of the canvas size, receives the samples.
+         */
+        template<typename Storage, typename Layout, typename Fn>
+        AdaptiveResult render(BasicCanvas<Storage, Layout> &canvas, Accumulator &accumulator, Fn &&sample) {
+
+            if (canvas.width != accumulator.width || canvas.height != accumulator.height) {
+                throw std::runtime_error("Cannot render canvas. The accumulator has a different size.");
+            }
+            renderer.checkLayout<Layout>();
+
+            const uint32_t width = canvas.width, height = canvas.height;
+            const size_t pixels = static_cast<size_t>(width) * height;
+
+            accumulator.clear();
+            // Sums of squared sample luminances, for the variance.
+            std::vector<float> squares(pixels, 0);
+            std::vector<uint8_t> refine(pixels, 1);
+            std::vector<float> means(pixels, 0);
+
+            std::atomic<uint64_t> total {0};
+
+            auto samplePixels = [&](const Tile &tile, uint32_t count) {
+                uint64_t taken = 0;
+                for (uint32_t y = tile.y; y < tile.y + tile.height; y++) {
+                    for (uint32_t x = tile.x; x < tile.x + tile.width; x++) {
+                        auto i = x + static_cast<size_t>(y) * width;
+                        if (!refine[i]) continue;
+                        auto first = accumulator.samples(x, y);
+                        auto last = std::min(first + count, options.maxSamples);
+                        auto scramble = pixelHash(x, y);
+                        auto sum = Colors::BLACK;
+                        float squared = 0;
+                        for (uint32_t s = first; s < last; s++) {
+                            auto uv = samplePoint(options.sequence, s, scramble);
+                            Tuple4 c = sample(static_cast<float>(x) + uv[0], static_cast<float>(y) + uv[1]);
+                            sum = sum + c;
+                            squared += luminance(c) * luminance(c);
+                        }
+                        accumulator.add(x, y, sum, last - first);
+                        squares[i] += squared;
+                        means[i] = luminance(accumulator.average(x, y));
+                        taken += last - first;
+                    }
+                }
+                total.fetch_add(taken, std::memory_order_relaxed);
+            };
+
+            // Decide from the estimates so far which pixels get more samples. Marks go to a second
+            // buffer, so that every pixel is judged before any is refined.
+            std::vector<uint8_t> next(pixels, 0);
+            std::atomic<uint64_t> marked {0};
+            auto mark = [&](const Tile &tile) {
+                uint64_t count = 0;
+                for (uint32_t y = tile.y; y < tile.y + tile.height; y++) {
+                    for (uint32_t x = tile.x; x < tile.x + tile.width; x++) {
+                        auto i = x + static_cast<size_t>(y) * width;
+                        auto n = accumulator.samples(x, y);
+                        bool more = false;
+                        if (n < options.maxSamples) {
+                            if (n < 2) {
+                                more = true;
+                            } else {
+                                float mean = means[i];
+                                float variance = std::max(0.f, (squares[i] / n - mean * mean) * n / (n - 1));
+                                more = std::sqrt(variance / n) > options.errorThreshold;
+                            }
+                            auto contrast = [&](size_t j) {
+                                return std::abs(means[j] - means[i]) > options.contrastThreshold;
+                            };
+                            more = more || (x > 0 && contrast(i - 1)) || (x + 1 < width && contrast(i + 1)) ||
+                                   (y > 0 && contrast(i - width)) || (y + 1 < height && contrast(i + width));
+                        }
+                        next[i] = more;
+                        count += more;
+                    }
+                }
+                marked.fetch_add(count, std::memory_order_relaxed);
+            };
+
+            AdaptiveResult result;
+            renderer.forEachTile(width, height, [&](const Tile &tile) { samplePixels(tile, options.baseSamples); });
+
+            while (true) {
+                marked = 0;
+                renderer.forEachTile(width, height, mark);
+                if (marked == 0) break;
+                refine.swap(next);
+                result.rounds += 1;
+                renderer.forEachTile(width, height, [&](const Tile &tile) { samplePixels(tile, options.batchSamples); });
+            }
+
+            renderer.forEachTile(width, height, [&](const Tile &tile) { accumulator.resolve(canvas, tile); });
+            result.samples = total;
+            return result;
+        }
+    };
+}
+
+#endif //RAYTRACERCHALLENGE_ADAPTIVE_HPP
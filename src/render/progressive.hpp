@@ -0,0 +1,112 @@
+#ifndef RAYTRACERCHALLENGE_PROGRESSIVE_HPP
+#define RAYTRACERCHALLENGE_PROGRESSIVE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <algorithm>
+#include <stdexcept>
+
+#include "accumulator.hpp"
+#include "tile_renderer.hpp"
+
+namespace render {
+
+    struct ProgressiveOptions {
+        // Stop once every pixel has this many samples.
+        uint32_t maxSamples {64};
+    };
+
+    struct PassInfo {
+        // 0 for the first pass.
+        uint32_t pass {0};
+        // Samples per pixel after the pass.
+        uint32_t samples {0};
+        // Since the start of the render; for the first pass, the time to first image.
+        std::chrono::nanoseconds elapsed {0};
+        RenderStats stats;
+    };
+
+    /***
+     * Renders a canvas in passes that double the number of samples per pixel: 1, 2, 4 and so on up to
+     * `maxSamples`. The first image is ready after a single sample per pixel; each later pass adds as
+     * many samples as all the previous ones, so the noise keeps dropping at a steady rate. After every
+     * pass the canvas holds the average of all samples so far and `onPass` is called, typically to
+     * write a snapshot with `io::writeSnapshot`.
+     */
+    class ProgressiveRenderer {
+
+        TileRenderer renderer;
+        ProgressiveOptions options;
+
+    public:
+
+        explicit ProgressiveRenderer(const ProgressiveOptions &options = {}, const TileRendererOptions &tiles = {}) :
+                renderer{tiles}, options{options} {
+            if (options.maxSamples == 0) {
+                throw std::runtime_error("Cannot create renderer. At least one sample per pixel is needed.");
+            }
+        }
+
+        /***
+         * Render `canvas`, accumulating in `accumulator` (which must have its size) the colors
+         * returned by `sample(x, y, index)` for the `index`-th sample of a pixel. `sample` is called
+         * concurrently and must be thread-safe. A pass is sampled into a scratch accumulator and only
+         * added to `accumulator` and `canvas` once every tile is done. Setting `cancel` stops the
+         * render at the next tile; the pass in progress is then dropped without calling `onPass`, so
+         * `accumulator`, `canvas` and the last snapshot stay those of the last complete pass.
+         * @return The samples per pixel of the last complete pass.
+         */
+        template<typename Storage, typename Layout, typename SampleFn, typename PassFn>
+        uint32_t render(BasicCanvas<Storage, Layout> &canvas, Accumulator &accumulator, SampleFn &&sample,
+                        PassFn &&onPass, const std::atomic<bool> *cancel = nullptr) {
+
+            using Clock = std::chrono::steady_clock;
+
+            if (canvas.width != accumulator.width || canvas.height != accumulator.height) {
+                throw std::runtime_error("Cannot render canvas. The accumulator has a different size.");
+            }
+            renderer.checkLayout<Layout>();
+
+            const auto start = Clock::now();
+            accumulator.clear();
+            Accumulator scratch(canvas.width, canvas.height);
+
+            uint32_t samples = 0;
+            for (uint32_t pass = 0; samples < options.maxSamples; pass++) {
+
+                const uint32_t first = samples;
+                const uint32_t count = std::min(std::max(samples, 1u), options.maxSamples - samples);
+
+                std::atomic<bool> skipped {false};
+                auto stats = renderer.forEachTile(canvas.width, canvas.height, [&](const Tile &tile) {
+                    if (cancel && cancel->load(std::memory_order_relaxed)) {
+                        skipped.store(true, std::memory_order_relaxed);
+                        return;
+                    }
+                    for (uint32_t y = tile.y; y < tile.y + tile.height; y++) {
+                        for (uint32_t x = tile.x; x < tile.x + tile.width; x++) {
+                            auto sum = Colors::BLACK;
+                            for (uint32_t i = first; i < first + count; i++) sum = sum + sample(x, y, i);
+                            scratch.add(x, y, sum, count);
+                        }
+                    }
+                });
+
+                if (skipped.load()) break;
+
+                // Every tile of the pass is sampled: commit it, which also clears the scratch.
+                renderer.forEachTile(canvas.width, canvas.height, [&](const Tile &tile) {
+                    accumulator.take(scratch, tile);
+                    accumulator.resolve(canvas, tile);
+                });
+
+                samples += count;
+                onPass(PassInfo{pass, samples, Clock::now() - start, std::move(stats)});
+            }
+            return samples;
+        }
+    };
+}
+
+#endif //RAYTRACERCHALLENGE_PROGRESSIVE_HPP
@@ -0,0 +1,92 @@
+#ifndef RAYTRACERCHALLENGE_SAMPLING_HPP
+#define RAYTRACERCHALLENGE_SAMPLING_HPP
+
+#include <array>
+#include <cstdint>
+
+/***
+ * Low-discrepancy sequences of 2D sample positions in [0, 1)^2. Consecutive points fill the square
+ * evenly, so the error of an average over them drops faster than with random points. Every pixel
+ * takes the same sequence, decorrelated by a per-pixel `scramble` (see `pixelHash`) to avoid
+ * structured patterns across the image.
+ */
+namespace render {
+
+    enum class Sequence {
+        SOBOL,
+        R2
+    };
+
+    // A well-mixed 32-bit hash of a pixel, to scramble the sequence of each pixel differently.
+    constexpr uint32_t pixelHash(uint32_t x, uint32_t y, uint32_t seed = 0) {
+        uint32_t h = x * 0x8da6b343u ^ y * 0xd8163841u ^ seed * 0xcb1ab31fu;
+        h ^= h >> 16;
+        h *= 0x7feb352du;
+        h ^= h >> 15;
+        h *= 0x846ca68bu;
+        h ^= h >> 16;
+        return h;
+    }
+
+    namespace detail {
+
+        // 24 significant bits, the most a float in [0, 1) holds exactly.
+        constexpr float unitFloat(uint32_t bits) {
+            return static_cast<float>(bits >> 8) * (1.f / 16777216.f);
+        }
+
+        constexpr uint32_t reverseBits(uint32_t v) {
+            v = ((v >> 1) & 0x55555555u) | ((v & 0x55555555u) << 1);
+            v = ((v >> 2) & 0x33333333u) | ((v & 0x33333333u) << 2);
+            v = ((v >> 4) & 0x0f0f0f0fu) | ((v & 0x0f0f0f0fu) << 4);
+            v = ((v >> 8) & 0x00ff00ffu) | ((v & 0x00ff00ffu) << 8);
+            return (v >> 16) | (v << 16);
+        }
+
+        // Independent bits for the second dimension; 0 (no scrambling) stays 0.
+        constexpr uint32_t secondScramble(uint32_t scramble) {
+            return scramble == 0 ? 0 : pixelHash(scramble, 0x9e3779b9u);
+        }
+
+        // The second Sobol dimension: primitive polynomial x + 1, direction numbers v_k = v_{k-1} ^ (v_{k-1} >> 1).
+        constexpr uint32_t sobolSecond(uint32_t index) {
+            uint32_t result = 0;
+            for (uint32_t v = 1u << 31; index != 0; index >>= 1, v ^= v >> 1) {
+                if (index & 1) result ^= v;
+            }
+            return result;
+        }
+    }
+
+    /***
+     * The `index`-th point of the 2D Sobol sequence with random digit scrambling: XOR-ing every
+     * point with the same bits keeps its stratification, so any 2^k consecutive points starting at a
+     * multiple of 2^k still fall one per cell of every 2^a x 2^b grid with a + b = k.
+     */
+    constexpr std::array<float, 2> sobol(uint32_t index, uint32_t scramble = 0) {
+        uint32_t second = detail::secondScramble(scramble);
+        return {detail::unitFloat(detail::reverseBits(index) ^ scramble),
+                detail::unitFloat(detail::sobolSecond(index) ^ second)};
+    }
+
+    /***
+     * The `index`-th point of the R2 sequence (M. Roberts, "The Unreasonable Effectiveness of
+     * Quasirandom Sequences"), the 2D generalization of the golden ratio sequence, shifted modulo 1
+     * by an offset derived from `scramble`. Its points are not stratified like Sobol points, but any
+     * number of them is evenly spread, which suits sample counts that are not powers of two.
+     */
+    constexpr std::array<float, 2> r2(uint32_t index, uint32_t scramble = 0) {
+        // 2^32 / g and 2^32 / g^2 for the plastic number g; unsigned overflow computes the fraction.
+        constexpr uint32_t A1 = 3242174889u;
+        constexpr uint32_t A2 = 2447445414u;
+        uint32_t second = detail::secondScramble(scramble);
+        return {detail::unitFloat(0x80000000u + A1 * index + scramble),
+                detail::unitFloat(0x80000000u + A2 * index + second)};
+    }
+
+    constexpr std::array<float, 2> samplePoint(Sequence sequence, uint32_t index, uint32_t scramble) {
+        return sequence == Sequence::SOBOL ? sobol(index, scramble) : r2(index, scramble);
+    }
+}
+
+#endif //RAYTRACERCHALLENGE_SAMPLING_HPP
@@ -0,0 +1,175 @@
+#ifndef RAYTRACERCHALLENGE_STREAM_HPP
+#define RAYTRACERCHALLENGE_STREAM_HPP
+
+#include <limits>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <stdexcept>
+#include <memory_resource>
+
+#include "../world.hpp"
+#include "tile_renderer.hpp"
+
+namespace render {
+
+    // The closest hit of a ray of a stream; `object` is NONE for a miss.
+    struct StreamHit {
+        static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+        float t {std::numeric_limits<float>::infinity()};
+        uint32_t object {NONE};
+    };
+
+    /***
+     * Rays traced as a batch rather than one by one, stored as one array per component so that
+     * packets of consecutive rays are loaded lane by lane. Each ray carries an `id` (e.g. its
+     * pixel) that survives `sort`. The arrays, and the temporaries of `sort`, come from `resource`:
+     * a stream built per tile can live in the thread's arena (see `memory::Arena`).
+     */
+    class RayStream {
+
+        std::pmr::vector<float> ox, oy, oz;
+        std::pmr::vector<float> dx, dy, dz;
+        std::pmr::vector<uint32_t> ids;
+
+    public:
+
+        explicit RayStream(std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+                : ox{resource}, oy{resource}, oz{resource}, dx{resource}, dy{resource}, dz{resource}, ids{resource} {}
+
+        [[nodiscard]] size_t size() const { return ids.size(); }
+
+        [[nodiscard]] bool empty() const { return ids.empty(); }
+
+        void reserve(size_t count) {
+            for (auto *v: {&ox, &oy, &oz, &dx, &dy, &dz}) v->reserve(count);
+            ids.reserve(count);
+        }
+
+        void clear() {
+            for (auto *v: {&ox, &oy, &oz, &dx, &dy, &dz}) v->clear();
+            ids.clear();
+        }
+
+        void add(const Ray &ray, uint32_t id) {
+            ox.push_back(ray.origin.x);
+            oy.push_back(ray.origin.y);
+            oz.push_back(ray.origin.z);
+            dx.push_back(ray.direction.x);
+            dy.push_back(ray.direction.y);
+            dz.push_back(ray.direction.z);
+            ids.push_back(id);
+        }
+
+        [[nodiscard]] Ray ray(size_t i) const { return {point(ox[i], oy[i], oz[i]), vector(dx[i], dy[i], dz[i])}; }
+
+        [[nodiscard]] uint32_t id(size_t i) const { return ids[i]; }
+
+        /***
+         * Add the primary rays of the pixels of `tile`, from `rayAt(x, y)`. Their id is the index of
+         * the pixel in an image `width` pixels wide. Pixels go by 4 x 4 blocks, in Z-order inside a
+         * block, so that any 8 or 16 consecutive rays cover a 4 x 2 or 4 x 4 patch of the image
+         * rather than a thin strip of a row.
+         */
+        template<typename Fn>
+        void generate(const Tile &tile, uint32_t width, Fn &&rayAt) {
+            reserve(size() + static_cast<size_t>(tile.width) * tile.height);
+            for (uint32_t by = tile.y; by < tile.y + tile.height; by += 4) {
+                for (uint32_t bx = tile.x; bx < tile.x + tile.width; bx += 4) {
+                    for (uint32_t i = 0; i < 16; i++) {
+                        uint32_t x = bx + ((i & 1) | (i >> 1 & 2));
+                        uint32_t y = by + ((i >> 1 & 1) | (i >> 2 & 2));
+                        if (x < tile.x + tile.width && y < tile.y + tile.height) add(rayAt(x, y), x + y * width);
+                    }
+                }
+            }
+        }
+
+        /***
+         * The rays `offset` to `offset + N - 1` as a packet. Lanes past the end of the stream are
+         * left zeroed; `MaskxN<N>::first(size() - offset)` gives the loaded ones.
+         */
+        template<size_t N>
+        [[nodiscard]] RayPacket<N> packet(size_t offset) const {
+            RayPacket<N> rays;
+            const size_t count = std::min(N, size() - offset);
+            for (size_t i = 0; i < count; i++) {
+                rays.origin.x[i] = ox[offset + i];
+                rays.origin.y[i] = oy[offset + i];
+                rays.origin.z[i] = oz[offset + i];
+                rays.origin.w[i] = 1;
+                rays.direction.x[i] = dx[offset + i];
+                rays.direction.y[i] = dy[offset + i];
+                rays.direction.z[i] = dz[offset + i];
+            }
+            return rays;
+        }
+
+        /***
+         * Reorder the rays so that neighbours go the same way from nearby origins: by direction
+         * octant first, then along a Morton curve over a 256^3 grid of `bounds`. Secondary rays come
+         * out of shading in pixel order, pointing every which way; sorted, the rays of a packet
+         * visit mostly the same nodes of the hierarchy.
+         */
+        void sort(const accel::AABB &bounds) {
+
+            std::pmr::vector<uint64_t> keys(size(), ids.get_allocator());
+            for (size_t i = 0; i < keys.size(); i++) {
+                uint32_t octant = (dx[i] < 0) | (dy[i] < 0) << 1 | (dz[i] < 0) << 2;
+                uint32_t cell = morton(cellOf(ox[i], bounds, 0), cellOf(oy[i], bounds, 1), cellOf(oz[i], bounds, 2));
+                keys[i] = static_cast<uint64_t>(octant << 24 | cell) << 32 | i;
+            }
+            std::sort(keys.begin(), keys.end());
+
+            for (auto *v: {&ox, &oy, &oz, &dx, &dy, &dz}) permute(*v, keys);
+            permute(ids, keys);
+        }
+
+    private:
+
+        static uint32_t cellOf(float value, const accel::AABB &bounds, size_t axis) {
+            float extent = bounds.upper[axis] - bounds.lower[axis];
+            if (!(extent > 0)) return 0;
+            float cell = (value - bounds.lower[axis]) / extent * 256;
+            return static_cast<uint32_t>(std::clamp(cell, 0.f, 255.f));
+        }
+
+        // Interleave the 8 low bits of x, y and z.
+        static uint32_t morton(uint32_t x, uint32_t y, uint32_t z) {
+            auto spread = [](uint32_t v) {
+                v = (v | v << 8) & 0x0000f00fu;
+                v = (v | v << 4) & 0x000c30c3u;
+                v = (v | v << 2) & 0x00249249u;
+                return v;
+            };
+            return spread(x) | spread(y) << 1 | spread(z) << 2;
+        }
+
+        template<typename T>
+        static void permute(std::pmr::vector<T> &values, const std::pmr::vector<uint64_t> &keys) {
+            std::pmr::vector<T> sorted(values.size(), values.get_allocator());
+            for (size_t i = 0; i < keys.size(); i++) sorted[i] = values[static_cast<uint32_t>(keys[i])];
+            values.swap(sorted);
+        }
+    };
+
+    /***
+     * The closest hits of every ray of `stream`, traced N at a time as packets.
+     * @param hits Receives the hit of `stream.ray(i)` at index i.
+     */
+    template<size_t N, typename Allocator>
+    void trace(const World &world, const RayStream &stream, std::vector<StreamHit, Allocator> &hits) {
+
+        hits.resize(stream.size());
+        for (size_t offset = 0; offset < stream.size(); offset += N) {
+            auto count = std::min(N, stream.size() - offset);
+            auto packet = world.intersect(stream.packet<N>(offset), MaskxN<N>::first(count));
+            for (size_t i = 0; i < count; i++) {
+                hits[offset + i] = packet.mask[i] ? StreamHit{packet.t[i], packet.object[i]} : StreamHit{};
+            }
+        }
+    }
+}
+
+#endif //RAYTRACERCHALLENGE_STREAM_HPP
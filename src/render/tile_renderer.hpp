@@ -0,0 +1,288 @@
+#ifndef RAYTRACERCHALLENGE_TILE_RENDERER_HPP
+#define RAYTRACERCHALLENGE_TILE_RENDERER_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <exception>
+#include <algorithm>
+#include <stdexcept>
+
+#include "../canvas.hpp"
+#include "../memory/arena.hpp"
+#include "../concurrency/thread_pool.hpp"
+
+namespace render {
+
+    // A rectangle of the image handed to one worker.
+    struct Tile {
+        uint32_t x {0};
+        uint32_t y {0};
+        uint32_t width {0};
+        uint32_t height {0};
+    };
+
+    struct TileRendererOptions {
+        // Side of the square tiles the canvas is split in. For layouts other than `layout::RowMajor`
+        // it must be a multiple of the layout tile size, so that render tiles never split a block.
+        uint32_t tileSize {32};
+        // Worker threads, including the calling thread. 0 uses every hardware thread.
+        uint32_t threads {0};
+    };
+
+    /***
+     * Tile render times, in power of two buckets: bucket `i` counts the tiles that took
+     * [2^i, 2^(i+1)) microseconds (bucket 0 also counts the tiles faster than a microsecond).
+     */
+    struct TileHistogram {
+
+        static constexpr size_t BUCKETS = 32;
+
+        std::array<uint64_t, BUCKETS> counts {};
+
+        void add(std::chrono::nanoseconds time) {
+            auto micros = static_cast<uint64_t>(time.count() / 1000);
+            size_t bucket = 0;
+            while (micros > 1 && bucket + 1 < BUCKETS) {
+                micros >>= 1;
+                bucket += 1;
+            }
+            counts[bucket] += 1;
+        }
+
+        void merge(const TileHistogram &other) {
+            for (size_t i = 0; i < BUCKETS; i++) counts[i] += other.counts[i];
+        }
+
+        [[nodiscard]] uint64_t total() const {
+            uint64_t sum = 0;
+            for (auto count: counts) sum += count;
+            return sum;
+        }
+    };
+
+    struct WorkerStats {
+        uint64_t tiles {0};
+        // Tiles taken from the queue of another worker.
+        uint64_t stolen {0};
+        // Time spent rendering tiles, as opposed to looking for them or waiting to start.
+        std::chrono::nanoseconds busy {0};
+        TileHistogram tileTimes;
+    };
+
+    struct RenderStats {
+
+        std::chrono::nanoseconds wall {0};
+        std::vector<WorkerStats> workers;
+
+        // The fraction of the render time worker `i` spent rendering.
+        [[nodiscard]] double utilization(size_t i) const {
+            if (wall.count() == 0) return 0;
+            return static_cast<double>(workers[i].busy.count()) / static_cast<double>(wall.count());
+        }
+
+        [[nodiscard]] TileHistogram tileTimes() const {
+            TileHistogram histogram;
+            for (const auto &worker: workers) histogram.merge(worker.tileTimes);
+            return histogram;
+        }
+    };
+
+    /***
+     * Renders a canvas tile by tile on several threads. Every worker starts with a contiguous run of
+     * tiles and takes them from the front; a worker that runs out steals the back half of the run of
+     * another worker. Runs are single atomic words, so scheduling takes no locks, and since tiles never
+     * share pixels neither does writing them.
+     */
+    class TileRenderer {
+
+        TileRendererOptions options;
+        std::unique_ptr<concurrency::ThreadPool> pool;
+
+        // The tiles [begin, end) left to a worker, packed as begin | end << 32. Padded to a cache line
+        // so that workers taking tiles do not slow each other down.
+        struct alignas(64) Run {
+            std::atomic<uint64_t> tiles {0};
+        };
+
+        static uint64_t pack(uint32_t begin, uint32_t end) {
+            return static_cast<uint64_t>(begin) | static_cast<uint64_t>(end) << 32;
+        }
+
+        static bool take(Run &run, uint32_t &tile) {
+            auto tiles = run.tiles.load(std::memory_order_relaxed);
+            while (true) {
+                auto begin = static_cast<uint32_t>(tiles), end = static_cast<uint32_t>(tiles >> 32);
+                if (begin >= end) return false;
+                if (run.tiles.compare_exchange_weak(tiles, pack(begin + 1, end), std::memory_order_relaxed)) {
+                    tile = begin;
+                    return true;
+                }
+            }
+        }
+
+        // Move the back half of `victim` to `thief` (which is empty) and take its first tile.
+        static bool steal(Run &victim, Run &thief, uint32_t &tile) {
+            auto tiles = victim.tiles.load(std::memory_order_relaxed);
+            while (true) {
+                auto begin = static_cast<uint32_t>(tiles), end = static_cast<uint32_t>(tiles >> 32);
+                if (begin >= end) return false;
+                auto middle = end - (end - begin + 1) / 2;
+                if (victim.tiles.compare_exchange_weak(tiles, pack(begin, middle), std::memory_order_relaxed)) {
+                    tile = middle;
+                    thief.tiles.store(pack(middle + 1, end), std::memory_order_relaxed);
+                    return true;
+                }
+            }
+        }
+
+    public:
+
+        explicit TileRenderer(const TileRendererOptions &options = {}) : options{options} {
+            if (this->options.tileSize == 0) {
+                throw std::runtime_error("Cannot create renderer. The tile size must be positive.");
+            }
+            if (this->options.threads == 0) {
+                this->options.threads = std::max(1u, std::thread::hardware_concurrency());
+            }
+            pool = std::make_unique<concurrency::ThreadPool>(this->options.threads - 1);
+        }
+
+        [[nodiscard]] uint32_t threads() const { return options.threads; }
+
+        [[nodiscard]] uint32_t tileSize() const { return options.tileSize; }
+
+        /***
+         * Write every pixel of `canvas` with `shade(x, y)`, which is called concurrently from every
+         * worker and must be thread-safe.
+         */
+        template<typename Storage, typename Layout, typename Fn>
+        RenderStats render(BasicCanvas<Storage, Layout> &canvas, Fn &&shade) {
+            checkLayout<Layout>();
+            return forEachTile(canvas.width, canvas.height, [&](const Tile &tile) {
+                fill(canvas, tile, shade);
+            });
+        }
+
+        /***
+         * Split a width x height image in tiles and call `renderTile(tile)` once for each of them,
+         * concurrently from every worker. This is the scheduler behind `render`, for render modes
+         * that do more per tile than writing a canvas. Each call runs in a `memory::TileScope` of the
+         * worker's arena, which is rewound after the tile. If a call throws, no more tiles are started
+         * and the first exception is rethrown once every worker has stopped.
+         */
+        template<typename Fn>
+        RenderStats forEachTile(uint32_t width, uint32_t height, Fn &&renderTile) {
+
+            using Clock = std::chrono::steady_clock;
+
+            const uint32_t size = options.tileSize;
+            const uint32_t tilesX = (width + size - 1) / size;
+            const uint32_t tilesY = (height + size - 1) / size;
+            const uint32_t tileCount = tilesX * tilesY;
+
+            auto tileAt = [&](uint32_t index) {
+                uint32_t x = index % tilesX * size, y = index / tilesX * size;
+                return Tile{x, y, std::min(size, width - x), std::min(size, height - y)};
+            };
+
+            const uint32_t workerCount = options.threads;
+            std::unique_ptr<Run[]> runs(new Run[workerCount]);
+            for (uint32_t i = 0; i < workerCount; i++) {
+                runs[i].tiles.store(pack(static_cast<uint32_t>(uint64_t(tileCount) * i / workerCount),
+                                         static_cast<uint32_t>(uint64_t(tileCount) * (i + 1) / workerCount)));
+            }
+
+            RenderStats stats;
+            stats.workers.resize(workerCount);
+            const auto start = Clock::now();
+
+            // Set when a tile throws, so that the other workers stop taking tiles.
+            std::atomic<bool> failed {false};
+
+            auto work = [&](uint32_t id) {
+                auto &worker = stats.workers[id];
+                uint32_t index = 0;
+                while (!failed.load(std::memory_order_relaxed)) {
+                    bool stolen = false;
+                    if (!take(runs[id], index)) {
+                        for (uint32_t i = 1; i < workerCount && !stolen; i++) {
+                            stolen = steal(runs[(id + i) % workerCount], runs[id], index);
+                        }
+                        if (!stolen) return;
+                    }
+
+                    const auto tileStart = Clock::now();
+                    {
+                        // What the tile allocates from the worker's arena is given back with it.
+                        memory::TileScope scope;
+                        try {
+                            renderTile(tileAt(index));
+                        } catch (...) {
+                            failed.store(true, std::memory_order_relaxed);
+                            throw;
+                        }
+                    }
+                    const auto time = Clock::now() - tileStart;
+
+                    worker.tiles += 1;
+                    worker.stolen += stolen;
+                    worker.busy += time;
+                    worker.tileTimes.add(time);
+                }
+            };
+
+            concurrency::TaskGroup group(*pool);
+            for (uint32_t id = 1; id < workerCount; id++) {
+                group.run([&work, id] { work(id); });
+            }
+            // The workers use `runs`, `stats` and `renderTile`: wait for them even if this thread's
+            // tiles throw, then rethrow the first exception.
+            std::exception_ptr error;
+            try {
+                work(0);
+            } catch (...) {
+                error = std::current_exception();
+            }
+            try {
+                group.wait();
+            } catch (...) {
+                if (!error) error = std::current_exception();
+            }
+            if (error) std::rethrow_exception(error);
+
+            stats.wall = Clock::now() - start;
+            return stats;
+        }
+
+        // Throw if render tiles would split the blocks of `Layout`.
+        template<typename Layout>
+        void checkLayout() const {
+            if (!Layout::ROW_MAJOR && options.tileSize % Layout::TILE_SIZE != 0) {
+                throw std::runtime_error("Cannot render canvas. The tile size must be a multiple of the layout tile size.");
+            }
+        }
+
+        // Write `shade(x, y)` to every pixel of `tile`, block by block for blocked layouts.
+        template<typename Storage, typename Layout, typename Fn>
+        static void fill(BasicCanvas<Storage, Layout> &canvas, const Tile &tile, Fn &shade) {
+            if constexpr (Layout::ROW_MAJOR) {
+                canvas.fillTile({tile.x, tile.y, tile.width, tile.height}, shade);
+            } else {
+                // Rows are only contiguous within a block.
+                for (uint32_t y = tile.y; y < tile.y + tile.height; y += Layout::TILE_SIZE) {
+                    for (uint32_t x = tile.x; x < tile.x + tile.width; x += Layout::TILE_SIZE) {
+                        canvas.fillTile({x, y, std::min(Layout::TILE_SIZE, tile.x + tile.width - x),
+                                         std::min(Layout::TILE_SIZE, tile.y + tile.height - y)}, shade);
+                    }
+                }
+            }
+        }
+    };
+}
+
+#endif //RAYTRACERCHALLENGE_TILE_RENDERER_HPP
@@ -0,0 +1,119 @@
+#ifndef RAYTRACERCHALLENGE_SCENE_HPP
+#define RAYTRACERCHALLENGE_SCENE_HPP
+
+#include <vector>
+#include <limits>
+#include <optional>
+#include <unordered_set>
+
+#include "ray.hpp"
+#include "material.hpp"
+#include "accel/bvh.hpp"
+#include "accel/occluder_cache.hpp"
+#include "shapes/instance.hpp"
+
+// The closest hit in a scene: the instance and where it is hit on its mesh.
+struct SceneHit {
+    MeshHit hit;
+    uint32_t instance {0};
+};
+
+/***
+ * Instances of shared meshes and the two-level hierarchy used to intersect them. Every mesh has
+ * its own bottom level hierarchy, in object space, built once; the top level one is built by
+ * `build()` over the world space bounds of the instances. A ray goes down the top level to the
+ * instances it may hit, then is transformed into each of their object spaces to go down the mesh
+ * hierarchy. Intersecting is read-only after `build()`.
+ */
+class Scene {
+
+    std::vector<Instance> items;
+    accel::BVH bvh;
+    bool built {true};
+
+public:
+
+    Scene() = default;
+
+    void add(const Instance &instance) {
+        items.push_back(instance);
+        built = false;
+    }
+
+    [[nodiscard]] const std::vector<Instance> &instances() const { return items; }
+
+    [[nodiscard]] const accel::BVH &hierarchy() const { return bvh; }
+
+    void build(const accel::BVHBuildOptions &options = {}) {
+        bvh = accel::BVH::build(instanceBounds(), options);
+        built = true;
+    }
+
+    // The same hierarchy, built using the threads of `pool` as well.
+    void build(const accel::BVHBuildOptions &options, concurrency::ThreadPool &pool) {
+        bvh = accel::BVH::build(instanceBounds(), options, pool);
+        built = true;
+    }
+
+    // The closest hit along the ray within [0, tMax], if any.
+    [[nodiscard]] std::optional<SceneHit> intersect(const Ray &ray,
+                                                    float tMax = std::numeric_limits<float>::infinity()) const {
+
+        requireBuilt();
+
+        std::optional<SceneHit> closest;
+        bvh.traverse(ray, tMax, [&](uint32_t index, float &t) {
+            if (auto hit = items[index].intersect(ray, t)) {
+                t = hit->t;
+                closest = SceneHit{*hit, index};
+            }
+            return false;
+        });
+        return closest;
+    }
+
+    // Bytes held by the instances, the top level hierarchy and every distinct mesh, counted once.
+    [[nodiscard]] size_t memoryUsage() const {
+        std::unordered_set<const Mesh *> meshes;
+        size_t bytes = sizeof(Instance) * items.capacity() +
+                       sizeof(accel::BVHNode) * bvh.nodeData().size() + sizeof(uint32_t) * bvh.primitives().size();
+        for (const auto &instance: items) {
+            if (meshes.insert(&instance.mesh()).second) bytes += instance.mesh().memoryUsage();
+        }
+        return bytes;
+    }
+
+    // The world space normal at a hit.
+    [[nodiscard]] Vector normalAt(const SceneHit &hit) const {
+        return items[hit.instance].normalAt(hit.hit);
+    }
+
+    /***
+     * Whether anything is hit along the ray within [0, tMax). Stops at the first hit found instead
+     * of searching for the closest one, which is all a shadow ray needs.
+     */
+    [[nodiscard]] bool occluded(const Ray &ray, float tMax) const {
+        requireBuilt();
+        return bvh.traverse(ray, tMax, [&](uint32_t index, float &) { return items[index].occluded(ray, tMax); });
+    }
+
+    // Whether something lies between `position` and `light` (see `accel::isShadowed`).
+    [[nodiscard]] bool isShadowed(const Point &position, const PointLight &light) const {
+        requireBuilt();
+        auto occludes = [&](uint32_t index, const Ray &ray) { return items[index].occluded(ray, 1); };
+        return accel::isShadowed(this, bvh, items.size(), position, light.position, occludes);
+    }
+
+private:
+
+    void requireBuilt() const { accel::requireBuilt(built, "scene"); }
+
+    [[nodiscard]] std::vector<accel::AABB> instanceBounds() const {
+        std::vector<accel::AABB> bounds;
+        bounds.reserve(items.size());
+        for (const auto &instance: items) bounds.push_back(instance.bounds());
+        return bounds;
+    }
+};
+
+#endif //RAYTRACERCHALLENGE_SCENE_HPP
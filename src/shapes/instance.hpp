@@ -0,0 +1,94 @@
+#ifndef RAYTRACERCHALLENGE_INSTANCE_HPP
+#define RAYTRACERCHALLENGE_INSTANCE_HPP
+
+#include <limits>
+#include <memory>
+#include <utility>
+#include <optional>
+#include <stdexcept>
+
+#include "mesh.hpp"
+#include "../math/transform.hpp"
+
+/***
+ * A copy of a mesh placed in the world by its own transformation. The mesh, with its hierarchy, is
+ * shared by every instance of it: an instance only adds a pointer and two matrices, so memory grows
+ * with the number of distinct meshes and not with the number of copies. Rays are moved to the
+ * object space of the mesh to be intersected.
+ */
+class Instance {
+
+    std::shared_ptr<const Mesh> geometry;
+    Matrix4 toWorld;
+    Matrix4 toObject;
+
+public:
+
+    Instance(std::shared_ptr<const Mesh> mesh, const transformation::Transform &transform) :
+            geometry{std::move(mesh)}, toWorld{transform.matrix()} {
+        const auto &inverse = transform.inverse();
+        if (!inverse) {
+            throw std::runtime_error("Cannot create instance. The transformation is not invertible.");
+        }
+        toObject = *inverse;
+        checkMesh();
+    }
+
+    explicit Instance(std::shared_ptr<const Mesh> mesh, const Matrix4 &matrix = Matrix4::identity()) :
+            geometry{std::move(mesh)}, toWorld{matrix} {
+        auto inverse = matrix.inverse();
+        if (!inverse) {
+            throw std::runtime_error("Cannot create instance. The transformation is not invertible.");
+        }
+        toObject = *inverse;
+        checkMesh();
+    }
+
+    [[nodiscard]] const Mesh &mesh() const { return *geometry; }
+
+    [[nodiscard]] const std::shared_ptr<const Mesh> &sharedMesh() const { return geometry; }
+
+    [[nodiscard]] const Matrix4 &matrix() const { return toWorld; }
+
+    [[nodiscard]] const Matrix4 &inverse() const { return toObject; }
+
+    // The world space bounds of the mesh. Only meaningful for affine transformations.
+    [[nodiscard]] accel::AABB bounds() const { return geometry->bounds().transform(toWorld); }
+
+    /***
+     * The closest hit of the world space `ray` within [0, tMax]. The ray is transformed, not
+     * normalized, so `t` is the same in object and world space.
+     */
+    [[nodiscard]] std::optional<MeshHit> intersect(const Ray &ray,
+                                                   float tMax = std::numeric_limits<float>::infinity()) const {
+        return geometry->intersect(ray.transform(toObject), tMax);
+    }
+
+    // Whether the world space `ray` hits the mesh within [0, tMax).
+    [[nodiscard]] bool occluded(const Ray &ray, float tMax) const {
+        return geometry->occluded(ray.transform(toObject), tMax);
+    }
+
+    // The world space normal at a hit, transformed by the inverse transpose of the matrix.
+    [[nodiscard]] Vector normalAt(const MeshHit &hit) const {
+        auto worldNormal = toObject.transpose() * geometry->normalAt(hit);
+        worldNormal.w = 0;
+        return worldNormal.normalize().value_or(worldNormal);
+    }
+
+private:
+
+    void checkMesh() const {
+        if (!geometry) {
+            throw std::runtime_error("Cannot create instance. The mesh is null.");
+        }
+        if (geometry->triangleCount() == 0) {
+            throw std::runtime_error("Cannot create instance. The mesh has no triangles.");
+        }
+        if (geometry->hierarchy().empty()) {
+            throw std::runtime_error("Cannot create instance. The mesh was not built.");
+        }
+    }
+};
+
+#endif //RAYTRACERCHALLENGE_INSTANCE_HPP
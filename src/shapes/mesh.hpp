@@ -0,0 +1,221 @@
+#ifndef RAYTRACERCHALLENGE_MESH_HPP
+#define RAYTRACERCHALLENGE_MESH_HPP
+
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+
+#include "../ray.hpp"
+#include "../accel/bvh.hpp"
+
+// Where a ray hits a mesh: the triangle and the barycentric coordinates of the point on it.
+struct MeshHit {
+    float t {0};
+    // Weights of the second and third vertex; the first one gets 1 - u - v.
+    float u {0};
+    float v {0};
+    uint32_t triangle {0};
+};
+
+/***
+ * An indexed triangle mesh. Positions and normals are stored once, as structure-of-arrays, and
+ * triangles refer to them by index, so vertices shared by several triangles are not repeated.
+ * Triangles added with normal indices have per-vertex normals, the others their geometric normal.
+ * After the triangles are added, `build()` computes the hierarchy used by `intersect()`.
+ */
+class Mesh {
+
+    std::vector<float> px, py, pz;
+    std::vector<float> nx, ny, nz;
+    // Three position indices per triangle, and three normal indices per triangle once any triangle has
+    // normals: `NO_NORMAL` for the triangles without.
+    std::vector<uint32_t> positionIndices;
+    std::vector<uint32_t> normalIndices;
+    accel::BVH bvh;
+
+public:
+
+    static constexpr uint32_t NO_NORMAL = UINT32_MAX;
+
+    Mesh() = default;
+
+    void reserve(size_t vertices, size_t normals, size_t triangles) {
+        px.reserve(vertices);
+        py.reserve(vertices);
+        pz.reserve(vertices);
+        nx.reserve(normals);
+        ny.reserve(normals);
+        nz.reserve(normals);
+        positionIndices.reserve(3 * triangles);
+        if (normals != 0) normalIndices.reserve(3 * triangles);
+    }
+
+    uint32_t addVertex(float x, float y, float z) {
+        px.push_back(x);
+        py.push_back(y);
+        pz.push_back(z);
+        return static_cast<uint32_t>(px.size() - 1);
+    }
+
+    uint32_t addVertex(const Point &p) { return addVertex(p.x, p.y, p.z); }
+
+    uint32_t addNormal(float x, float y, float z) {
+        nx.push_back(x);
+        ny.push_back(y);
+        nz.push_back(z);
+        return static_cast<uint32_t>(nx.size() - 1);
+    }
+
+    uint32_t addNormal(const Vector &n) { return addNormal(n.x, n.y, n.z); }
+
+    // A triangle of three vertices, with their geometric normal.
+    void addTriangle(uint32_t a, uint32_t b, uint32_t c) {
+        checkVertices(a, b, c);
+        positionIndices.insert(positionIndices.end(), {a, b, c});
+        if (!normalIndices.empty()) normalIndices.insert(normalIndices.end(), {NO_NORMAL, NO_NORMAL, NO_NORMAL});
+    }
+
+    // A triangle of three vertices, each with its own normal.
+    void addTriangle(uint32_t a, uint32_t b, uint32_t c, uint32_t na, uint32_t nb, uint32_t nc) {
+        checkVertices(a, b, c);
+        if (na >= nx.size() || nb >= nx.size() || nc >= nx.size()) {
+            throw std::runtime_error("Cannot add triangle. Normal index out of range.");
+        }
+        // The triangles added before the first one with normals keep their geometric normal.
+        normalIndices.resize(positionIndices.size(), NO_NORMAL);
+        positionIndices.insert(positionIndices.end(), {a, b, c});
+        normalIndices.insert(normalIndices.end(), {na, nb, nc});
+    }
+
+    [[nodiscard]] size_t vertexCount() const { return px.size(); }
+
+    [[nodiscard]] size_t normalCount() const { return nx.size(); }
+
+    [[nodiscard]] size_t triangleCount() const { return positionIndices.size() / 3; }
+
+    [[nodiscard]] bool hasNormals() const { return !normalIndices.empty(); }
+
+    [[nodiscard]] Point vertex(size_t i) const { return point(px[i], py[i], pz[i]); }
+
+    [[nodiscard]] Vector normal(size_t i) const { return vector(nx[i], ny[i], nz[i]); }
+
+    // The position index of corner `corner` (0, 1 or 2) of triangle `t`.
+    [[nodiscard]] uint32_t triangleVertex(size_t t, size_t corner) const { return positionIndices[3 * t + corner]; }
+
+    [[nodiscard]] accel::AABB triangleBounds(size_t t) const {
+        accel::AABB box;
+        for (size_t corner = 0; corner < 3; corner++) {
+            auto i = positionIndices[3 * t + corner];
+            box.extend({px[i], py[i], pz[i]});
+        }
+        return box;
+    }
+
+    [[nodiscard]] accel::AABB bounds() const { return bvh.empty() ? accel::AABB() : bvh.bounds(); }
+
+    [[nodiscard]] const accel::BVH &hierarchy() const { return bvh; }
+
+    // Bytes held by the vertex, normal and index arrays and by the hierarchy.
+    [[nodiscard]] size_t memoryUsage() const {
+        return sizeof(float) * (px.capacity() + py.capacity() + pz.capacity() + nx.capacity() + ny.capacity() + nz.capacity()) +
+               sizeof(uint32_t) * (positionIndices.capacity() + normalIndices.capacity()) +
+               sizeof(accel::BVHNode) * bvh.nodeData().size() + sizeof(uint32_t) * bvh.primitives().size();
+    }
+
+    void build(const accel::BVHBuildOptions &options = {}) {
+        std::vector<accel::AABB> boxes(triangleCount());
+        for (size_t t = 0; t < boxes.size(); t++) boxes[t] = triangleBounds(t);
+        bvh = accel::BVH::build(boxes, options);
+    }
+
+    /***
+     * Möller–Trumbore ray/triangle test: solves origin + t * direction = (1 - u - v) a + u b + v c
+     * with Cramer's rule, rejecting as soon as u or v leave the triangle. Rays parallel to the plane
+     * of the triangle miss it.
+     * @return The hit if it is in the triangle at 0 <= t <= tMax.
+     */
+    [[nodiscard]] std::optional<MeshHit> intersectTriangle(uint32_t triangle, const Ray &ray,
+                                                           float tMax = std::numeric_limits<float>::infinity()) const {
+
+        const auto ia = positionIndices[3 * triangle];
+        const auto ib = positionIndices[3 * triangle + 1];
+        const auto ic = positionIndices[3 * triangle + 2];
+
+        const float e1x = px[ib] - px[ia], e1y = py[ib] - py[ia], e1z = pz[ib] - pz[ia];
+        const float e2x = px[ic] - px[ia], e2y = py[ic] - py[ia], e2z = pz[ic] - pz[ia];
+        const float dx = ray.direction.x, dy = ray.direction.y, dz = ray.direction.z;
+
+        // p = direction x e2
+        const float pX = dy * e2z - dz * e2y, pY = dz * e2x - dx * e2z, pZ = dx * e2y - dy * e2x;
+        const float determinant = e1x * pX + e1y * pY + e1z * pZ;
+        if (!(std::abs(determinant) > 0)) return {};
+        const float inverse = 1 / determinant;
+
+        const float sx = ray.origin.x - px[ia], sy = ray.origin.y - py[ia], sz = ray.origin.z - pz[ia];
+        const float u = (sx * pX + sy * pY + sz * pZ) * inverse;
+        if (u < 0 || u > 1) return {};
+
+        // q = s x e1
+        const float qX = sy * e1z - sz * e1y, qY = sz * e1x - sx * e1z, qZ = sx * e1y - sy * e1x;
+        const float v = (dx * qX + dy * qY + dz * qZ) * inverse;
+        if (v < 0 || u + v > 1) return {};
+
+        const float t = (e2x * qX + e2y * qY + e2z * qZ) * inverse;
+        if (t < 0 || t > tMax) return {};
+        return MeshHit{t, u, v, triangle};
+    }
+
+    // The closest hit along the ray within [0, tMax]. The mesh must have been built.
+    [[nodiscard]] std::optional<MeshHit> intersect(const Ray &ray,
+                                                   float tMax = std::numeric_limits<float>::infinity()) const {
+        std::optional<MeshHit> closest;
+        bvh.traverse(ray, tMax, [&](uint32_t triangle, float &t) {
+            if (auto hit = intersectTriangle(triangle, ray, t)) {
+                t = hit->t;
+                closest = hit;
+            }
+            return false;
+        });
+        return closest;
+    }
+
+    // Whether any triangle is hit within [0, tMax); stops at the first one found. The mesh must have been built.
+    [[nodiscard]] bool occluded(const Ray &ray, float tMax) const {
+        return bvh.traverse(ray, tMax, [&](uint32_t triangle, float &t) {
+            auto hit = intersectTriangle(triangle, ray, t);
+            return hit && hit->t < t;
+        });
+    }
+
+    // The normal at a hit: interpolated from the vertex normals if the triangle has them, geometric otherwise.
+    [[nodiscard]] Vector normalAt(const MeshHit &hit) const {
+        const auto t = hit.triangle;
+        if (hasNormals() && normalIndices[3 * t] != NO_NORMAL) {
+            const float w = 1 - hit.u - hit.v;
+            const auto a = normalIndices[3 * t], b = normalIndices[3 * t + 1], c = normalIndices[3 * t + 2];
+            auto n = vector(w * nx[a] + hit.u * nx[b] + hit.v * nx[c],
+                            w * ny[a] + hit.u * ny[b] + hit.v * ny[c],
+                            w * nz[a] + hit.u * nz[b] + hit.v * nz[c]);
+            return n.normalize().value_or(n);
+        }
+        auto a = vertex(positionIndices[3 * t]);
+        auto e1 = vertex(positionIndices[3 * t + 1]) - a;
+        auto e2 = vertex(positionIndices[3 * t + 2]) - a;
+        // The book's (left-handed) convention: e2 x e1.
+        auto n = e2.cross(e1);
+        return n.normalize().value_or(n);
+    }
+
+private:
+
+    void checkVertices(uint32_t a, uint32_t b, uint32_t c) const {
+        if (a >= px.size() || b >= px.size() || c >= px.size()) {
+            throw std::runtime_error("Cannot add triangle. Vertex index out of range.");
+        }
+    }
+};
+
+#endif //RAYTRACERCHALLENGE_MESH_HPP
@@ -0,0 +1,149 @@
+#ifndef RAYTRACERCHALLENGE_SPHERE_HPP
+#define RAYTRACERCHALLENGE_SPHERE_HPP
+
+#include <cmath>
+
+#include "../ray.hpp"
+#include "../material.hpp"
+#include "../intersection.hpp"
+#include "../accel/aabb.hpp"
+#include "../math/transform.hpp"
+
+/***
+ * A unit sphere centered at the origin of its object space, placed in the world by `transformation`.
+ */
+class Sphere {
+
+    transformation::Transform transform;
+    Material surface;
+
+public:
+
+    Sphere() {
+        setTransformation(transformation::Transform());
+    }
+
+    explicit Sphere(const transformation::Transform &t, const Material &m = {}) : surface{m} {
+        setTransformation(t);
+    }
+
+    [[nodiscard]] const transformation::Transform &transformation() const { return transform; }
+
+    [[nodiscard]] const Material &material() const { return surface; }
+
+    void setMaterial(const Material &m) { surface = m; }
+
+    // The inverse matrices are computed here, so that intersecting is read-only and thread-safe.
+    void setTransformation(const transformation::Transform &t) {
+        transform = t;
+        (void) transform.inverseTranspose();
+    }
+
+    /***
+     * The points where `ray` enters and leaves the sphere, in increasing `t` order. A ray tangent
+     * to the sphere intersects it twice at the same `t`; a sphere with a singular transformation is
+     * never hit.
+     */
+    [[nodiscard]] Intersections<2> intersect(const Ray &ray) const {
+
+        Intersections<2> xs;
+
+        const auto &inverse = transform.inverse();
+        if (!inverse) return xs;
+
+        auto local = ray.transform(*inverse);
+
+        // The sphere is centered at the origin, so the vector from its center is the origin with w = 0.
+        auto sphereToRay = local.origin - point(0, 0, 0);
+        float a = local.direction.dot(local.direction);
+        float b = 2 * local.direction.dot(sphereToRay);
+        float c = sphereToRay.dot(sphereToRay) - 1;
+
+        float discriminant = b * b - 4 * a * c;
+        if (discriminant < 0) return xs;
+
+        float root = std::sqrt(discriminant);
+        xs.add({(-b - root) / (2 * a), this});
+        xs.add({(-b + root) / (2 * a), this});
+        return xs;
+    }
+
+    // Whether the ray hits the sphere at some 0 <= t < tMax. Cheaper than `intersect` for shadow rays.
+    [[nodiscard]] bool occludes(const Ray &ray, float tMax) const {
+
+        const auto &inverse = transform.inverse();
+        if (!inverse) return false;
+
+        auto local = ray.transform(*inverse);
+        auto sphereToRay = local.origin - point(0, 0, 0);
+        float a = local.direction.dot(local.direction);
+        float b = 2 * local.direction.dot(sphereToRay);
+        float c = sphereToRay.dot(sphereToRay) - 1;
+
+        float discriminant = b * b - 4 * a * c;
+        if (discriminant < 0) return false;
+
+        float root = std::sqrt(discriminant);
+        float t0 = (-b - root) / (2 * a);
+        float t1 = (-b + root) / (2 * a);
+        return (t0 >= 0 && t0 < tMax) || (t1 >= 0 && t1 < tMax);
+    }
+
+    /***
+     * Intersect the lanes of `rays` set in `active` with the sphere. Lanes that miss, or are not
+     * active, have their bit cleared in the result mask.
+     */
+    template<size_t N>
+    [[nodiscard]] IntersectionPacket<N> intersect(const RayPacket<N> &rays, const MaskxN<N> &active) const {
+
+        IntersectionPacket<N> result;
+
+        const auto &inverse = transform.inverse();
+        if (!inverse) return result;
+
+        auto local = rays.transform(*inverse);
+
+        auto sphereToRay = local.origin;
+        sphereToRay.w = FloatxN<N>{};
+
+        const auto zero = FloatxN<N>::broadcast(0);
+        auto a = local.direction.dot(local.direction);
+        auto b = local.direction.dot(sphereToRay) * FloatxN<N>::broadcast(2);
+        auto c = sphereToRay.dot(sphereToRay) - FloatxN<N>::broadcast(1);
+
+        auto discriminant = b * b - FloatxN<N>::broadcast(4) * a * c;
+        result.mask = active & ~discriminant.less(zero);
+
+        // Lanes that miss take the square root of 0 instead of a negative number.
+        auto root = select(result.mask, discriminant, zero).sqrt();
+        auto twoA = a * FloatxN<N>::broadcast(2);
+        result.t0 = (-b - root) / twoA;
+        result.t1 = (-b + root) / twoA;
+        return result;
+    }
+
+    // The world space bounds of the sphere. Only meaningful for affine transformations.
+    [[nodiscard]] accel::AABB bounds() const {
+        return accel::AABB::unit().transform(transform.matrix());
+    }
+
+    // The normal of the sphere at `worldPoint`, which must lie on its surface.
+    [[nodiscard]] Vector normalAt(const Point &worldPoint) const {
+        auto objectPoint = *transform.inverse() * worldPoint;
+        auto worldNormal = *transform.inverseTranspose() * (objectPoint - point(0, 0, 0));
+        worldNormal.w = 0;
+        return worldNormal.normalize().value();
+    }
+
+    // `normalAt` for every lane of `worldPoints`, with the packet kernels.
+    template<size_t N>
+    [[nodiscard]] Tuple4xN<N> normalAt(const Tuple4xN<N> &worldPoints) const {
+        auto objectNormal = *transform.inverse() * worldPoints;
+        objectNormal.w = FloatxN<N>{};
+        auto worldNormal = *transform.inverseTranspose() * objectNormal;
+        worldNormal.w = FloatxN<N>{};
+        return worldNormal.normalize();
+    }
+};
+
+#endif //RAYTRACERCHALLENGE_SPHERE_HPP
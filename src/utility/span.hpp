@@ -0,0 +1,58 @@
+#ifndef RAYTRACERCHALLENGE_SPAN_HPP
+#define RAYTRACERCHALLENGE_SPAN_HPP
+
+#include <array>
+#include <vector>
+#include <cstddef>
+#include <type_traits>
+
+/***
+ * A non-owning view over a contiguous sequence of `T`, a minimal stand-in for C++20 `std::span`.
+ * The viewed storage must outlive the span.
+ */
+template<typename T>
+class Span {
+
+    T *ptr {nullptr};
+    size_t length {0};
+
+public:
+
+    using element_type = T;
+    using value_type = std::remove_cv_t<T>;
+    using iterator = T *;
+
+    constexpr Span() = default;
+
+    constexpr Span(T *data, size_t size) : ptr{data}, length{size} {}
+
+    template<typename U, typename = std::enable_if_t<std::is_convertible_v<U (*)[], T (*)[]>>>
+    constexpr Span(const Span<U> &other) : ptr{other.data()}, length{other.size()} {}
+
+    template<typename Allocator>
+    Span(std::vector<value_type, Allocator> &vec) : ptr{vec.data()}, length{vec.size()} {}
+
+    template<typename Allocator, typename U = T, typename = std::enable_if_t<std::is_const_v<U>>>
+    Span(const std::vector<value_type, Allocator> &vec) : ptr{vec.data()}, length{vec.size()} {}
+
+    template<size_t N>
+    constexpr Span(std::array<value_type, N> &arr) : ptr{arr.data()}, length{N} {}
+
+    template<size_t N, typename U = T, typename = std::enable_if_t<std::is_const_v<U>>>
+    constexpr Span(const std::array<value_type, N> &arr) : ptr{arr.data()}, length{N} {}
+
+    [[nodiscard]] constexpr T *data() const { return ptr; }
+    [[nodiscard]] constexpr size_t size() const { return length; }
+    [[nodiscard]] constexpr bool empty() const { return length == 0; }
+
+    [[nodiscard]] constexpr iterator begin() const { return ptr; }
+    [[nodiscard]] constexpr iterator end() const { return ptr + length; }
+
+    constexpr T &operator[](size_t index) const { return ptr[index]; }
+
+    [[nodiscard]] constexpr Span<T> subspan(size_t offset, size_t count) const {
+        return {ptr + offset, count};
+    }
+};
+
+#endif //RAYTRACERCHALLENGE_SPAN_HPP
@@ -0,0 +1,135 @@
+#ifndef RAYTRACERCHALLENGE_WORLD_HPP
+#define RAYTRACERCHALLENGE_WORLD_HPP
+
+#include <array>
+#include <vector>
+#include <limits>
+#include <optional>
+
+#include "ray.hpp"
+#include "intersection.hpp"
+#include "shapes/sphere.hpp"
+#include "material.hpp"
+#include "accel/bvh.hpp"
+#include "accel/occluder_cache.hpp"
+
+// The closest hits of a packet of rays: `t` and the index of the object for the lanes set in `mask`.
+template<size_t N>
+struct PacketHit {
+    FloatxN<N> t;
+    std::array<uint32_t, N> object {};
+    MaskxN<N> mask;
+};
+
+/***
+ * The objects of a scene and the hierarchy used to intersect them. Objects are added first, then
+ * `build()` computes their world space bounds and the BVH; intersecting is read-only afterwards.
+ */
+class World {
+
+    std::vector<Sphere> spheres;
+    accel::BVH bvh;
+    bool built {true};
+
+public:
+
+    World() = default;
+
+    void add(const Sphere &sphere) {
+        spheres.push_back(sphere);
+        built = false;
+    }
+
+    [[nodiscard]] const std::vector<Sphere> &objects() const { return spheres; }
+
+    [[nodiscard]] const accel::BVH &hierarchy() const { return bvh; }
+
+    void build(const accel::BVHBuildOptions &options = {}) {
+        bvh = accel::BVH::build(objectBounds(), options);
+        built = true;
+    }
+
+    // The same hierarchy, built using the threads of `pool` as well.
+    void build(const accel::BVHBuildOptions &options, concurrency::ThreadPool &pool) {
+        bvh = accel::BVH::build(objectBounds(), options, pool);
+        built = true;
+    }
+
+    // The closest intersection in front of the ray's origin, if any.
+    [[nodiscard]] std::optional<Intersection> intersect(const Ray &ray) const {
+
+        requireBuilt();
+
+        std::optional<Intersection> closest;
+        bvh.traverse(ray, std::numeric_limits<float>::infinity(), [&](uint32_t index, float &tMax) {
+            if (auto hit = spheres[index].intersect(ray).hit(); hit && hit->t < tMax) {
+                tMax = hit->t;
+                closest = hit;
+            }
+            return false;
+        });
+        return closest;
+    }
+
+    // The closest intersections of the lanes of `rays` set in `active`, traced together.
+    template<size_t N>
+    [[nodiscard]] PacketHit<N> intersect(const RayPacket<N> &rays, const MaskxN<N> &active) const {
+
+        requireBuilt();
+
+        PacketHit<N> result;
+        result.t = FloatxN<N>::broadcast(std::numeric_limits<float>::infinity());
+        bvh.traverse(rays, active, result.t, [&](uint32_t index, const MaskxN<N> &lanes, FloatxN<N> &tMax) {
+            // A packet test costs several single ray tests: when few lanes are left, test them one by one.
+            if (lanes.count() <= N / 4) {
+                for (size_t i = 0; i < N; i++) {
+                    if (!lanes[i]) continue;
+                    if (auto hit = spheres[index].intersect(rays.lane(i)).hit(); hit && hit->t < tMax[i]) {
+                        tMax[i] = hit->t;
+                        result.object[i] = index;
+                    }
+                }
+                return;
+            }
+            // Lanes outside `lanes`, or without a hit in front of the ray, get an infinite `t`.
+            auto hits = spheres[index].intersect(rays, lanes).hit();
+            auto closer = hits.less(tMax);
+            if (closer.none()) return;
+            tMax = select(closer, hits, tMax);
+            for (size_t i = 0; i < N; i++) {
+                if (closer[i]) result.object[i] = index;
+            }
+        });
+        result.mask = result.t.less(FloatxN<N>::broadcast(std::numeric_limits<float>::infinity()));
+        return result;
+    }
+
+    /***
+     * Whether anything is hit along the ray within [0, tMax). Stops at the first hit found instead
+     * of searching for the closest one, which is all a shadow ray needs.
+     */
+    [[nodiscard]] bool occluded(const Ray &ray, float tMax) const {
+        requireBuilt();
+        return bvh.traverse(ray, tMax, [&](uint32_t index, float &) { return spheres[index].occludes(ray, tMax); });
+    }
+
+    // Whether something lies between `position` and `light` (see `accel::isShadowed`).
+    [[nodiscard]] bool isShadowed(const Point &position, const PointLight &light) const {
+        requireBuilt();
+        auto occludes = [&](uint32_t index, const Ray &ray) { return spheres[index].occludes(ray, 1); };
+        return accel::isShadowed(this, bvh, spheres.size(), position, light.position, occludes);
+    }
+
+private:
+
+    void requireBuilt() const { accel::requireBuilt(built, "world"); }
+
+    [[nodiscard]] std::vector<accel::AABB> objectBounds() const {
+        std::vector<accel::AABB> bounds;
+        bounds.reserve(spheres.size());
+        for (const auto &sphere: spheres) bounds.push_back(sphere.bounds());
+        return bounds;
+    }
+};
+
+#endif //RAYTRACERCHALLENGE_WORLD_HPP
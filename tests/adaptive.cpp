@@ -0,0 +1,164 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <set>
+#include <cmath>
+#include <vector>
+
+#include "render/adaptive.hpp"
+
+using namespace render;
+
+static constexpr uint32_t SIZE = 32;
+
+// A white disk on black, with edges that need anti-aliasing.
+static Tuple4 disk(float px, float py) {
+    float dx = px - 16.f, dy = py - 16.f;
+    return dx * dx + dy * dy < 100.f ? Colors::WHITE : Colors::BLACK;
+}
+
+// The coverage of every pixel, from a 64 x 64 grid of samples.
+static std::vector<float> reference() {
+    std::vector<float> coverage(SIZE * SIZE);
+    for (uint32_t y = 0; y < SIZE; y++) {
+        for (uint32_t x = 0; x < SIZE; x++) {
+            float sum = 0;
+            for (uint32_t j = 0; j < 64; j++) {
+                for (uint32_t i = 0; i < 64; i++) {
+                    sum += disk(static_cast<float>(x) + (static_cast<float>(i) + 0.5f) / 64.f,
+                                static_cast<float>(y) + (static_cast<float>(j) + 0.5f) / 64.f).x;
+                }
+            }
+            coverage[x + y * SIZE] = sum / 4096.f;
+        }
+    }
+    return coverage;
+}
+
+template<typename Fn>
+static float rootMeanSquareError(const std::vector<float> &expected, Fn &&actual) {
+    double sum = 0;
+    for (uint32_t y = 0; y < SIZE; y++) {
+        for (uint32_t x = 0; x < SIZE; x++) {
+            double error = actual(x, y) - expected[x + y * SIZE];
+            sum += error * error;
+        }
+    }
+    return static_cast<float>(std::sqrt(sum / (SIZE * SIZE)));
+}
+
+TEST_CASE("Low-discrepancy sequences") {
+
+    SUBCASE("The Sobol sequence starts with the expected points") {
+        CHECK((sobol(0) == std::array<float, 2>{0, 0}));
+        CHECK((sobol(1) == std::array<float, 2>{0.5f, 0.5f}));
+        CHECK((sobol(2) == std::array<float, 2>{0.25f, 0.75f}));
+        CHECK((sobol(3) == std::array<float, 2>{0.75f, 0.25f}));
+    }
+
+    SUBCASE("Scrambled Sobol points stay stratified") {
+        for (uint32_t scramble: {0u, pixelHash(3, 4), pixelHash(100, 7)}) {
+            for (uint32_t start: {0u, 16u, 48u}) {
+                // 16 points: one per cell of the 4x4, 2x8, 8x2, 1x16 and 16x1 grids.
+                for (uint32_t a = 0; a <= 4; a++) {
+                    std::set<std::pair<uint32_t, uint32_t>> cells;
+                    for (uint32_t i = start; i < start + 16; i++) {
+                        auto p = sobol(i, scramble);
+                        CHECK(p[0] >= 0);
+                        CHECK(p[0] < 1);
+                        CHECK(p[1] >= 0);
+                        CHECK(p[1] < 1);
+                        cells.insert({static_cast<uint32_t>(p[0] * static_cast<float>(1u << a)),
+                                      static_cast<uint32_t>(p[1] * static_cast<float>(1u << (4 - a)))});
+                    }
+                    CHECK(cells.size() == 16);
+                }
+            }
+        }
+    }
+
+    SUBCASE("R2 points are evenly spread") {
+        std::array<int, 16> cells {};
+        for (uint32_t i = 0; i < 256; i++) {
+            auto p = r2(i, pixelHash(5, 9));
+            REQUIRE(p[0] >= 0);
+            REQUIRE(p[0] < 1);
+            REQUIRE(p[1] >= 0);
+            REQUIRE(p[1] < 1);
+            cells[static_cast<size_t>(p[0] * 4) + 4 * static_cast<size_t>(p[1] * 4)] += 1;
+        }
+        for (auto count: cells) {
+            CHECK(count >= 13);
+            CHECK(count <= 19);
+        }
+    }
+
+    SUBCASE("Neighbouring pixels get different scrambles") {
+        CHECK(pixelHash(0, 0) != pixelHash(1, 0));
+        CHECK(pixelHash(1, 0) != pixelHash(0, 1));
+    }
+}
+
+TEST_CASE("AdaptiveSampler") {
+
+    SUBCASE("Flat images only get the base samples") {
+        Canvas canvas(SIZE, SIZE);
+        Accumulator accumulator(SIZE, SIZE);
+        AdaptiveSampler sampler({4, 64, 4}, {8, 2});
+        auto result = sampler.render(canvas, accumulator, [](float, float) { return color(0.3f, 0.6f, 0.2f); });
+        CHECK(result.rounds == 0);
+        CHECK(result.samples == 4 * SIZE * SIZE);
+        CHECK(canvas.pixelAt(5, 5) == Pixel(color(0.3f, 0.6f, 0.2f)));
+    }
+
+    SUBCASE("Samples go to the edges") {
+        Canvas canvas(SIZE, SIZE);
+        Accumulator accumulator(SIZE, SIZE);
+        AdaptiveSampler sampler({4, 64, 4}, {8, 2});
+        auto result = sampler.render(canvas, accumulator, disk);
+        CHECK(result.rounds > 0);
+        CHECK(accumulator.samples(16, 16) == 4);
+        CHECK(accumulator.samples(0, 0) == 4);
+        // (26, 16) lies on the edge of the disk.
+        CHECK(accumulator.samples(26, 16) > 16);
+    }
+
+    SUBCASE("Adaptive sampling matches 16 uniform samples with fewer samples") {
+        auto expected = reference();
+
+        for (auto sequence: {Sequence::SOBOL, Sequence::R2}) {
+            std::vector<float> uniform(SIZE * SIZE);
+            for (uint32_t y = 0; y < SIZE; y++) {
+                for (uint32_t x = 0; x < SIZE; x++) {
+                    float sum = 0;
+                    for (uint32_t s = 0; s < 16; s++) {
+                        auto uv = samplePoint(sequence, s, pixelHash(x, y));
+                        sum += disk(static_cast<float>(x) + uv[0], static_cast<float>(y) + uv[1]).x;
+                    }
+                    uniform[x + y * SIZE] = sum / 16;
+                }
+            }
+            auto uniformError = rootMeanSquareError(expected, [&](uint32_t x, uint32_t y) { return uniform[x + y * SIZE]; });
+
+            Canvas canvas(SIZE, SIZE);
+            Accumulator accumulator(SIZE, SIZE);
+            AdaptiveOptions options;
+            options.maxSamples = 16;
+            options.sequence = sequence;
+            AdaptiveSampler sampler(options, {8, 2});
+            auto result = sampler.render(canvas, accumulator, disk);
+
+            auto adaptiveError = rootMeanSquareError(expected, [&](uint32_t x, uint32_t y) {
+                return accumulator.average(x, y).x;
+            });
+            CHECK(adaptiveError <= uniformError);
+            CHECK(result.samples < 16 * SIZE * SIZE / 2);
+        }
+    }
+
+    SUBCASE("Invalid options are rejected") {
+        CHECK_THROWS(AdaptiveSampler({0, 64, 4}));
+        CHECK_THROWS(AdaptiveSampler({4, 64, 0}));
+        CHECK_THROWS(AdaptiveSampler({8, 4, 4}));
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef RAYTRACERCHALLENGE_TEST_ALLOCATION_COUNTER_HPP
+#define RAYTRACERCHALLENGE_TEST_ALLOCATION_COUNTER_HPP
+
+#include <new>
+#include <atomic>
+#include <cstdlib>
+#include <cstddef>
+
+/***
+ * Replaces the global `operator new` and `operator delete` with versions that count what they
+ * allocate, so tests can check what an operation allocates. The replacements are definitions:
+ * include this header in exactly one source file of a test executable.
+ */
+
+struct AllocationCounter {
+    // Calls to any form of `operator new`, and the bytes they requested.
+    std::atomic<size_t> calls {0};
+    std::atomic<size_t> bytes {0};
+};
+
+inline AllocationCounter allocations;
+
+// GCC sees `free` called on memory from `operator new` once the replacements below are inlined,
+// although they allocate with `malloc`.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void *operator new(size_t size) {
+    allocations.calls += 1;
+    allocations.bytes += size;
+    if (void *ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+// The aligned form too, which `std::pmr::new_delete_resource` uses.
+void *operator new(size_t size, std::align_val_t alignment) {
+    allocations.calls += 1;
+    allocations.bytes += size;
+    auto align = static_cast<size_t>(alignment);
+    if (void *ptr = std::aligned_alloc(align, (size + align - 1) / align * align)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, size_t) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete(void *ptr, size_t, std::align_val_t) noexcept { std::free(ptr); }
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif //RAYTRACERCHALLENGE_TEST_ALLOCATION_COUNTER_HPP
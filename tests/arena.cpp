@@ -0,0 +1,143 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <cstdint>
+#include <vector>
+#include <memory_resource>
+
+#include "memory/arena.hpp"
+#include "camera.hpp"
+#include "lighting.hpp"
+#include "render/stream.hpp"
+#include "render/tile_renderer.hpp"
+#include "allocation_counter.hpp"
+
+using namespace transformation;
+
+TEST_CASE("Arena") {
+
+    SUBCASE("Allocations are aligned and counted") {
+        memory::Arena arena(256);
+        auto *a = arena.allocate(3, 1);
+        auto *b = arena.allocate(8, 32);
+        auto *c = arena.allocate<double>(4);
+        CHECK(a != nullptr);
+        CHECK(reinterpret_cast<uintptr_t>(b) % 32 == 0);
+        CHECK(reinterpret_cast<uintptr_t>(c) % alignof(double) == 0);
+        CHECK(static_cast<std::byte *>(b) >= static_cast<std::byte *>(a) + 3);
+        CHECK(arena.stats().bytes >= 3 + 8 + 32);
+        CHECK(arena.stats().bytes == arena.bytesInUse());
+        CHECK(arena.stats().blocks == 1);
+    }
+
+    SUBCASE("Scopes give memory back and blocks are reused") {
+        memory::Arena arena(1024);
+        for (int frame = 0; frame < 3; frame++) {
+            memory::FrameScope frameScope(arena);
+            for (int tile = 0; tile < 4; tile++) {
+                memory::TileScope tileScope(arena);
+                // More than a block per tile, and a request larger than any block.
+                for (int i = 0; i < 10; i++) (void) arena.allocate(200);
+                (void) arena.allocate(4000);
+            }
+            CHECK(arena.bytesInUse() == 0);
+        }
+        CHECK(arena.stats().resets == 3);
+        CHECK(arena.stats().rewinds == 12);
+        // The first tile grew the arena; every later one fitted in the same blocks.
+        auto blocks = arena.stats().blocks;
+        {
+            memory::TileScope tileScope(arena);
+            for (int i = 0; i < 10; i++) (void) arena.allocate(200);
+            (void) arena.allocate(4000);
+        }
+        CHECK(arena.stats().blocks == blocks);
+        CHECK(arena.stats().peak < arena.stats().reserved + 1024);
+    }
+
+    SUBCASE("Rewinding keeps what was allocated before the marker") {
+        memory::Arena arena(128);
+        auto *kept = arena.allocate<int>(4);
+        for (int i = 0; i < 4; i++) kept[i] = i;
+        {
+            memory::TileScope scope(arena);
+            for (int i = 0; i < 50; i++) *arena.allocate<int>(1) = -1;
+        }
+        auto *next = arena.allocate<int>(1);
+        CHECK(next == kept + 4);
+        CHECK((kept[0] == 0 && kept[3] == 3));
+    }
+
+    SUBCASE("pmr containers allocate from the arena") {
+        memory::Arena arena;
+        std::pmr::vector<int> values(arena.resource());
+        auto before = allocations.calls.load();
+        for (int i = 0; i < 1000; i++) values.push_back(i);
+        CHECK(allocations.calls.load() == before);
+        CHECK(arena.stats().bytes >= 1000 * sizeof(int));
+        CHECK(values[999] == 999);
+        CHECK(arena.resource()->is_equal(*arena.resource()));
+        CHECK_FALSE(arena.resource()->is_equal(*std::pmr::new_delete_resource()));
+    }
+}
+
+TEST_CASE("The per-pixel loop never calls the global operator new") {
+
+    World world;
+    Material red;
+    red.color = color(1, 0.2f, 0.2f);
+    world.add(Sphere(Transform().translate(-1, 0, 0), red));
+    world.add(Sphere(Transform().scale(0.5f, 0.5f, 0.5f).translate(1.5f, -0.5f, 0)));
+    world.add(Sphere(Transform().scale(10, 0.1f, 10).translate(0, -1.1f, 0)));
+    world.build();
+    const PointLight light(point(-10, 10, -10), color(1, 1, 1));
+
+    const uint32_t width = 64, height = 48;
+    Camera camera(width, height, PI / 3, viewTransform(point(0, 1.5f, -5), point(0, 0, 0), vector(0, 1, 0)));
+    std::vector<Color> image(width * height, Colors::BLACK);
+
+    render::TileRenderer renderer({16, 1});
+    size_t inLoop = 0, shaded = 0;
+
+    for (int frame = 0; frame < 2; frame++) {
+        memory::FrameScope frameScope;
+        renderer.forEachTile(width, height, [&](const render::Tile &tile) {
+            auto before = allocations.calls.load();
+
+            auto *resource = memory::Arena::local().resource();
+            render::RayStream stream(resource);
+            stream.generate(tile, width, [&](uint32_t x, uint32_t y) { return camera.rayForPixel(x, y); });
+            std::pmr::vector<render::StreamHit> hits(resource);
+            render::trace<8>(world, stream, hits);
+
+            std::pmr::vector<HitRecord> records(resource);
+            std::pmr::vector<uint32_t> pixels(resource);
+            records.reserve(stream.size());
+            pixels.reserve(stream.size());
+            for (size_t i = 0; i < stream.size(); i++) {
+                if (hits[i].object == render::StreamHit::NONE) continue;
+                const auto &sphere = world.objects()[hits[i].object];
+                auto ray = stream.ray(i);
+                HitRecord record;
+                record.position = ray.position(hits[i].t);
+                record.eye = -ray.direction;
+                record.normal = sphere.normalAt(record.position);
+                record.material = &sphere.material();
+                record.inShadow = world.isShadowed(record.position + record.normal * EPSILON * 100, light);
+                records.push_back(record);
+                pixels.push_back(stream.id(i));
+            }
+            std::pmr::vector<Color> colors(records.size(), Colors::BLACK, resource);
+            shade<8>(records, light, colors);
+            for (size_t i = 0; i < colors.size(); i++) image[pixels[i]] = colors[i];
+
+            inLoop += allocations.calls.load() - before;
+            shaded += records.size();
+        });
+    }
+
+    CHECK(inLoop == 0);
+    CHECK(shaded > width * height / 4);
+    CHECK(memory::Arena::local().stats().resets >= 2);
+    CHECK(memory::Arena::local().bytesInUse() == 0);
+}
@@ -0,0 +1,244 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <random>
+#include <cstring>
+#include <algorithm>
+#include <vector>
+#include <limits>
+
+#include "world.hpp"
+#include "random_scene.hpp"
+
+using namespace accel;
+using namespace transformation;
+
+static std::optional<Intersection> bruteForce(const std::vector<Sphere> &spheres, const Ray &ray) {
+    std::optional<Intersection> closest;
+    for (const auto &sphere: spheres) {
+        if (auto hit = sphere.intersect(ray).hit(); hit && (!closest || hit->t < closest->t)) closest = hit;
+    }
+    return closest;
+}
+
+TEST_CASE("AABB") {
+
+    SUBCASE("A default box is empty and extending it gives the bounds of what was added") {
+        AABB box;
+        CHECK(box.empty());
+        CHECK(box.halfArea() == 0);
+        box.extend({1, 2, 3});
+        box.extend({-1, 0, 5});
+        CHECK_FALSE(box.empty());
+        CHECK((box.lower == std::array<float, 3>{-1, 0, 3}));
+        CHECK((box.upper == std::array<float, 3>{1, 2, 5}));
+        CHECK((box.centroid() == std::array<float, 3>{0, 1, 4}));
+        CHECK(box.longestAxis() == 0);
+        CHECK(box.halfArea() == 2 * 2 + 2 * 2 + 2 * 2);
+    }
+
+    SUBCASE("Transforming a box bounds its transformed corners") {
+        auto m = Transform().scale(2, 1, 1).rotateZ(PI / 4).translate(5, 0, 0).matrix();
+        auto box = AABB::unit().transform(m);
+        for (float x: {-1.f, 1.f}) {
+            for (float y: {-1.f, 1.f}) {
+                for (float z: {-1.f, 1.f}) {
+                    auto p = m * point(x, y, z);
+                    CHECK(p.x >= box.lower[0] - EPSILON);
+                    CHECK(p.x <= box.upper[0] + EPSILON);
+                    CHECK(p.y >= box.lower[1] - EPSILON);
+                    CHECK(p.y <= box.upper[1] + EPSILON);
+                    CHECK(p.z >= box.lower[2] - EPSILON);
+                    CHECK(p.z <= box.upper[2] + EPSILON);
+                }
+            }
+        }
+        CHECK(compareFloat(box.lower[0], 5 - 3 / SQR_TWO));
+        CHECK(compareFloat(box.upper[1], 3 / SQR_TWO));
+    }
+
+    SUBCASE("A ray enters a box where it crosses its first face") {
+        AABB box{{-1, -1, -1}, {1, 1, 1}};
+        RayBoxQuery query(Ray(point(0, 0, -5), vector(0, 0, 1)));
+        CHECK(query.enter(box, 100) == 4);
+        CHECK(query.enter(box, 3) == std::numeric_limits<float>::infinity());
+    }
+
+    SUBCASE("A ray starting inside a box enters it at 0") {
+        RayBoxQuery query(Ray(point(0, 0, 0), vector(1, 0, 0)));
+        CHECK(query.enter(AABB::unit(), 100) == 0);
+    }
+
+    SUBCASE("Axis-parallel rays miss boxes beside them") {
+        RayBoxQuery query(Ray(point(2, 0, -5), vector(0, 0, 1)));
+        CHECK(query.enter(AABB::unit(), 100) == std::numeric_limits<float>::infinity());
+        RayBoxQuery behind(Ray(point(0, 0, 5), vector(0, 0, 1)));
+        CHECK(behind.enter(AABB::unit(), 100) == std::numeric_limits<float>::infinity());
+    }
+}
+
+TEST_CASE("BVH") {
+
+    auto spheres = randomSpheres(1000, 7, 50, 0.2f, 2.f);
+    std::vector<AABB> bounds;
+    for (const auto &sphere: spheres) bounds.push_back(sphere.bounds());
+
+    SUBCASE("Nodes are 32 bytes") {
+        CHECK(sizeof(BVHNode) == 32);
+        CHECK(alignof(BVHNode) == 32);
+    }
+
+    SUBCASE("An empty BVH has no nodes and is never hit") {
+        auto bvh = BVH::build(Span<const AABB>());
+        CHECK(bvh.empty());
+        CHECK_FALSE(bvh.traverse(Ray(point(0, 0, 0), vector(0, 0, 1)), 100, [](uint32_t, float &) { return true; }));
+    }
+
+    SUBCASE("Invalid options are rejected") {
+        CHECK_THROWS(BVH::build(bounds, BVHBuildOptions{0, 16}));
+        CHECK_THROWS(BVH::build(bounds, BVHBuildOptions{4, 1}));
+        CHECK_THROWS(BVH::build(bounds, BVHBuildOptions{4, 65}));
+        CHECK_THROWS(BVH::build(bounds, BVHBuildOptions{4, 16, 1, 0}));
+    }
+
+    SUBCASE("Every primitive is in exactly one leaf and nodes contain their children") {
+        BVHBuildOptions options;
+        auto bvh = BVH::build(bounds, options);
+        auto nodes = bvh.nodeData();
+
+        std::vector<int> seen(bounds.size());
+        auto box = [](const BVHNode &node) {
+            return AABB{{node.lower[0], node.lower[1], node.lower[2]}, {node.upper[0], node.upper[1], node.upper[2]}};
+        };
+
+        for (size_t i = 0; i < nodes.size(); i++) {
+            const auto &node = nodes[i];
+            if (node.isLeaf()) {
+                CHECK(node.count <= options.maxLeafSize);
+                for (uint32_t j = node.offset; j < node.offset + node.count; j++) {
+                    auto primitive = bvh.primitives()[j];
+                    seen[primitive] += 1;
+                    CHECK(box(node).contains(bounds[primitive]));
+                }
+            } else {
+                REQUIRE(node.offset > i + 1);
+                REQUIRE(node.offset < nodes.size());
+                CHECK(box(node).contains(box(nodes[i + 1])));
+                CHECK(box(node).contains(box(nodes[node.offset])));
+            }
+        }
+        for (auto count: seen) CHECK(count == 1);
+    }
+
+    SUBCASE("A higher traversal cost gives fewer, larger leaves") {
+        auto leaves = [&](float traversalCost) {
+            BVHBuildOptions options;
+            options.maxLeafSize = 16;
+            options.traversalCost = traversalCost;
+            auto bvh = BVH::build(bounds, options);
+            size_t count = 0;
+            for (const auto &node: bvh.nodeData()) {
+                if (node.isLeaf()) {
+                    CHECK(node.count <= options.maxLeafSize);
+                    count++;
+                }
+            }
+            return count;
+        };
+        auto cheap = leaves(0.1f), costly = leaves(8.f);
+        CHECK(costly < cheap);
+        // Leaves hold every primitive, so fewer leaves are larger on average.
+        CHECK(costly * 2 < cheap);
+    }
+
+    SUBCASE("Only the leaves along the ray are visited") {
+        auto bvh = BVH::build(bounds);
+        size_t visited = 0;
+        auto count = [&](uint32_t, float &) {
+            visited += 1;
+            return false;
+        };
+        bvh.traverse(Ray(point(0, 200, 0), vector(1, 0, 0)), std::numeric_limits<float>::infinity(), count);
+        CHECK(visited == 0);
+        // Through the center of a primitive, so that at least its leaf is visited.
+        auto center = bounds[0].centroid();
+        bvh.traverse(Ray(point(-60, center[1], center[2]), vector(1, 0, 0)), std::numeric_limits<float>::infinity(),
+                     count);
+        CHECK(visited > 0);
+        CHECK(visited < bounds.size() / 4);
+    }
+
+    SUBCASE("Returning true stops the traversal") {
+        auto bvh = BVH::build(bounds);
+        size_t visited = 0;
+        auto center = bounds[0].centroid();
+        CHECK(bvh.traverse(Ray(point(-60, center[1], center[2]), vector(1, 0, 0)), 1000, [&](uint32_t, float &) {
+            visited += 1;
+            return true;
+        }));
+        CHECK(visited == 1);
+    }
+
+    SUBCASE("Identical primitives are split at the median") {
+        std::vector<AABB> same(100, AABB::unit());
+        auto bvh = BVH::build(same, {1, 16});
+        size_t leaves = 0;
+        for (const auto &node: bvh.nodeData()) leaves += node.isLeaf();
+        CHECK(leaves == 100);
+    }
+
+    SUBCASE("Building on a thread pool gives the same hierarchy, bit for bit") {
+        auto many = randomSpheres(20000, 3, 50, 0.2f, 2.f);
+        std::vector<AABB> manyBounds;
+        for (const auto &sphere: many) manyBounds.push_back(sphere.bounds());
+
+        BVHBuildOptions options;
+        options.taskSize = 256;
+        auto serial = BVH::build(manyBounds, options);
+
+        for (size_t threads: {0, 1, 4}) {
+            concurrency::ThreadPool pool(threads);
+            auto parallel = BVH::build(manyBounds, options, pool);
+            REQUIRE(parallel.nodeData().size() == serial.nodeData().size());
+            CHECK(std::memcmp(parallel.nodeData().data(), serial.nodeData().data(),
+                              serial.nodeData().size() * sizeof(BVHNode)) == 0);
+            CHECK(std::equal(parallel.primitives().begin(), parallel.primitives().end(), serial.primitives().begin()));
+        }
+    }
+
+    SUBCASE("The closest hits are the ones found by testing every primitive") {
+        World world;
+        for (const auto &sphere: spheres) world.add(sphere);
+        world.build();
+
+        std::mt19937 rng(11);
+        std::uniform_real_distribution<float> coordinate(-60, 60);
+        size_t hits = 0;
+        for (size_t i = 0; i < 2000; i++) {
+            auto origin = point(coordinate(rng), coordinate(rng), coordinate(rng));
+            auto target = point(coordinate(rng), coordinate(rng), coordinate(rng));
+            Ray ray(origin, target - origin);
+
+            auto expected = bruteForce(world.objects(), ray);
+            auto actual = world.intersect(ray);
+            REQUIRE(expected.has_value() == actual.has_value());
+            if (expected) {
+                hits += 1;
+                CHECK(actual->t == expected->t);
+                CHECK(actual->object == expected->object);
+            }
+        }
+        CHECK(hits > 100);
+    }
+
+    SUBCASE("A world must be built after objects are added") {
+        World world;
+        world.add(Sphere());
+        CHECK_THROWS(world.intersect(Ray(point(0, 0, -5), vector(0, 0, 1))));
+        world.build();
+        auto hit = world.intersect(Ray(point(0, 0, -5), vector(0, 0, 1)));
+        REQUIRE(hit.has_value());
+        CHECK(hit->t == 4);
+        CHECK(hit->object == &world.objects()[0]);
+    }
+}
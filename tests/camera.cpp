@@ -0,0 +1,115 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "camera.hpp"
+#include "math/transformation.hpp"
+
+using namespace transformation;
+
+static bool near(const Matrix4 &a, const Matrix4 &b, float tolerance) {
+    for (size_t i = 0; i < Matrix4::SIZE; i++) {
+        for (size_t j = 0; j < Matrix4::SIZE; j++) {
+            if (std::fabs(a.at(i, j) - b.at(i, j)) > tolerance) return false;
+        }
+    }
+    return true;
+}
+
+TEST_CASE("The view transformation") {
+
+    SUBCASE("The transformation matrix for the default orientation") {
+        CHECK(viewTransform(point(0, 0, 0), point(0, 0, -1), vector(0, 1, 0)) == Matrix4::identity());
+    }
+
+    SUBCASE("A view transformation matrix looking in positive z direction") {
+        CHECK(viewTransform(point(0, 0, 0), point(0, 0, 1), vector(0, 1, 0)) == scale(-1, 1, -1));
+    }
+
+    SUBCASE("The view transformation moves the world") {
+        CHECK(viewTransform(point(0, 0, 8), point(0, 0, 0), vector(0, 1, 0)) == translation(0, 0, -8));
+    }
+
+    SUBCASE("An arbitrary view transformation") {
+        Matrix4 expected = {
+                {-0.50709f, 0.50709f, 0.67612f,  -2.36643f},
+                {0.76772f,  0.60609f, 0.12122f,  -2.82843f},
+                {-0.35857f, 0.59761f, -0.71714f, 0},
+                {0,         0,        0,         1}
+        };
+        CHECK(near(viewTransform(point(1, 3, 2), point(4, -2, 8), vector(1, 1, 0)), expected, 1e-4f));
+    }
+
+    SUBCASE("A degenerate view is rejected") {
+        CHECK_THROWS(viewTransform(point(1, 1, 1), point(1, 1, 1), vector(0, 1, 0)));
+        CHECK_THROWS(viewTransform(point(0, 0, 0), point(0, 5, 0), vector(0, 1, 0)));
+    }
+}
+
+TEST_CASE("Cameras") {
+
+    SUBCASE("Constructing a camera") {
+        Camera camera(160, 120, PI / 2);
+        CHECK(camera.hsize() == 160);
+        CHECK(camera.vsize() == 120);
+        CHECK(camera.fieldOfView() == PI / 2);
+        CHECK(camera.transform() == Matrix4::identity());
+    }
+
+    SUBCASE("The pixel size for a horizontal canvas") {
+        CHECK(compareFloat(Camera(200, 125, PI / 2).pixelSize(), 0.01f));
+    }
+
+    SUBCASE("The pixel size for a vertical canvas") {
+        CHECK(compareFloat(Camera(125, 200, PI / 2).pixelSize(), 0.01f));
+    }
+
+    SUBCASE("Constructing a ray through the center of the canvas") {
+        auto ray = Camera(201, 101, PI / 2).rayForPixel(100, 50);
+        CHECK(ray.origin == point(0, 0, 0));
+        CHECK(ray.direction == vector(0, 0, -1));
+    }
+
+    SUBCASE("Constructing a ray through a corner of the canvas") {
+        auto ray = Camera(201, 101, PI / 2).rayForPixel(0, 0);
+        CHECK(ray.origin == point(0, 0, 0));
+        CHECK(ray.direction == vector(0.66519f, 0.33259f, -0.66851f));
+    }
+
+    SUBCASE("Constructing a ray when the camera is transformed") {
+        Camera camera(201, 101, PI / 2, rotationY(PI / 4) * translation(0, -2, 5));
+        auto ray = camera.rayForPixel(100, 50);
+        CHECK(ray.origin == point(0, 2, -5));
+        CHECK(ray.direction == vector(SQR_TWO / 2, 0, -SQR_TWO / 2));
+    }
+
+    SUBCASE("Stepped rays match rays through the inverse transformation") {
+        Camera camera(640, 360, PI / 3, viewTransform(point(3, 4, -9), point(0, 1, 0), vector(0, 1, 0)));
+        auto inverse = camera.inverse();
+        auto half = std::tan(PI / 6);
+        auto eye = inverse * point(0, 0, 0);
+
+        std::vector<Ray> row(640);
+        camera.row(0, 359, row);
+        size_t visited = 0;
+        camera.forEachRay(0, 0, 640, 360, [&](uint32_t px, uint32_t py, const Ray &ray) {
+            // The pixel center computed the textbook way, through the inverse at every pixel.
+            auto target = inverse * point(half - (px + 0.5f) * camera.pixelSize(),
+                                          half * 360 / 640 - (py + 0.5f) * camera.pixelSize(), -1);
+            auto expected = (target - eye).normalize().value();
+            CHECK(ray.origin == eye);
+            CHECK(ray.direction == expected);
+            if (py == 359) CHECK(row[px].direction == ray.direction);
+            visited++;
+        });
+        CHECK(visited == 640 * 360);
+    }
+
+    SUBCASE("Invalid cameras are rejected") {
+        CHECK_THROWS(Camera(0, 100, PI / 2));
+        CHECK_THROWS(Camera(100, 100, 0));
+        CHECK_THROWS(Camera(100, 100, PI / 2, scale(0, 1, 1)));
+    }
+}
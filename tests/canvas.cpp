@@ -1,9 +1,17 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include <doctest/doctest.h>
 
+#include <algorithm>
 #include <sstream>
 
 #include "canvas.hpp"
+#include "allocation_counter.hpp"
+
+// A stream discarding everything written to it, so that the stream itself never allocates.
+struct NullBuffer : std::streambuf {
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char *, std::streamsize n) override { return n; }
+};
 
 
 TEST_CASE("Canvas") {
@@ -32,5 +40,153 @@ TEST_CASE("Canvas") {
 
         CHECK_EQ(canvasPPMStr, "P3\n5 3\n255");
     }
-}
 
+    SUBCASE("Writing a canvas as PPM does not copy its pixels") {
+        Canvas canvas(1024, 1024);
+        const size_t pixelCount = canvas.width * canvas.height;
+
+        NullBuffer nullBuffer;
+        std::ostream nullStream(&nullBuffer);
+
+        for (auto magic: {io::PPMIdentifier::COLORMAP, io::PPMIdentifier::COLORMAP_BINARY}) {
+            auto before = allocations.bytes.load();
+            io::PPM canvasPPM = canvas.ppm(magic);
+            CHECK_EQ(allocations.bytes.load() - before, 0);
+
+            nullStream << canvasPPM;
+            CHECK_LT(allocations.bytes.load() - before, pixelCount);
+        }
+    }
+
+    SUBCASE("Compact pixel storages keep the canvas accessors") {
+        BasicCanvas<storage::RGB32F> rgb32f(10, 20);
+        BasicCanvas<storage::RGB16F> rgb16f(10, 20);
+        BasicCanvas<storage::RGBA8> rgba8(10, 20);
+
+        auto c = color(0.25, 0.5, 1);
+        rgb32f.writePixelAt(2, 3, Pixel(c));
+        rgb16f.writePixelAt(2, 3, Pixel(c));
+        rgba8.writePixelAt(2, 3, Pixel(c));
+
+        CHECK_EQ(rgb32f.pixelAt(2, 3).color, c);
+        CHECK_EQ(rgb16f.pixelAt(2, 3).color, c);
+        CHECK_EQ(rgb32f.pixelAt(0, 0).color, Colors::BLACK);
+        CHECK_EQ(rgba8.pixelAt(0, 0).color, Colors::BLACK);
+
+        auto c8 = rgba8.pixelAt(2, 3).color;
+        CHECK_EQ(c8.x, 64.f / 255.f);
+        CHECK_EQ(c8.y, 128.f / 255.f);
+        CHECK_EQ(c8.z, 1.f);
+    }
+
+    SUBCASE("Converting floats from and to half floats") {
+        for (float value: {0.f, -0.f, 1.f, -2.f, 0.5f, 0.333251953125f, 65504.f, 6.103515625e-05f, 5.960464477539063e-08f}) {
+            CHECK_EQ(storage::halfToFloat(storage::floatToHalf(value)), value);
+        }
+        CHECK_EQ(storage::floatToHalf(1.f), 0x3c00);
+        CHECK_EQ(storage::floatToHalf(1e6f), 0x7c00);
+        CHECK_EQ(storage::floatToHalf(1e-9f), 0x0000);
+        // 1 + 2^-11 is halfway between 1 and the next half, ties round to even
+        CHECK_EQ(storage::floatToHalf(1.00048828125f), 0x3c00);
+        CHECK_EQ(storage::floatToHalf(1.00146484375f), 0x3c02);
+    }
+
+    SUBCASE("Every pixel storage encodes the same PPM") {
+        Canvas canvas(4, 3);
+        BasicCanvas<storage::RGB32F> rgb32f(4, 3);
+        BasicCanvas<storage::RGB16F> rgb16f(4, 3);
+        BasicCanvas<storage::RGBA8> rgba8(4, 3);
+
+        for (size_t y = 0; y < canvas.height; y++) {
+            for (size_t x = 0; x < canvas.width; x++) {
+                Pixel pixel(color(x / 4.f, y / 3.f, 2.f));
+                canvas.writePixelAt(x, y, pixel);
+                rgb32f.writePixelAt(x, y, pixel);
+                rgb16f.writePixelAt(x, y, pixel);
+                rgba8.writePixelAt(x, y, pixel);
+            }
+        }
+
+        for (auto magic: {io::PPMIdentifier::COLORMAP, io::PPMIdentifier::COLORMAP_BINARY}) {
+            std::stringstream expected{}, fromRGB32F{}, fromRGB16F{}, fromRGBA8{};
+            expected << canvas.ppm(magic);
+            fromRGB32F << rgb32f.ppm(magic);
+            fromRGB16F << rgb16f.ppm(magic);
+            fromRGBA8 << rgba8.ppm(magic);
+
+            CHECK_EQ(fromRGB32F.str(), expected.str());
+            CHECK_EQ(fromRGB16F.str(), expected.str());
+            CHECK_EQ(fromRGBA8.str(), expected.str());
+        }
+    }
+
+    SUBCASE("Tiled layouts keep the canvas accessors") {
+        // Not a multiple of the tile size, so edge tiles are padded.
+        Canvas rowMajor(37, 21);
+        BasicCanvas<storage::RGBA32F, layout::Tiled<8>> tiled(37, 21);
+        BasicCanvas<storage::RGBA8, layout::MortonTiled<16>> morton(37, 21);
+
+        for (size_t y = 0; y < rowMajor.height; y++) {
+            for (size_t x = 0; x < rowMajor.width; x++) {
+                Pixel pixel(color(x / 37.f, y / 21.f, 1.f));
+                rowMajor.writePixelAt(x, y, pixel);
+                tiled.writePixelAt(x, y, pixel);
+                morton.writePixelAt(x, y, pixel);
+            }
+        }
+
+        bool samePixels = true;
+        for (size_t y = 0; y < rowMajor.height; y++) {
+            for (size_t x = 0; x < rowMajor.width; x++) {
+                samePixels = samePixels && tiled.pixelAt(x, y) == rowMajor.pixelAt(x, y);
+            }
+        }
+        CHECK(samePixels);
+
+        for (auto magic: {io::PPMIdentifier::COLORMAP, io::PPMIdentifier::COLORMAP_BINARY}) {
+            std::stringstream expected{}, fromTiled{}, fromMorton{};
+            expected << rowMajor.ppm(magic);
+            fromTiled << tiled.ppm(magic);
+            fromMorton << morton.ppm(magic);
+
+            CHECK_EQ(fromTiled.str(), expected.str());
+            CHECK_EQ(fromMorton.str(), expected.str());
+        }
+    }
+
+    SUBCASE("Iterating the tiles of a canvas covers every pixel once") {
+        BasicCanvas<storage::RGBA32F, layout::Tiled<8>> canvas(20, 10);
+        CHECK_EQ(canvas.tileCount(), 6);
+
+        std::vector<int> covered(canvas.width * canvas.height, 0);
+        canvas.forEachTile([&](auto tile) {
+            for (size_t y = tile.y; y < tile.y + tile.height; y++) {
+                for (size_t x = tile.x; x < tile.x + tile.width; x++) {
+                    covered[x + y * canvas.width] += 1;
+                }
+            }
+        });
+        CHECK(std::all_of(covered.begin(), covered.end(), [](int count) { return count == 1; }));
+
+        auto lastTile = canvas.tile(5);
+        CHECK_EQ(lastTile.x, 16);
+        CHECK_EQ(lastTile.y, 8);
+        CHECK_EQ(lastTile.width, 4);
+        CHECK_EQ(lastTile.height, 2);
+    }
+
+    SUBCASE("The storage of a tile is contiguous") {
+        BasicCanvas<storage::RGBA32F, layout::Tiled<8>> canvas(20, 10);
+
+        auto tile = canvas.tile(4);
+        auto tileData = canvas.tileData(4);
+        CHECK_EQ(tileData.size(), 64);
+        for (auto &value: tileData) {
+            value = storage::RGBA32F::encode(Pixel(Colors::GREEN));
+        }
+
+        CHECK_EQ(canvas.pixelAt(tile.x, tile.y).color, Colors::GREEN);
+        CHECK_EQ(canvas.pixelAt(tile.x + tile.width - 1, tile.y + tile.height - 1).color, Colors::GREEN);
+        CHECK_EQ(canvas.pixelAt(tile.x - 1, tile.y).color, Colors::BLACK);
+    }
+}
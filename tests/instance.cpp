@@ -0,0 +1,115 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <cmath>
+#include <memory>
+#include <random>
+
+#include "scene.hpp"
+#include "random_scene.hpp"
+
+using namespace transformation;
+
+// The book's triangle, shared by the instances of a test.
+static std::shared_ptr<const Mesh> sharedTriangle() { return std::make_shared<const Mesh>(bookTriangle()); }
+
+// A closed tetrahedron, so that rays from any side hit it.
+static std::shared_ptr<const Mesh> tetrahedron() {
+    auto mesh = std::make_shared<Mesh>();
+    mesh->addVertex(point(1, 1, 1));
+    mesh->addVertex(point(-1, -1, 1));
+    mesh->addVertex(point(-1, 1, -1));
+    mesh->addVertex(point(1, -1, -1));
+    mesh->addTriangle(0, 1, 2);
+    mesh->addTriangle(0, 3, 1);
+    mesh->addTriangle(0, 2, 3);
+    mesh->addTriangle(1, 3, 2);
+    mesh->build();
+    return mesh;
+}
+
+TEST_CASE("Instance") {
+
+    SUBCASE("A translated instance is hit where it was moved, at the same t") {
+        Instance instance(sharedTriangle(), Transform().translate(5, 0, 0));
+        CHECK_FALSE(instance.intersect(Ray(point(0, 0.5f, -2), vector(0, 0, 1))));
+        auto hit = instance.intersect(Ray(point(5, 0.5f, -2), vector(0, 0, 1)));
+        REQUIRE(hit);
+        CHECK(std::abs(hit->t - 2) < EPSILON);
+    }
+
+    SUBCASE("A scaled instance keeps t in world units of the ray") {
+        Instance instance(sharedTriangle(), Transform().scale(2, 2, 2).translate(0, 0, 4));
+        auto hit = instance.intersect(Ray(point(0, 1, -2), vector(0, 0, 2)));
+        REQUIRE(hit);
+        CHECK(std::abs(hit->t - 3) < EPSILON);
+    }
+
+    SUBCASE("The normal of a rotated instance is rotated") {
+        Instance instance(sharedTriangle(), Transform().rotateY(static_cast<float>(M_PI) / 2));
+        auto hit = instance.intersect(Ray(point(-2, 0.5f, 0), vector(1, 0, 0)));
+        REQUIRE(hit);
+        CHECK(std::abs(hit->t - 2) < EPSILON);
+        CHECK(instance.normalAt(*hit) == vector(-1, 0, 0));
+    }
+
+    SUBCASE("The bounds of an instance are the transformed bounds of its mesh") {
+        Instance instance(sharedTriangle(), Matrix4::identity());
+        auto bounds = Instance(sharedTriangle(), Transform().translate(0, 3, 0)).bounds();
+        CHECK(std::abs(bounds.lower[1] - 3) < EPSILON);
+        CHECK(std::abs(bounds.upper[1] - 4) < EPSILON);
+        CHECK(instance.bounds().lower[0] == -1);
+    }
+
+    SUBCASE("Invalid instances are rejected") {
+        CHECK_THROWS(Instance(sharedTriangle(), Transform().scale(0, 1, 1)));
+        CHECK_THROWS(Instance(nullptr));
+        CHECK_THROWS(Instance(std::make_shared<Mesh>()));
+        auto unbuilt = std::make_shared<Mesh>();
+        unbuilt->addVertex(point(0, 0, 0));
+        unbuilt->addVertex(point(1, 0, 0));
+        unbuilt->addVertex(point(0, 1, 0));
+        unbuilt->addTriangle(0, 1, 2);
+        CHECK_THROWS(Instance(unbuilt));
+    }
+}
+
+TEST_CASE("Scene") {
+
+    std::mt19937 rng(11);
+
+    auto mesh = tetrahedron();
+    Scene scene;
+    for (const auto &t: randomPlacements(1000, 12, 30, 0.5f, 2)) scene.add(Instance(mesh, t));
+
+    SUBCASE("Instances share their mesh instead of copying it") {
+        CHECK(mesh.use_count() == 1001);
+        scene.build();
+        CHECK(scene.memoryUsage() < mesh->memoryUsage() + scene.instances().capacity() * sizeof(Instance) + 1000 * 64);
+    }
+
+    SUBCASE("The two levels find the same hits as testing every instance") {
+        scene.build();
+        for (int i = 0; i < 1000; i++) {
+            auto origin = randomPoint(rng, 30);
+            Ray ray(origin, randomPoint(rng, 30) - origin);
+            std::optional<SceneHit> expected;
+            for (uint32_t j = 0; j < scene.instances().size(); j++) {
+                if (auto hit = scene.instances()[j].intersect(ray); hit && (!expected || hit->t < expected->hit.t)) {
+                    expected = SceneHit{*hit, j};
+                }
+            }
+            auto actual = scene.intersect(ray);
+            REQUIRE(actual.has_value() == expected.has_value());
+            if (actual) {
+                CHECK(actual->instance == expected->instance);
+                CHECK(actual->hit.t == expected->hit.t);
+            }
+        }
+    }
+
+    SUBCASE("Intersecting before building is an error") {
+        scene.add(Instance(mesh));
+        CHECK_THROWS(scene.intersect(Ray(point(0, 0, 0), vector(0, 0, 1))));
+    }
+}
@@ -0,0 +1,145 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "lighting.hpp"
+#include "shapes/sphere.hpp"
+
+using namespace transformation;
+
+TEST_CASE("Lighting") {
+
+    Material m;
+    auto position = point(0, 0, 0);
+
+    SUBCASE("Reflecting a vector approaching at 45°") {
+        CHECK_EQ(reflect(vector(1, -1, 0), vector(0, 1, 0)), vector(1, 1, 0));
+    }
+
+    SUBCASE("Reflecting a vector off a slanted surface") {
+        CHECK_EQ(reflect(vector(0, -1, 0), vector(SQR_TWO / 2, SQR_TWO / 2, 0)), vector(1, 0, 0));
+    }
+
+    SUBCASE("A point light has a position and intensity") {
+        PointLight light(point(0, 0, 0), color(1, 1, 1));
+        CHECK_EQ(light.position, point(0, 0, 0));
+        CHECK_EQ(light.intensity, color(1, 1, 1));
+    }
+
+    SUBCASE("The default material") {
+        CHECK_EQ(m.color, color(1, 1, 1));
+        CHECK(m.ambient == 0.1f);
+        CHECK(m.diffuse == 0.9f);
+        CHECK(m.specular == 0.9f);
+        CHECK(m.shininess == 200.f);
+    }
+
+    SUBCASE("A sphere has a default material, which may be assigned") {
+        Sphere s;
+        CHECK(s.material() == Material());
+        Material other;
+        other.ambient = 1;
+        s.setMaterial(other);
+        CHECK(s.material() == other);
+    }
+
+    SUBCASE("Lighting with the eye between the light and the surface") {
+        PointLight light(point(0, 0, -10), color(1, 1, 1));
+        CHECK_EQ(lighting(m, light, position, vector(0, 0, -1), vector(0, 0, -1)), color(1.9f, 1.9f, 1.9f));
+    }
+
+    SUBCASE("Lighting with the eye between light and surface, eye offset 45°") {
+        PointLight light(point(0, 0, -10), color(1, 1, 1));
+        auto eye = vector(0, SQR_TWO / 2, -SQR_TWO / 2);
+        CHECK_EQ(lighting(m, light, position, eye, vector(0, 0, -1)), color(1.0f, 1.0f, 1.0f));
+    }
+
+    SUBCASE("Lighting with eye opposite surface, light offset 45°") {
+        PointLight light(point(0, 10, -10), color(1, 1, 1));
+        CHECK_EQ(lighting(m, light, position, vector(0, 0, -1), vector(0, 0, -1)), color(0.7364f, 0.7364f, 0.7364f));
+    }
+
+    SUBCASE("Lighting with eye in the path of the reflection vector") {
+        PointLight light(point(0, 10, -10), color(1, 1, 1));
+        auto eye = vector(0, -SQR_TWO / 2, -SQR_TWO / 2);
+        auto result = lighting(m, light, position, eye, vector(0, 0, -1));
+        // A shininess of 200 magnifies the float rounding of the reflection past EPSILON; the book checks to 4 digits.
+        CHECK(std::abs(result.x - 1.6364f) < 1e-4f);
+        CHECK(std::abs(result.y - 1.6364f) < 1e-4f);
+        CHECK(std::abs(result.z - 1.6364f) < 1e-4f);
+    }
+
+    SUBCASE("Lighting with the light behind the surface") {
+        PointLight light(point(0, 0, 10), color(1, 1, 1));
+        CHECK_EQ(lighting(m, light, position, vector(0, 0, -1), vector(0, 0, -1)), color(0.1f, 0.1f, 0.1f));
+    }
+
+    SUBCASE("Lighting with the surface in shadow") {
+        PointLight light(point(0, 0, -10), color(1, 1, 1));
+        CHECK_EQ(lighting(m, light, position, vector(0, 0, -1), vector(0, 0, -1), true), color(0.1f, 0.1f, 0.1f));
+    }
+}
+
+TEST_CASE("Batched shading") {
+
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> coordinate(-1, 1);
+    std::uniform_real_distribution<float> unit(0, 1);
+
+    Sphere sphere(Transform().scale(1, 0.5f, 1).rotateZ(0.6f).translate(1, 2, 3));
+    PointLight light(point(-10, 10, -10), color(1, 0.9f, 0.8f));
+    auto eyePoint = point(0, 0, -5);
+
+    std::vector<Material> materials(4);
+    for (auto &material: materials) {
+        material.color = color(unit(rng), unit(rng), unit(rng));
+        material.shininess = 10 + 200 * unit(rng);
+    }
+
+    // Points on the sphere, some facing away from the light, some in shadow.
+    std::vector<HitRecord> hits;
+    for (size_t i = 0; i < 37; i++) {
+        auto p = vector(coordinate(rng), coordinate(rng), coordinate(rng)).normalize().value();
+        auto world = sphere.transformation().matrix() * point(p.x, p.y, p.z);
+        auto eye = (eyePoint - world).normalize().value();
+        hits.push_back({world, eye, sphere.normalAt(world), &materials[i % materials.size()], i % 5 == 0});
+    }
+
+    SUBCASE("Batched normals match one normal at a time") {
+        for (size_t offset = 0; offset < hits.size(); offset += 8) {
+            Tuple4x8 points;
+            for (size_t i = 0; i < 8 && offset + i < hits.size(); i++) points.setLane(i, hits[offset + i].position);
+            auto normals = sphere.normalAt(points);
+            for (size_t i = 0; i < 8 && offset + i < hits.size(); i++) {
+                CHECK_EQ(normals.lane(i), hits[offset + i].normal);
+            }
+        }
+    }
+
+    SUBCASE("Batched lighting matches one hit at a time") {
+        std::vector<Color> colors8(hits.size(), Colors::BLACK), colors16(hits.size(), Colors::BLACK);
+        shade<8>(hits, light, colors8);
+        shade<16>(hits, light, colors16);
+        for (size_t i = 0; i < hits.size(); i++) {
+            const auto &hit = hits[i];
+            auto expected = lighting(*hit.material, light, hit.position, hit.eye, hit.normal, hit.inShadow);
+            CHECK_EQ(colors8[i], expected);
+            CHECK_EQ(colors16[i], expected);
+        }
+    }
+
+    SUBCASE("Inactive lanes are black") {
+        auto batch = HitBatch<8>::gather(hits, hits.size() - 3);
+        auto colors = lighting(batch, light);
+        CHECK_EQ(colors.lane(5), Colors::BLACK);
+        CHECK_EQ(colors.lane(7), Colors::BLACK);
+    }
+
+    SUBCASE("Mismatched sizes are an error") {
+        std::vector<Color> colors(hits.size() - 1, Colors::BLACK);
+        CHECK_THROWS(shade(hits, light, colors));
+    }
+}
@@ -3,6 +3,9 @@
 #include <doctest/doctest.h>
 
 #include <sstream>
+#include <cmath>
+#include <cstdint>
+#include <vector>
 
 #include "math/matrix.hpp"
 
@@ -235,3 +238,149 @@ TEST_CASE("Matrix") {
 
 }
 
+// Diagonally dominant, hence well conditioned, pseudo-random matrices.
+static Matrix4 makeMatrix(uint32_t seed, bool affine) {
+    Matrix4 m;
+    for (size_t i = 0; i < 4; i++) {
+        for (size_t j = 0; j < 4; j++) {
+            seed = seed * 1664525u + 1013904223u;
+            auto value = static_cast<float>(seed >> 8) / static_cast<float>(1u << 24) * 4.f - 2.f;
+            m.set(i, j, i == j ? value + 6.f : value);
+        }
+    }
+    if (affine) {
+        m.set(3, 0, 0);
+        m.set(3, 1, 0);
+        m.set(3, 2, 0);
+        m.set(3, 3, 1);
+    }
+    return m;
+}
+
+TEST_CASE("Matrix4 kernels") {
+
+    const Matrix4 book = {
+            {-5, 2, 6, -8},
+            {1, -5, 1, 8},
+            {7, 7, -6, -7},
+            {1, -3, 7, 4}
+    };
+    const Matrix4 singular = {
+            {-4, 2, -2, -3},
+            {9, 6, 2, 6},
+            {0, -5, 1, -5},
+            {0, 0, 0, 0}
+    };
+
+    SUBCASE("The closed-form determinant matches the cofactor expansion") {
+        CHECK(compareFloat(matrix_kernels::Scalar::determinant(book), 532));
+        for (uint32_t seed = 0; seed < 32; seed++) {
+            auto m = makeMatrix(seed, false);
+            float expected = 0;
+            for (size_t col = 0; col < 4; col++) {
+                expected += m.at(0, col) * m.cofactor(0, col).value();
+            }
+            CHECK(std::abs(m.determinant() - expected) <= 1e-5f * std::abs(expected));
+        }
+    }
+
+    SUBCASE("The closed-form inverse matches the cofactor inverse") {
+        CHECK_EQ(matrix_kernels::Scalar::inverse(book).value(), book.cofactorInverse().value());
+        CHECK_FALSE(matrix_kernels::Scalar::inverse(singular).has_value());
+        for (uint32_t seed = 0; seed < 32; seed++) {
+            auto m = makeMatrix(seed, false);
+            CHECK_FALSE(m.isAffine());
+            CHECK_EQ(m.inverse().value(), m.cofactorInverse().value());
+            CHECK_EQ(m * m.inverse().value(), Matrix4::identity());
+        }
+    }
+
+    SUBCASE("The affine fast path matches the general inverse") {
+        const Matrix4 translation = {
+                {1, 0, 0, 5},
+                {0, 1, 0, -3},
+                {0, 0, 1, 2},
+                {0, 0, 0, 1}
+        };
+        CHECK(translation.isAffine());
+        CHECK_EQ(translation.inverse().value() * point(-3, 4, 5), point(-8, 7, 3));
+        CHECK_FALSE(matrix_kernels::Scalar::inverseAffine(Matrix4()).has_value());
+
+        for (uint32_t seed = 0; seed < 32; seed++) {
+            auto m = makeMatrix(seed, true);
+            CHECK(m.isAffine());
+            CHECK_EQ(matrix_kernels::Scalar::inverseAffine(m).value(), matrix_kernels::Scalar::inverse(m).value());
+        }
+    }
+
+#if RAYTRACER_SSE
+    SUBCASE("The SSE inverse matches the scalar inverse") {
+        CHECK_EQ(matrix_kernels::SSE::inverse(book).value(), matrix_kernels::Scalar::inverse(book).value());
+        CHECK_FALSE(matrix_kernels::SSE::inverse(singular).has_value());
+        for (uint32_t seed = 0; seed < 32; seed++) {
+            auto m = makeMatrix(seed, false);
+            CHECK_EQ(matrix_kernels::SSE::inverse(m).value(), matrix_kernels::Scalar::inverse(m).value());
+        }
+    }
+#endif
+
+    SUBCASE("The multiplication kernels match the generic product") {
+        for (uint32_t seed = 0; seed < 16; seed++) {
+            auto a = makeMatrix(seed, false);
+            auto b = makeMatrix(seed + 100, seed & 1);
+            Matrix4 expected;
+            for (size_t i = 0; i < 4; i++) {
+                for (size_t j = 0; j < 4; j++) {
+                    float sum = 0;
+                    for (size_t k = 0; k < 4; k++) sum += a.at(i, k) * b.at(k, j);
+                    expected.set(i, j, sum);
+                }
+            }
+            CHECK_EQ(matrix_kernels::Scalar::multiply(a, b), expected);
+            CHECK_EQ(a * b, expected);
+
+            Tuple4 t(1.5f, -2.f, 0.25f, seed & 1 ? 1.f : 0.f);
+            Tuple4 expectedTuple(a.at(0, 0) * t.x + a.at(0, 1) * t.y + a.at(0, 2) * t.z + a.at(0, 3) * t.w,
+                                 a.at(1, 0) * t.x + a.at(1, 1) * t.y + a.at(1, 2) * t.z + a.at(1, 3) * t.w,
+                                 a.at(2, 0) * t.x + a.at(2, 1) * t.y + a.at(2, 2) * t.z + a.at(2, 3) * t.w,
+                                 a.at(3, 0) * t.x + a.at(3, 1) * t.y + a.at(3, 2) * t.z + a.at(3, 3) * t.w);
+            CHECK_EQ(matrix_kernels::Scalar::transform(a, t), expectedTuple);
+            CHECK_EQ(a * t, expectedTuple);
+        }
+    }
+
+    SUBCASE("Transforming an array of tuples") {
+        auto m = makeMatrix(7, true);
+        // Odd, so that the two-tuple AVX loop has a tail.
+        std::vector<Tuple4> points;
+        for (size_t i = 0; i < 33; i++) {
+            auto f = static_cast<float>(i);
+            points.emplace_back(f, -f * 0.5f, 2.f - f, 1.f);
+        }
+
+        std::vector<Tuple4> out(points.size(), Tuple4(0, 0, 0, 0));
+        transform(m, points, out);
+        for (size_t i = 0; i < points.size(); i++) {
+            CHECK_EQ(out[i], m * points[i]);
+        }
+
+        std::vector<Tuple4> scalar(points.size(), Tuple4(0, 0, 0, 0));
+        matrix_kernels::Scalar::transform(m, points.data(), scalar.data(), points.size());
+        CHECK(out == scalar);
+
+#if RAYTRACER_AVX_DISPATCH
+        if (matrix_kernels::AVX::supported()) {
+            std::vector<Tuple4> wide(points.size(), Tuple4(0, 0, 0, 0));
+            matrix_kernels::AVX::transform(m, points.data(), wide.data(), points.size());
+            CHECK(wide == scalar);
+        }
+#endif
+
+        // In place
+        transform(m, points, points);
+        CHECK(points == scalar);
+
+        std::vector<Tuple4> tooShort(3, Tuple4(0, 0, 0, 0));
+        CHECK_THROWS(transform(m, points, tooShort));
+    }
+}
\ No newline at end of file
@@ -0,0 +1,276 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <fstream>
+#include <filesystem>
+
+#include "io/obj.hpp"
+#include "random_scene.hpp"
+
+TEST_CASE("Mesh") {
+
+    SUBCASE("A triangle is stored as indices into the vertices") {
+        auto mesh = bookTriangle();
+        CHECK(mesh.vertexCount() == 3);
+        CHECK(mesh.triangleCount() == 1);
+        CHECK(mesh.vertex(mesh.triangleVertex(0, 1)) == point(-1, 0, 0));
+        CHECK_FALSE(mesh.hasNormals());
+    }
+
+    SUBCASE("Finding the normal on a triangle") {
+        auto mesh = bookTriangle();
+        CHECK(mesh.normalAt(MeshHit{1, 0.5f, 0.25f, 0}) == vector(0, 0, -1));
+        CHECK(mesh.normalAt(MeshHit{1, 0.1f, 0.8f, 0}) == vector(0, 0, -1));
+    }
+
+    SUBCASE("Intersecting a ray parallel to the triangle") {
+        auto mesh = bookTriangle();
+        CHECK_FALSE(mesh.intersect(Ray(point(0, -1, -2), vector(0, 1, 0))));
+    }
+
+    SUBCASE("A ray misses the p1-p3 edge") {
+        auto mesh = bookTriangle();
+        CHECK_FALSE(mesh.intersect(Ray(point(1, 1, -2), vector(0, 0, 1))));
+    }
+
+    SUBCASE("A ray misses the p1-p2 edge") {
+        auto mesh = bookTriangle();
+        CHECK_FALSE(mesh.intersect(Ray(point(-1, 1, -2), vector(0, 0, 1))));
+    }
+
+    SUBCASE("A ray misses the p2-p3 edge") {
+        auto mesh = bookTriangle();
+        CHECK_FALSE(mesh.intersect(Ray(point(0, -1, -2), vector(0, 0, 1))));
+    }
+
+    SUBCASE("A ray strikes a triangle") {
+        auto mesh = bookTriangle();
+        auto hit = mesh.intersect(Ray(point(0, 0.5f, -2), vector(0, 0, 1)));
+        REQUIRE(hit);
+        CHECK(std::abs(hit->t - 2) < EPSILON);
+        CHECK(hit->triangle == 0);
+        CHECK_FALSE(mesh.intersect(Ray(point(0, 0.5f, -2), vector(0, 0, 1)), 1.5f));
+    }
+
+    SUBCASE("A smooth triangle uses u and v to interpolate the normal") {
+        Mesh mesh;
+        mesh.addVertex(point(0, 1, 0));
+        mesh.addVertex(point(-1, 0, 0));
+        mesh.addVertex(point(1, 0, 0));
+        mesh.addNormal(vector(0, 1, 0));
+        mesh.addNormal(vector(-1, 0, 0));
+        mesh.addNormal(vector(1, 0, 0));
+        mesh.addTriangle(0, 1, 2, 0, 1, 2);
+        mesh.build();
+        CHECK(mesh.normalAt(MeshHit{1, 0.45f, 0.25f, 0}) == vector(-0.5547f, 0.83205f, 0));
+
+        auto hit = mesh.intersect(Ray(point(-0.2f, 0.3f, -2), vector(0, 0, 1)));
+        REQUIRE(hit);
+        CHECK(std::abs(hit->u - 0.45f) < EPSILON);
+        CHECK(std::abs(hit->v - 0.25f) < EPSILON);
+    }
+
+    SUBCASE("Invalid triangles are rejected") {
+        Mesh mesh;
+        mesh.addVertex(point(0, 0, 0));
+        mesh.addVertex(point(1, 0, 0));
+        mesh.addVertex(point(0, 1, 0));
+        CHECK_THROWS(mesh.addTriangle(0, 1, 3));
+        mesh.addNormal(vector(0, 0, 1));
+        CHECK_THROWS(mesh.addTriangle(0, 1, 2, 0, 0, 1));
+        CHECK_THROWS(mesh.addTriangle(0, 1, 2, 0, 0, 1));
+    }
+
+    SUBCASE("Triangles with and without normals in the same mesh") {
+        Mesh mesh;
+        mesh.addVertex(point(0, 1, 0));
+        mesh.addVertex(point(-1, 0, 0));
+        mesh.addVertex(point(1, 0, 0));
+        mesh.addNormal(vector(0, 1, 0));
+        mesh.addTriangle(0, 1, 2);
+        mesh.addTriangle(0, 1, 2, 0, 0, 0);
+        mesh.addTriangle(0, 1, 2);
+        CHECK(mesh.hasNormals());
+        CHECK(mesh.normalAt(MeshHit{1, 0.2f, 0.3f, 0}) == vector(0, 0, -1));
+        CHECK(mesh.normalAt(MeshHit{1, 0.2f, 0.3f, 1}) == vector(0, 1, 0));
+        CHECK(mesh.normalAt(MeshHit{1, 0.2f, 0.3f, 2}) == vector(0, 0, -1));
+    }
+
+    SUBCASE("The hierarchy finds the same hits as testing every triangle") {
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<float> position(-10, 10);
+        Mesh mesh;
+        for (uint32_t t = 0; t < 500; t++) {
+            auto x = position(rng), y = position(rng), z = position(rng);
+            auto a = mesh.addVertex(x, y, z);
+            auto b = mesh.addVertex(x + 1, y, z + 0.5f);
+            auto c = mesh.addVertex(x, y + 1, z - 0.5f);
+            mesh.addTriangle(a, b, c);
+        }
+        mesh.build();
+
+        for (int i = 0; i < 500; i++) {
+            Ray ray(point(position(rng), position(rng), -20), vector(position(rng) * 0.05f, position(rng) * 0.05f, 1));
+            std::optional<MeshHit> expected;
+            for (uint32_t t = 0; t < mesh.triangleCount(); t++) {
+                if (auto hit = mesh.intersectTriangle(t, ray); hit && (!expected || hit->t < expected->t)) expected = hit;
+            }
+            auto actual = mesh.intersect(ray);
+            REQUIRE(actual.has_value() == expected.has_value());
+            if (actual) {
+                CHECK(actual->triangle == expected->triangle);
+                CHECK(actual->t == expected->t);
+            }
+        }
+    }
+}
+
+TEST_CASE("OBJ") {
+
+    SUBCASE("Ignoring unrecognized lines") {
+        auto mesh = io::parseObj("There was a young lady named Bright\n"
+                                 "who traveled much faster than light.\n"
+                                 "She set out one day\n"
+                                 "in a relative way,\n"
+                                 "and came back the previous night.\n");
+        CHECK(mesh.vertexCount() == 0);
+        CHECK(mesh.triangleCount() == 0);
+    }
+
+    SUBCASE("Vertex records") {
+        auto mesh = io::parseObj("v -1 1 0\n"
+                                 "v -1.0000 0.5000 0.0000\n"
+                                 "v 1 0 0\n"
+                                 "v 1 1 +0\n");
+        REQUIRE(mesh.vertexCount() == 4);
+        CHECK(mesh.vertex(0) == point(-1, 1, 0));
+        CHECK(mesh.vertex(1) == point(-1, 0.5f, 0));
+        CHECK(mesh.vertex(2) == point(1, 0, 0));
+        CHECK(mesh.vertex(3) == point(1, 1, 0));
+    }
+
+    SUBCASE("Parsing triangle faces") {
+        auto mesh = io::parseObj("v -1 1 0\n"
+                                 "v -1 0 0\n"
+                                 "v 1 0 0\n"
+                                 "v 1 1 0\n"
+                                 "\n"
+                                 "f 1 2 3\n"
+                                 "f 1 3 4\n");
+        REQUIRE(mesh.triangleCount() == 2);
+        CHECK(mesh.triangleVertex(0, 0) == 0);
+        CHECK(mesh.triangleVertex(0, 1) == 1);
+        CHECK(mesh.triangleVertex(0, 2) == 2);
+        CHECK(mesh.triangleVertex(1, 0) == 0);
+        CHECK(mesh.triangleVertex(1, 1) == 2);
+        CHECK(mesh.triangleVertex(1, 2) == 3);
+    }
+
+    SUBCASE("Triangulating polygons") {
+        auto mesh = io::parseObj("v -1 1 0\r\n"
+                                 "v -1 0 0\r\n"
+                                 "v 1 0 0\r\n"
+                                 "v 1 1 0\r\n"
+                                 "v 0 2 0\r\n"
+                                 "\r\n"
+                                 "f 1 2 3 4 5\r\n");
+        REQUIRE(mesh.triangleCount() == 3);
+        for (uint32_t t = 0; t < 3; t++) {
+            CHECK(mesh.triangleVertex(t, 0) == 0);
+            CHECK(mesh.triangleVertex(t, 1) == t + 1);
+            CHECK(mesh.triangleVertex(t, 2) == t + 2);
+        }
+    }
+
+    SUBCASE("Faces with normals, texture coordinates and comments") {
+        auto mesh = io::parseObj("# a triangle\n"
+                                 "o triangle\n"
+                                 "v 0 1 0\n"
+                                 "v -1 0 0\n"
+                                 "v 1 0 0\n"
+                                 "vt 0 0\n"
+                                 "vn -1 0 0\n"
+                                 "vn 1 0 0\n"
+                                 "vn 0 1 0\n"
+                                 "g FirstGroup\n"
+                                 "usemtl white\n"
+                                 "s off\n"
+                                 "f 1//3 2//1 3//2\n"
+                                 "f 1/1/3 2/1/1 3/1/2 # the same\n");
+        REQUIRE(mesh.normalCount() == 3);
+        REQUIRE(mesh.triangleCount() == 2);
+        CHECK(mesh.hasNormals());
+        CHECK(mesh.normal(2) == vector(0, 1, 0));
+        mesh.build();
+        CHECK(mesh.normalAt(MeshHit{1, 0, 0, 0}) == vector(0, 1, 0));
+        CHECK(mesh.normalAt(MeshHit{1, 1, 0, 1}) == vector(-1, 0, 0));
+    }
+
+    SUBCASE("Comments right after an index and faces without normals") {
+        auto mesh = io::parseObj("v 0 1 0\n"
+                                 "v -1 0 0\n"
+                                 "v 1 0 0\n"
+                                 "vn -1 0 0\n"
+                                 "vn 1 0 0\n"
+                                 "vn 0 1 0\n"
+                                 "f 1 2 3#no normals\n"
+                                 "f 1//3 2//1 3//2#smooth\n"
+                                 "f 1//3 2//1 3\n"
+                                 "f 1/1 2/1 3/#\n");
+        REQUIRE(mesh.triangleCount() == 4);
+        CHECK(mesh.triangleVertex(0, 2) == 2);
+        CHECK(mesh.hasNormals());
+        CHECK(mesh.normalAt(MeshHit{1, 0, 0, 0}) == vector(0, 0, -1));
+        CHECK(mesh.normalAt(MeshHit{1, 0, 0, 1}) == vector(0, 1, 0));
+        CHECK(mesh.normalAt(MeshHit{1, 1, 0, 1}) == vector(-1, 0, 0));
+        CHECK(mesh.normalAt(MeshHit{1, 1, 0, 2}) == vector(0, 0, -1));
+        CHECK(mesh.normalAt(MeshHit{1, 0, 0, 3}) == vector(0, 0, -1));
+    }
+
+    SUBCASE("Polygons are counted in triangles before the mesh is allocated") {
+        auto mesh = io::parseObj("v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nv -1 1 0\n"
+                                 "vn 0 0 1\nvn 0 0 -1\nvn 0 1 0\n"
+                                 "f 1//1 2//1 3//1 4//1 # a quad\n"
+                                 "f 1//2 2//2 3//2 4//3 5//3#a pentagon\n");
+        REQUIRE(mesh.triangleCount() == 5);
+        // Every array has exactly the capacity it needs: none was grown during the parse.
+        CHECK(mesh.memoryUsage() == sizeof(float) * 3 * (5 + 3) + sizeof(uint32_t) * 2 * 3 * 5);
+    }
+
+    SUBCASE("Negative indices count back from the last vertex") {
+        auto mesh = io::parseObj("v 0 0 0\nv 1 0 0\nv 0 1 0\nf -3 -2 -1\nv 1 1 0\nf 2/1 -1/1 3/1\n");
+        REQUIRE(mesh.triangleCount() == 2);
+        CHECK(mesh.triangleVertex(0, 0) == 0);
+        CHECK(mesh.triangleVertex(0, 2) == 2);
+        CHECK(mesh.triangleVertex(1, 1) == 3);
+    }
+
+    SUBCASE("Malformed files are rejected") {
+        CHECK_THROWS(io::parseObj("v 1 2\n"));
+        CHECK_THROWS(io::parseObj("v 1 x 2\n"));
+        CHECK_THROWS(io::parseObj("v 0 0 0\nv 1 0 0\nf 1 2\n"));
+        CHECK_THROWS(io::parseObj("v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 4\n"));
+        CHECK_THROWS(io::parseObj("v 0 0 0\nv 1 0 0\nv 0 1 0\nf 0 1 2\n"));
+        CHECK_THROWS(io::parseObj("v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 a\n"));
+        CHECK_THROWS(io::parseObj("v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3x\n"));
+        CHECK_THROWS(io::parseObj("v 0 0 0\nv 1 0 0\nv 0 1 0\nvn 0 0 1\nf 1//1 2//2 3//1\n"));
+    }
+
+    SUBCASE("Loading a file") {
+        auto path = std::filesystem::temp_directory_path() / "raytracer_mesh_test.obj";
+        {
+            std::ofstream file(path);
+            file << "v 0 1 0\nv -1 0 0\nv 1 0 0\nf 1 2 3";
+        }
+        auto mesh = io::loadObj(path);
+        std::filesystem::remove(path);
+        REQUIRE(mesh.triangleCount() == 1);
+        mesh.build();
+        CHECK(mesh.intersect(Ray(point(0, 0.5f, -2), vector(0, 0, 1))));
+
+        CHECK_THROWS(io::loadObj(path));
+    }
+}
@@ -0,0 +1,153 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <sstream>
+
+#include "canvas.hpp"
+#include "io/ppm_stream.hpp"
+
+static std::vector<std::string> lines(const std::string &str) {
+    std::vector<std::string> result;
+    std::stringstream stream(str);
+    for (std::string line; std::getline(stream, line);) {
+        result.push_back(line);
+    }
+    return result;
+}
+
+TEST_CASE("PPM") {
+
+    SUBCASE("Constructing the PPM pixel data") {
+        Canvas canvas(5, 3);
+        canvas.writePixelAt(0, 0, Pixel(color(1.5, 0, 0)));
+        canvas.writePixelAt(2, 1, Pixel(color(0, 0.5, 0)));
+        canvas.writePixelAt(4, 2, Pixel(color(-0.5, 0, 1)));
+
+        std::stringstream stream{};
+        stream << canvas.ppm();
+        auto ppmLines = lines(stream.str());
+
+        CHECK_EQ(ppmLines.size(), 6);
+        CHECK_EQ(ppmLines[3], "255 0 0 0 0 0 0 0 0 0 0 0 0 0 0");
+        CHECK_EQ(ppmLines[4], "0 0 0 0 0 0 0 128 0 0 0 0 0 0 0");
+        CHECK_EQ(ppmLines[5], "0 0 0 0 0 0 0 0 0 0 0 0 0 0 255");
+    }
+
+    SUBCASE("Splitting long lines in PPM files") {
+        Canvas canvas(10, 2);
+        for (size_t y = 0; y < canvas.height; y++) {
+            for (size_t x = 0; x < canvas.width; x++) {
+                canvas.writePixelAt(x, y, Pixel(color(1, 0.8, 0.6)));
+            }
+        }
+
+        std::stringstream stream{};
+        stream << canvas.ppm();
+        auto ppmLines = lines(stream.str());
+
+        CHECK_EQ(ppmLines.size(), 7);
+        CHECK_EQ(ppmLines[3], "255 204 153 255 204 153 255 204 153 255 204 153 255 204 153 255 204");
+        CHECK_EQ(ppmLines[4], "153 255 204 153 255 204 153 255 204 153 255 204 153");
+        CHECK_EQ(ppmLines[5], "255 204 153 255 204 153 255 204 153 255 204 153 255 204 153 255 204");
+        CHECK_EQ(ppmLines[6], "153 255 204 153 255 204 153 255 204 153 255 204 153");
+    }
+
+    SUBCASE("PPM files are terminated by a newline character") {
+        Canvas canvas(5, 3);
+
+        std::stringstream stream{};
+        stream << canvas.ppm();
+        auto ppmStr = stream.str();
+
+        CHECK_EQ(ppmStr.back(), '\n');
+    }
+
+    SUBCASE("Constructing the binary PPM header and pixel data") {
+        Canvas canvas(2, 2);
+        canvas.writePixelAt(0, 0, Pixel(Colors::RED));
+        canvas.writePixelAt(1, 0, Pixel(color(0, 0.5, 0)));
+        canvas.writePixelAt(0, 1, Pixel(color(-1, 2, 1)));
+
+        std::stringstream stream{};
+        stream << canvas.ppm(io::PPMIdentifier::COLORMAP_BINARY);
+        auto ppmStr = stream.str();
+
+        const std::string header = "P6\n2 2\n255\n";
+        const unsigned char data[] = {
+                255, 0, 0,   0, 128, 0,
+                0, 255, 255, 0, 0, 0
+        };
+
+        CHECK_EQ(ppmStr.size(), header.size() + sizeof(data));
+        CHECK_EQ(ppmStr.substr(0, header.size()), header);
+        CHECK_EQ(ppmStr.substr(header.size()), std::string(reinterpret_cast<const char *>(data), sizeof(data)));
+    }
+
+    SUBCASE("Binary PPM samples take two bytes when the maximum color value exceeds 255") {
+        std::vector<Pixel> pixels = {Pixel(color(1, 0.5, 0))};
+        io::PPM image(io::PPMHeader(io::PPMIdentifier::COLORMAP_BINARY, 1, 1, 1000), pixels);
+
+        std::stringstream stream{};
+        stream << image;
+        auto ppmStr = stream.str();
+
+        const std::string header = "P6\n1 1\n1000\n";
+        const unsigned char data[] = {0x03, 0xe8, 0x01, 0xf4, 0x00, 0x00};
+
+        CHECK_EQ(ppmStr.substr(header.size()), std::string(reinterpret_cast<const char *>(data), sizeof(data)));
+    }
+
+    SUBCASE("Formatting unsigned integers") {
+        char buffer[10];
+        CHECK_EQ(std::string(buffer, io::ppm::formatUnsigned(buffer, 0)), "0");
+        CHECK_EQ(std::string(buffer, io::ppm::formatUnsigned(buffer, 7)), "7");
+        CHECK_EQ(std::string(buffer, io::ppm::formatUnsigned(buffer, 255)), "255");
+        CHECK_EQ(std::string(buffer, io::ppm::formatUnsigned(buffer, 65535)), "65535");
+    }
+
+    SUBCASE("Streaming a PPM in bands matches the whole canvas encoding") {
+        Canvas canvas(7, 5);
+        for (size_t y = 0; y < canvas.height; y++) {
+            for (size_t x = 0; x < canvas.width; x++) {
+                canvas.writePixelAt(x, y, Pixel(color(x / 7.f, y / 5.f, 0.25f)));
+            }
+        }
+
+        for (auto magic: {io::PPMIdentifier::COLORMAP, io::PPMIdentifier::COLORMAP_BINARY}) {
+            std::stringstream expected{};
+            expected << canvas.ppm(magic);
+
+            std::stringstream streamed{};
+            io::PPMStream ppmStream(streamed, io::PPMHeader(magic, canvas.width, canvas.height, 0xff));
+
+            // Bands of 2, 2 and 1 rows.
+            for (uint32_t row = 0; row < canvas.height; row += 2) {
+                uint32_t rows = std::min<uint32_t>(2, canvas.height - row);
+                Canvas band(canvas.width, rows);
+                for (size_t y = 0; y < rows; y++) {
+                    for (size_t x = 0; x < canvas.width; x++) {
+                        band.writePixelAt(x, y, canvas.pixelAt(x, row + y));
+                    }
+                }
+                CHECK(!ppmStream.complete());
+                ppmStream.writeRows(band);
+            }
+
+            CHECK(ppmStream.complete());
+            CHECK_EQ(streamed.str(), expected.str());
+        }
+    }
+
+    SUBCASE("Streaming a PPM rejects incomplete rows and extra rows") {
+        std::stringstream stream{};
+        io::PPMStream ppmStream(stream, io::PPMHeader(io::PPMIdentifier::COLORMAP_BINARY, 4, 2, 0xff));
+
+        std::vector<Pixel> pixels(6);
+        CHECK_THROWS(ppmStream.writeRows(pixels));
+
+        pixels.resize(8);
+        ppmStream.writeRows(pixels);
+        CHECK_EQ(ppmStream.rowsRemaining(), 0);
+        CHECK_THROWS(ppmStream.writeRows(Span<const Pixel>(pixels).subspan(0, 4)));
+    }
+}
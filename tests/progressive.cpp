@@ -0,0 +1,176 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <atomic>
+#include <vector>
+#include <sstream>
+#include <fstream>
+#include <filesystem>
+
+#include "io/snapshot.hpp"
+#include "render/progressive.hpp"
+
+using namespace render;
+
+// A sample whose value depends on its index, so the average tells which samples were taken.
+static Tuple4 indexed(size_t x, size_t y, uint32_t index) {
+    return color(static_cast<float>(index), static_cast<float>(x), static_cast<float>(y));
+}
+
+static std::string readFile(const std::filesystem::path &path) {
+    std::ifstream file(path, std::ifstream::binary);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+TEST_CASE("Accumulator") {
+
+    SUBCASE("A pixel averages the samples added to it") {
+        Accumulator accumulator(4, 3);
+        CHECK(accumulator.samples(1, 2) == 0);
+        CHECK(accumulator.average(1, 2) == Colors::BLACK);
+
+        accumulator.add(1, 2, color(1, 0, 0));
+        accumulator.add(1, 2, color(2, 3, 0), 2);
+        CHECK(accumulator.samples(1, 2) == 3);
+        CHECK(accumulator.average(1, 2) == color(1, 1, 0));
+        CHECK(accumulator.samples(2, 1) == 0);
+
+        accumulator.clear();
+        CHECK(accumulator.samples(1, 2) == 0);
+    }
+
+    SUBCASE("Resolving writes the averages to a canvas") {
+        Accumulator accumulator(20, 20);
+        accumulator.add(17, 19, color(0.5f, 0.5f, 0.5f), 1);
+        Canvas canvas(20, 20);
+        accumulator.resolve(canvas);
+        CHECK(canvas.pixelAt(17, 19) == Pixel(color(0.5f, 0.5f, 0.5f)));
+        CHECK(canvas.pixelAt(0, 0) == Pixel(Colors::BLACK));
+
+        Canvas other(10, 20);
+        CHECK_THROWS(accumulator.resolve(other));
+    }
+}
+
+TEST_CASE("ProgressiveRenderer") {
+
+    SUBCASE("Passes double the samples per pixel") {
+        Canvas canvas(37, 21);
+        Accumulator accumulator(37, 21);
+        ProgressiveRenderer renderer({20}, {8, 3});
+
+        std::vector<uint32_t> passes;
+        auto samples = renderer.render(canvas, accumulator, indexed, [&](const PassInfo &info) {
+            passes.push_back(info.samples);
+            CHECK(info.pass == passes.size() - 1);
+            // The canvas shows the average of every sample so far: indices 0 .. samples - 1.
+            CHECK(compareFloat(accumulator.average(5, 7).x, static_cast<float>(info.samples - 1) / 2));
+            CHECK(compareFloat(canvas.pixelAt(36, 20).color.y, 36));
+        });
+
+        CHECK(samples == 20);
+        CHECK((passes == std::vector<uint32_t>{1, 2, 4, 8, 16, 20}));
+        CHECK(accumulator.samples(0, 0) == 20);
+        CHECK(accumulator.samples(36, 20) == 20);
+    }
+
+    SUBCASE("Cancelling drops the pass in progress") {
+        Canvas canvas(16, 16);
+        Accumulator accumulator(16, 16);
+        ProgressiveRenderer renderer({64}, {4, 2});
+
+        std::atomic<bool> cancel {false};
+        uint32_t lastPass = 0;
+        auto samples = renderer.render(canvas, accumulator, indexed, [&](const PassInfo &info) {
+            lastPass = info.samples;
+            if (info.samples == 4) cancel = true;
+        }, &cancel);
+
+        CHECK(samples == 4);
+        CHECK(lastPass == 4);
+    }
+
+    SUBCASE("A pass cancelled halfway leaves the accumulator and canvas at the last complete pass") {
+        Canvas canvas(16, 16);
+        Accumulator accumulator(16, 16);
+        ProgressiveRenderer renderer({64}, {4, 2});
+
+        std::atomic<bool> cancel {false};
+        std::atomic<int> calls {0};
+        // The fourth pass takes samples 4 to 7: cancel once a few of its tiles are done.
+        auto cancelling = [&](size_t x, size_t y, uint32_t index) {
+            if (index >= 4 && calls.fetch_add(1) == 16 * 4 * 3) cancel = true;
+            return indexed(x, y, index);
+        };
+        uint32_t passes = 0;
+        auto samples = renderer.render(canvas, accumulator, cancelling, [&](const PassInfo &) { passes += 1; }, &cancel);
+
+        CHECK(samples == 4);
+        CHECK(passes == 3);
+        bool complete = true;
+        for (uint32_t y = 0; y < 16; y++) {
+            for (uint32_t x = 0; x < 16; x++) {
+                complete = complete && accumulator.samples(x, y) == 4;
+                complete = complete && compareFloat(canvas.pixelAt(x, y).color.x, 1.5f);
+            }
+        }
+        CHECK(complete);
+    }
+
+    SUBCASE("The accumulator must match the canvas") {
+        Canvas canvas(16, 16);
+        Accumulator accumulator(8, 16);
+        ProgressiveRenderer renderer;
+        CHECK_THROWS(renderer.render(canvas, accumulator, indexed, [](const PassInfo &) {}));
+        CHECK_THROWS(ProgressiveRenderer({0}));
+    }
+}
+
+TEST_CASE("Snapshot") {
+
+    auto directory = std::filesystem::temp_directory_path() / "raytracer_snapshot_test";
+    std::filesystem::create_directories(directory);
+    auto path = directory / "snapshot.ppm";
+
+    SUBCASE("A snapshot replaces the previous one and leaves no temporary file") {
+        Canvas canvas(3, 2);
+        canvas.writePixelAt(1, 1, Pixel(Colors::RED));
+        io::writeSnapshot(path, canvas);
+
+        std::stringstream expected;
+        expected << canvas.ppm(io::PPMIdentifier::COLORMAP_BINARY);
+        CHECK(readFile(path) == expected.str());
+
+        canvas.writePixelAt(0, 0, Pixel(Colors::GREEN));
+        io::writeSnapshot(path, canvas, io::PPMIdentifier::COLORMAP);
+        std::stringstream updated;
+        updated << canvas.ppm();
+        CHECK(readFile(path) == updated.str());
+
+        auto temporary = path;
+        temporary += ".partial";
+        CHECK_FALSE(std::filesystem::exists(temporary));
+    }
+
+    SUBCASE("Failing to write keeps the previous snapshot") {
+        Canvas canvas(3, 2);
+        io::writeSnapshot(path, canvas);
+        auto before = readFile(path);
+
+        // A directory in the way of the temporary file makes the next write of `path` fail.
+        auto temporary = path;
+        temporary += ".partial";
+        std::filesystem::create_directory(temporary);
+        canvas.writePixelAt(0, 0, Pixel(Colors::RED));
+        CHECK_THROWS(io::writeSnapshot(path, canvas));
+        CHECK(readFile(path) == before);
+        std::filesystem::remove(temporary);
+
+        io::writeSnapshot(path, canvas);
+        CHECK(readFile(path) != before);
+    }
+
+    std::filesystem::remove_all(directory);
+}
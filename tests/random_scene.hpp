@@ -0,0 +1,64 @@
+#ifndef RAYTRACERCHALLENGE_TEST_RANDOM_SCENE_HPP
+#define RAYTRACERCHALLENGE_TEST_RANDOM_SCENE_HPP
+
+#include <random>
+#include <vector>
+#include <cstdint>
+
+#include "world.hpp"
+#include "shapes/mesh.hpp"
+#include "math/transform.hpp"
+
+// Scenes shared by the tests: the book's triangle mesh, and seeded random scenes to check acceleration
+// structures against brute force.
+
+// The triangle (0, 1, 0), (-1, 0, 0), (1, 0, 0) of the book's triangle tests, as a built mesh.
+inline Mesh bookTriangle() {
+    Mesh mesh;
+    mesh.addVertex(point(0, 1, 0));
+    mesh.addVertex(point(-1, 0, 0));
+    mesh.addVertex(point(1, 0, 0));
+    mesh.addTriangle(0, 1, 2);
+    mesh.build();
+    return mesh;
+}
+
+inline Point randomPoint(std::mt19937 &rng, float extent) {
+    std::uniform_real_distribution<float> coordinate(-extent, extent);
+    float x = coordinate(rng), y = coordinate(rng), z = coordinate(rng);
+    return point(x, y, z);
+}
+
+// `count` placements: a scale in [minSize, maxSize) along each axis, a turn around y, then a position in [-extent, extent]^3.
+inline std::vector<transformation::Transform> randomPlacements(size_t count, uint32_t seed, float extent,
+                                                               float minSize, float maxSize) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> size(minSize, maxSize);
+    std::uniform_real_distribution<float> angle(0, 2 * PI);
+    std::vector<transformation::Transform> placements;
+    placements.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        float sx = size(rng), sy = size(rng), sz = size(rng), turn = angle(rng);
+        auto position = randomPoint(rng, extent);
+        placements.push_back(transformation::Transform().scale(sx, sy, sz).rotateY(turn)
+                                     .translate(position.x, position.y, position.z));
+    }
+    return placements;
+}
+
+inline std::vector<Sphere> randomSpheres(size_t count, uint32_t seed, float extent, float minSize, float maxSize) {
+    std::vector<Sphere> spheres;
+    spheres.reserve(count);
+    for (const auto &t: randomPlacements(count, seed, extent, minSize, maxSize)) spheres.emplace_back(t);
+    return spheres;
+}
+
+// The spheres of `randomSpheres` in a built world.
+inline World randomWorld(size_t count, uint32_t seed, float extent, float minSize, float maxSize) {
+    World world;
+    for (const auto &sphere: randomSpheres(count, seed, extent, minSize, maxSize)) world.add(sphere);
+    world.build();
+    return world;
+}
+
+#endif //RAYTRACERCHALLENGE_TEST_RANDOM_SCENE_HPP
@@ -0,0 +1,114 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+
+#include <doctest/doctest.h>
+
+#include "ray.hpp"
+#include "intersection.hpp"
+#include "math/transformation.hpp"
+
+TEST_CASE("Ray") {
+
+    using namespace transformation;
+
+    SUBCASE("Creating and querying a ray") {
+        auto origin = point(1, 2, 3);
+        auto direction = vector(4, 5, 6);
+        Ray r(origin, direction);
+        CHECK_EQ(r.origin, origin);
+        CHECK_EQ(r.direction, direction);
+    }
+
+    SUBCASE("Computing a point from a distance") {
+        Ray r(point(2, 3, 4), vector(1, 0, 0));
+        CHECK_EQ(r.position(0), point(2, 3, 4));
+        CHECK_EQ(r.position(1), point(3, 3, 4));
+        CHECK_EQ(r.position(-1), point(1, 3, 4));
+        CHECK_EQ(r.position(2.5), point(4.5, 3, 4));
+    }
+
+    SUBCASE("Translating a ray") {
+        Ray r(point(1, 2, 3), vector(0, 1, 0));
+        auto r2 = r.transform(translation(3, 4, 5));
+        CHECK_EQ(r2.origin, point(4, 6, 8));
+        CHECK_EQ(r2.direction, vector(0, 1, 0));
+    }
+
+    SUBCASE("Scaling a ray") {
+        Ray r(point(1, 2, 3), vector(0, 1, 0));
+        auto r2 = r.transform(scale(2, 3, 4));
+        CHECK_EQ(r2.origin, point(2, 6, 12));
+        CHECK_EQ(r2.direction, vector(0, 3, 0));
+    }
+
+    SUBCASE("Transforming a packet of rays matches transforming each ray") {
+        RayPacket<8> packet;
+        for (size_t i = 0; i < 8; i++) {
+            auto f = static_cast<float>(i);
+            packet.setLane(i, Ray(point(f, -f, 2 * f), vector(1, f, 0)));
+        }
+        auto m = translation(1, 2, 3) * rotationY(PI / 3) * scale(2, 1, 2);
+        auto transformed = packet.transform(m);
+        for (size_t i = 0; i < 8; i++) {
+            auto expected = packet.lane(i).transform(m);
+            CHECK_EQ(transformed.lane(i).origin, expected.origin);
+            CHECK_EQ(transformed.lane(i).direction, expected.direction);
+        }
+    }
+}
+
+TEST_CASE("Intersections") {
+
+    SUBCASE("Intersections are kept sorted by t") {
+        Intersections<4> xs;
+        xs.add({5, nullptr});
+        xs.add({7, nullptr});
+        xs.add({-3, nullptr});
+        xs.add({2, nullptr});
+        REQUIRE_EQ(xs.size(), 4);
+        CHECK_EQ(xs[0].t, -3);
+        CHECK_EQ(xs[1].t, 2);
+        CHECK_EQ(xs[2].t, 5);
+        CHECK_EQ(xs[3].t, 7);
+    }
+
+    SUBCASE("A full buffer keeps the closest intersections") {
+        Intersections<2> xs;
+        CHECK(xs.add({5, nullptr}));
+        CHECK(xs.add({7, nullptr}));
+        CHECK_FALSE(xs.add({9, nullptr}));
+        CHECK(xs.add({1, nullptr}));
+        REQUIRE_EQ(xs.size(), 2);
+        CHECK_EQ(xs[0].t, 1);
+        CHECK_EQ(xs[1].t, 5);
+    }
+
+    SUBCASE("The hit, when all intersections have positive t") {
+        Intersections<2> xs;
+        xs.add({1, nullptr});
+        xs.add({2, nullptr});
+        CHECK_EQ(xs.hit()->t, 1);
+    }
+
+    SUBCASE("The hit, when some intersections have negative t") {
+        Intersections<2> xs;
+        xs.add({-1, nullptr});
+        xs.add({1, nullptr});
+        CHECK_EQ(xs.hit()->t, 1);
+    }
+
+    SUBCASE("The hit, when all intersections have negative t") {
+        Intersections<2> xs;
+        xs.add({-2, nullptr});
+        xs.add({-1, nullptr});
+        CHECK_FALSE(xs.hit().has_value());
+    }
+
+    SUBCASE("The hit is always the lowest nonnegative intersection") {
+        Intersections<4> xs;
+        xs.add({5, nullptr});
+        xs.add({7, nullptr});
+        xs.add({-3, nullptr});
+        xs.add({2, nullptr});
+        CHECK_EQ(xs.hit()->t, 2);
+    }
+}
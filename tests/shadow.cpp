@@ -0,0 +1,101 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <memory>
+#include <random>
+
+#include "world.hpp"
+#include "scene.hpp"
+#include "random_scene.hpp"
+
+using namespace transformation;
+
+// The book's default world: two concentric spheres lit from (-10, 10, -10).
+static World defaultWorld() {
+    Material outer;
+    outer.color = color(0.8f, 1.0f, 0.6f);
+    outer.diffuse = 0.7f;
+    outer.specular = 0.2f;
+    World world;
+    world.add(Sphere(Transform(), outer));
+    world.add(Sphere(Transform().scale(0.5f, 0.5f, 0.5f)));
+    world.build();
+    return world;
+}
+
+static const PointLight light(point(-10, 10, -10), color(1, 1, 1));
+
+TEST_CASE("Shadows") {
+
+    auto world = defaultWorld();
+
+    SUBCASE("There is no shadow when nothing is collinear with point and light") {
+        CHECK_FALSE(world.isShadowed(point(0, 10, 0), light));
+    }
+
+    SUBCASE("The shadow when an object is between the point and the light") {
+        CHECK(world.isShadowed(point(10, -10, 10), light));
+    }
+
+    SUBCASE("There is no shadow when an object is behind the light") {
+        CHECK_FALSE(world.isShadowed(point(-20, 20, -20), light));
+    }
+
+    SUBCASE("There is no shadow when an object is behind the point") {
+        CHECK_FALSE(world.isShadowed(point(-2, 2, -2), light));
+    }
+
+    SUBCASE("A cached occluder does not shadow points it is not in front of") {
+        CHECK(world.isShadowed(point(10, -10, 10), light));
+        CHECK_FALSE(world.isShadowed(point(0, 10, 0), light));
+        CHECK(world.isShadowed(point(10, -10, 10), light));
+        accel::OccluderCache::clear();
+        CHECK(accel::OccluderCache::get(&world, light.position) == accel::OccluderCache::NONE);
+    }
+
+    SUBCASE("Any-hit queries agree with the closest hit") {
+        auto spheres = randomWorld(300, 3, 20, 0.3f, 2.f);
+        std::mt19937 rng(4);
+
+        PointLight lamp(point(0, 30, 0), color(1, 1, 1));
+        for (int i = 0; i < 2000; i++) {
+            auto p = randomPoint(rng, 20);
+            auto toLight = lamp.position - p;
+            auto hit = spheres.intersect(Ray(p, toLight));
+            bool expected = hit && hit->t < 1;
+            CHECK(spheres.occluded(Ray(p, toLight), 1) == expected);
+            CHECK(spheres.isShadowed(p, lamp) == expected);
+        }
+    }
+
+    SUBCASE("Occlusion queries need a built world") {
+        world.add(Sphere());
+        CHECK_THROWS(world.occluded(Ray(point(0, 0, 0), vector(0, 0, 1)), 1));
+        CHECK_THROWS(world.isShadowed(point(0, 0, 0), light));
+    }
+}
+
+TEST_CASE("Shadows of instances") {
+
+    auto mesh = std::make_shared<Mesh>();
+    mesh->addVertex(point(-1, 0, -1));
+    mesh->addVertex(point(1, 0, -1));
+    mesh->addVertex(point(0, 0, 1));
+    mesh->addTriangle(0, 1, 2);
+    mesh->build();
+
+    Scene scene;
+    scene.add(Instance(mesh, Transform().translate(0, 5, 0)));
+    scene.add(Instance(mesh, Transform().scale(2, 2, 2).translate(10, 5, 0)));
+    scene.build();
+
+    PointLight lamp(point(0, 10, 0), color(1, 1, 1));
+
+    CHECK(scene.isShadowed(point(0, 0, 0), lamp));
+    CHECK(scene.isShadowed(point(0, 0, 0), lamp));
+    CHECK_FALSE(scene.isShadowed(point(5, 0, 0), lamp));
+    CHECK(scene.occluded(Ray(point(10, 0, 0), vector(0, 1, 0)), 10));
+    CHECK_FALSE(scene.occluded(Ray(point(10, 0, 0), vector(0, 1, 0)), 4));
+    CHECK_FALSE(mesh->occluded(Ray(point(0, -1, 0), vector(0, 1, 0)), 0.5f));
+    CHECK(mesh->occluded(Ray(point(0, -1, 0), vector(0, 1, 0)), 1.5f));
+}
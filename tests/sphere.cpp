@@ -0,0 +1,177 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <cmath>
+
+#include "shapes/sphere.hpp"
+#include "allocation_counter.hpp"
+
+using namespace transformation;
+
+TEST_CASE("Sphere") {
+
+    SUBCASE("A ray intersects a sphere at two points") {
+        Ray r(point(0, 0, -5), vector(0, 0, 1));
+        Sphere s;
+        auto xs = s.intersect(r);
+        REQUIRE_EQ(xs.size(), 2);
+        CHECK_EQ(xs[0].t, 4.0f);
+        CHECK_EQ(xs[1].t, 6.0f);
+    }
+
+    SUBCASE("A ray intersects a sphere at a tangent") {
+        Ray r(point(0, 1, -5), vector(0, 0, 1));
+        Sphere s;
+        auto xs = s.intersect(r);
+        REQUIRE_EQ(xs.size(), 2);
+        CHECK_EQ(xs[0].t, 5.0f);
+        CHECK_EQ(xs[1].t, 5.0f);
+    }
+
+    SUBCASE("A ray misses a sphere") {
+        Ray r(point(0, 2, -5), vector(0, 0, 1));
+        Sphere s;
+        CHECK(s.intersect(r).empty());
+    }
+
+    SUBCASE("A ray originates inside a sphere") {
+        Ray r(point(0, 0, 0), vector(0, 0, 1));
+        Sphere s;
+        auto xs = s.intersect(r);
+        REQUIRE_EQ(xs.size(), 2);
+        CHECK_EQ(xs[0].t, -1.0f);
+        CHECK_EQ(xs[1].t, 1.0f);
+    }
+
+    SUBCASE("A sphere is behind a ray") {
+        Ray r(point(0, 0, 5), vector(0, 0, 1));
+        Sphere s;
+        auto xs = s.intersect(r);
+        REQUIRE_EQ(xs.size(), 2);
+        CHECK_EQ(xs[0].t, -6.0f);
+        CHECK_EQ(xs[1].t, -4.0f);
+        CHECK_FALSE(xs.hit().has_value());
+    }
+
+    SUBCASE("Intersect sets the object on the intersection") {
+        Ray r(point(0, 0, -5), vector(0, 0, 1));
+        Sphere s;
+        auto xs = s.intersect(r);
+        REQUIRE_EQ(xs.size(), 2);
+        CHECK_EQ(xs[0].object, &s);
+        CHECK_EQ(xs[1].object, &s);
+    }
+
+    SUBCASE("A sphere's default transformation") {
+        Sphere s;
+        CHECK_EQ(s.transformation().matrix(), Matrix4::identity());
+    }
+
+    SUBCASE("Changing a sphere's transformation") {
+        Sphere s;
+        s.setTransformation(Transform().translate(2, 3, 4));
+        CHECK_EQ(s.transformation().matrix(), translation(2, 3, 4));
+    }
+
+    SUBCASE("Intersecting a scaled sphere with a ray") {
+        Ray r(point(0, 0, -5), vector(0, 0, 1));
+        Sphere s(Transform().scale(2, 2, 2));
+        auto xs = s.intersect(r);
+        REQUIRE_EQ(xs.size(), 2);
+        CHECK_EQ(xs[0].t, 3.0f);
+        CHECK_EQ(xs[1].t, 7.0f);
+    }
+
+    SUBCASE("Intersecting a translated sphere with a ray") {
+        Ray r(point(0, 0, -5), vector(0, 0, 1));
+        Sphere s(Transform().translate(5, 0, 0));
+        CHECK(s.intersect(r).empty());
+    }
+
+    SUBCASE("A sphere with a singular transformation is never hit") {
+        Ray r(point(0, 0, -5), vector(0, 0, 1));
+        Sphere s(Transform().scale(0, 1, 1));
+        CHECK(s.intersect(r).empty());
+    }
+
+    SUBCASE("The normal on a sphere at a nonaxial point") {
+        Sphere s;
+        auto k = std::sqrt(3.f) / 3;
+        auto n = s.normalAt(point(k, k, k));
+        CHECK_EQ(n, vector(k, k, k));
+        CHECK_EQ(n, n.normalize().value());
+    }
+
+    SUBCASE("Computing the normal on a translated sphere") {
+        Sphere s(Transform().translate(0, 1, 0));
+        CHECK_EQ(s.normalAt(point(0, 1.70711f, -0.70711f)), vector(0, 0.70711f, -0.70711f));
+    }
+
+    SUBCASE("Computing the normal on a transformed sphere") {
+        Sphere s(Transform().rotateZ(PI / 5).scale(1, 0.5f, 1));
+        CHECK_EQ(s.normalAt(point(0, SQR_TWO / 2, -SQR_TWO / 2)), vector(0, 0.97014f, -0.24254f));
+    }
+
+    SUBCASE("Intersecting does not allocate") {
+        Sphere s(Transform().scale(2, 2, 2).translate(0, 0, 1));
+        Ray r(point(0, 0, -5), vector(0, 0, 1));
+        auto before = allocations.calls.load();
+        size_t hits = 0;
+        for (int i = 0; i < 1000; i++) {
+            hits += s.intersect(r).size();
+        }
+        CHECK_EQ(allocations.calls.load(), before);
+        CHECK_EQ(hits, 2000);
+    }
+}
+
+TEST_CASE("Sphere packets") {
+
+    SUBCASE("A packet of rays gives the same intersections as each ray") {
+        Sphere s(Transform().scale(1, 2, 1).rotateX(PI / 7).translate(0.5f, 0, 1));
+
+        RayPacket<8> rays;
+        for (size_t i = 0; i < 8; i++) {
+            auto f = static_cast<float>(i) * 0.4f - 1.6f;
+            rays.setLane(i, Ray(point(f, f * 0.5f, -5), vector(0.05f * f, 0, 1)));
+        }
+        auto active = MaskxN<8>::first(7);
+        auto packet = s.intersect(rays, active);
+        auto hits = packet.hit();
+
+        size_t missed = 0;
+        for (size_t i = 0; i < 8; i++) {
+            auto xs = s.intersect(rays.lane(i));
+            if (i == 7) {
+                CHECK_FALSE(packet.mask[i]);
+                continue;
+            }
+            REQUIRE_EQ(packet.mask[i], !xs.empty());
+            if (xs.empty()) {
+                missed += 1;
+                CHECK(std::isinf(hits[i]));
+                continue;
+            }
+            CHECK(compareFloat(packet.t0[i], xs[0].t));
+            CHECK(compareFloat(packet.t1[i], xs[1].t));
+            CHECK(compareFloat(hits[i], xs.hit()->t));
+        }
+        // Both outcomes are exercised.
+        CHECK_GT(missed, 0);
+        CHECK_LT(missed, 7);
+    }
+
+    SUBCASE("The hit of a packet skips intersections behind the rays") {
+        Sphere s;
+        RayPacket<4> rays;
+        rays.setLane(0, Ray(point(0, 0, -5), vector(0, 0, 1)));
+        rays.setLane(1, Ray(point(0, 0, 0), vector(0, 0, 1)));
+        rays.setLane(2, Ray(point(0, 0, 5), vector(0, 0, 1)));
+        rays.setLane(3, Ray(point(0, 2, -5), vector(0, 0, 1)));
+        auto hits = s.intersect(rays, MaskxN<4>::broadcast(true)).hit();
+        CHECK_EQ(hits[0], 4.0f);
+        CHECK_EQ(hits[1], 1.0f);
+        CHECK(std::isinf(hits[2]));
+        CHECK(std::isinf(hits[3]));
+    }
+}
@@ -0,0 +1,111 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <random>
+#include <vector>
+#include <algorithm>
+
+#include "render/stream.hpp"
+#include "random_scene.hpp"
+
+using namespace transformation;
+using render::StreamHit;
+
+static StreamHit singleHit(const World &world, const Ray &ray) {
+    auto hit = world.intersect(ray);
+    if (!hit) return {};
+    return {hit->t, static_cast<uint32_t>(hit->object - world.objects().data())};
+}
+
+// Rays between random points, in pixel order: as incoherent as secondary rays.
+static render::RayStream randomStream(size_t count) {
+    std::mt19937 rng(8);
+    render::RayStream stream;
+    for (uint32_t i = 0; i < count; i++) {
+        auto origin = randomPoint(rng, 25);
+        stream.add(Ray(origin, randomPoint(rng, 25) - origin), i);
+    }
+    return stream;
+}
+
+TEST_CASE("Ray streams") {
+
+    auto world = randomWorld(200, 4, 20, 0.3f, 2.f);
+
+    SUBCASE("Packets find the same closest hits as single rays, for the active lanes only") {
+        auto stream = randomStream(800);
+        for (size_t offset = 0; offset < stream.size(); offset += 8) {
+            auto active = MaskxN<8>::first(8);
+            active.set(offset / 8 % 8, false);
+            auto packet = world.intersect(stream.packet<8>(offset), active);
+            for (size_t i = 0; i < 8; i++) {
+                auto expected = singleHit(world, stream.ray(offset + i));
+                if (!active[i]) {
+                    CHECK_FALSE(packet.mask[i]);
+                    continue;
+                }
+                REQUIRE(packet.mask[i] == (expected.object != StreamHit::NONE));
+                if (packet.mask[i]) {
+                    CHECK(packet.object[i] == expected.object);
+                    CHECK(packet.t[i] == expected.t);
+                }
+            }
+        }
+    }
+
+    SUBCASE("Sorting groups rays by octant and keeps every ray with its id") {
+        auto stream = randomStream(1000);
+        auto original = stream;
+        stream.sort(world.hierarchy().bounds());
+
+        REQUIRE(stream.size() == original.size());
+        std::vector<uint32_t> ids;
+        uint32_t previous = 0;
+        for (size_t i = 0; i < stream.size(); i++) {
+            auto ray = stream.ray(i);
+            CHECK(ray.origin == original.ray(stream.id(i)).origin);
+            CHECK(ray.direction == original.ray(stream.id(i)).direction);
+            uint32_t octant = (ray.direction.x < 0) | (ray.direction.y < 0) << 1 | (ray.direction.z < 0) << 2;
+            CHECK(octant >= previous);
+            previous = octant;
+            ids.push_back(stream.id(i));
+        }
+        std::sort(ids.begin(), ids.end());
+        for (uint32_t i = 0; i < ids.size(); i++) CHECK(ids[i] == i);
+    }
+
+    SUBCASE("Tracing a sorted stream in packets of 8 and 16 matches single rays") {
+        auto stream = randomStream(1001);
+        stream.sort(world.hierarchy().bounds());
+        std::vector<StreamHit> hits8, hits16;
+        render::trace<8>(world, stream, hits8);
+        render::trace<16>(world, stream, hits16);
+        REQUIRE(hits8.size() == stream.size());
+        for (size_t i = 0; i < stream.size(); i++) {
+            auto expected = singleHit(world, stream.ray(i));
+            CHECK(hits8[i].object == expected.object);
+            CHECK(hits16[i].object == expected.object);
+            CHECK(hits8[i].t == expected.t);
+        }
+    }
+
+    SUBCASE("Primary rays are generated for every pixel of a tile") {
+        render::RayStream stream;
+        stream.generate({8, 4, 5, 3}, 20, [](uint32_t x, uint32_t y) {
+            return Ray(point(static_cast<float>(x), static_cast<float>(y), -10), vector(0, 0, 1));
+        });
+        REQUIRE(stream.size() == 15);
+        std::vector<uint32_t> ids;
+        for (size_t i = 0; i < stream.size(); i++) {
+            auto x = stream.id(i) % 20, y = stream.id(i) / 20;
+            CHECK(stream.ray(i).origin == point(static_cast<float>(x), static_cast<float>(y), -10));
+            ids.push_back(stream.id(i));
+        }
+        std::sort(ids.begin(), ids.end());
+        CHECK(std::unique(ids.begin(), ids.end()) == ids.end());
+        CHECK(ids.front() == 8 + 4 * 20);
+        CHECK(ids.back() == 12 + 6 * 20);
+        // The first 8 rays cover a 4 x 2 patch.
+        CHECK(stream.id(7) == 11 + 5 * 20);
+    }
+}
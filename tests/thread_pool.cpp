@@ -0,0 +1,73 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <stdexcept>
+
+#include "concurrency/thread_pool.hpp"
+
+using namespace concurrency;
+
+TEST_CASE("ThreadPool") {
+
+    SUBCASE("Every task of a group has run when wait returns") {
+        for (size_t threads: {0, 1, 4}) {
+            ThreadPool pool(threads);
+            CHECK(pool.size() == threads);
+            std::atomic<int> sum {0};
+            TaskGroup group(pool);
+            for (int i = 1; i <= 100; i++) {
+                group.run([&sum, i] { sum += i; });
+            }
+            group.wait();
+            CHECK(sum == 5050);
+        }
+    }
+
+    SUBCASE("Tasks can wait for the subtasks they spawn") {
+        ThreadPool pool(2);
+        std::atomic<int> leaves {0};
+
+        std::function<void(int)> split = [&](int depth) {
+            if (depth == 0) {
+                leaves += 1;
+                return;
+            }
+            TaskGroup group(pool);
+            group.run([&, depth] { split(depth - 1); });
+            group.run([&, depth] { split(depth - 1); });
+            group.wait();
+        };
+        split(8);
+        CHECK(leaves == 256);
+    }
+
+    SUBCASE("Wait rethrows the exception of a task") {
+        ThreadPool pool(2);
+        TaskGroup group(pool);
+        std::atomic<int> ran {0};
+        group.run([] { throw std::runtime_error("Task failed."); });
+        group.run([&ran] { ran += 1; });
+        CHECK_THROWS(group.wait());
+        CHECK(ran == 1);
+    }
+
+    SUBCASE("A group destroyed by an exception waits for its tasks") {
+        ThreadPool pool(2);
+        std::atomic<int> finished {0};
+        auto spawn = [&] {
+            TaskGroup group(pool);
+            for (int i = 0; i < 8; i++) {
+                group.run([&finished] {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                    finished += 1;
+                });
+            }
+            throw std::runtime_error("Failed before waiting.");
+        };
+        CHECK_THROWS(spawn());
+        CHECK(finished == 8);
+    }
+}
@@ -0,0 +1,113 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <chrono>
+#include <stdexcept>
+
+#include "render/tile_renderer.hpp"
+
+using namespace render;
+
+static Pixel gradient(size_t x, size_t y) {
+    return Pixel(color(static_cast<float>(x) / 256.f, static_cast<float>(y) / 256.f, 0.5f));
+}
+
+template<typename C>
+static bool matchesGradient(const C &canvas) {
+    for (size_t y = 0; y < canvas.height; y++) {
+        for (size_t x = 0; x < canvas.width; x++) {
+            // Through a canvas of the same storage, so the expected pixel is rounded the same way.
+            C reference(1, 1);
+            reference.writePixelAt(0, 0, gradient(x, y));
+            if (canvas.pixelAt(x, y) != reference.pixelAt(0, 0)) return false;
+        }
+    }
+    return true;
+}
+
+TEST_CASE("TileRenderer") {
+
+    SUBCASE("Every pixel is shaded exactly once") {
+        for (uint32_t threads: {1u, 2u, 5u}) {
+            for (uint32_t tileSize: {1u, 7u, 32u, 200u}) {
+                Canvas canvas(101, 67);
+                std::unique_ptr<std::atomic<int>[]> shaded(new std::atomic<int>[101 * 67]);
+                for (size_t i = 0; i < 101 * 67; i++) shaded[i] = 0;
+
+                TileRenderer renderer({tileSize, threads});
+                auto stats = renderer.render(canvas, [&](size_t x, size_t y) {
+                    shaded[x + y * 101] += 1;
+                    return gradient(x, y);
+                });
+
+                bool once = true;
+                for (size_t i = 0; i < 101 * 67; i++) once = once && shaded[i] == 1;
+                CHECK(once);
+                CHECK(matchesGradient(canvas));
+
+                uint64_t tiles = 0;
+                for (const auto &worker: stats.workers) tiles += worker.tiles;
+                uint64_t expected = ((101 + tileSize - 1) / tileSize) * ((67 + tileSize - 1) / tileSize);
+                CHECK(tiles == expected);
+                CHECK(stats.tileTimes().total() == expected);
+                CHECK(stats.workers.size() == threads);
+            }
+        }
+    }
+
+    SUBCASE("Blocked layouts are rendered in whole blocks") {
+        BasicCanvas<storage::RGBA32F, layout::MortonTiled<16>> canvas(100, 50);
+        TileRenderer renderer({32, 3});
+        renderer.render(canvas, gradient);
+        CHECK(matchesGradient(canvas));
+
+        TileRenderer misaligned({24, 3});
+        CHECK_THROWS(misaligned.render(canvas, gradient));
+    }
+
+    SUBCASE("Idle workers steal tiles") {
+        // Worker 0 starts with the first half of the tiles, which are the only slow ones.
+        Canvas canvas(64, 64);
+        TileRenderer renderer({8, 2});
+        auto stats = renderer.render(canvas, [](size_t x, size_t y) {
+            if (y < 32) std::this_thread::sleep_for(std::chrono::microseconds(20));
+            return gradient(x, y);
+        });
+        CHECK(stats.workers[0].tiles + stats.workers[1].tiles == 64);
+        CHECK(stats.workers[0].stolen + stats.workers[1].stolen > 0);
+        CHECK(stats.utilization(0) > 0);
+        CHECK(stats.utilization(0) <= 1);
+    }
+
+    SUBCASE("A throwing tile stops the render and is rethrown after every worker stopped") {
+        for (uint32_t threads: {1u, 2u, 4u}) {
+            TileRenderer renderer({8, threads});
+            // The first tile belongs to the calling thread; the others keep the workers busy meanwhile.
+            for (uint32_t throwing: {0u, 37u}) {
+                std::atomic<int> running {0}, rendered {0};
+                CHECK_THROWS(renderer.forEachTile(80, 80, [&](const Tile &tile) {
+                    running += 1;
+                    if (tile.x / 8 + tile.y / 8 * 10 == throwing) {
+                        running -= 1;
+                        throw std::runtime_error("Cannot render the tile.");
+                    }
+                    std::this_thread::sleep_for(std::chrono::microseconds(200));
+                    rendered += 1;
+                    running -= 1;
+                }));
+                CHECK(running == 0);
+                CHECK(rendered < 100);
+            }
+            std::atomic<int> tiles {0};
+            renderer.forEachTile(80, 80, [&](const Tile &) { tiles += 1; });
+            CHECK(tiles == 100);
+        }
+    }
+
+    SUBCASE("The tile size must be positive") {
+        CHECK_THROWS(TileRenderer({0, 1}));
+    }
+}
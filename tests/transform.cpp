@@ -0,0 +1,90 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+
+#include <doctest/doctest.h>
+
+#include "math/transform.hpp"
+
+TEST_CASE("Transform") {
+
+    using namespace transformation;
+
+    SUBCASE("The fluent API applies transformations in call order") {
+        auto t = Transform().rotateX(PI / 2).scale(5, 5, 5).translate(10, 5, 7);
+        CHECK_EQ(t.matrix(), translation(10, 5, 7) * scale(5, 5, 5) * rotationX(PI / 2));
+        CHECK_EQ(t.matrix() * point(1, 0, 1), point(15, 0, 7));
+    }
+
+    SUBCASE("Composing transforms") {
+        auto a = Transform().rotateY(PI / 3);
+        auto b = Transform().translate(1, 2, 3);
+        CHECK_EQ((b * a).matrix(), b.matrix() * a.matrix());
+        CHECK_EQ(Transform(a).then(b).matrix(), (b * a).matrix());
+    }
+
+    SUBCASE("The kind tracks the simplest family of the chain") {
+        CHECK(Transform().kind() == Transform::Kind::IDENTITY);
+        CHECK(Transform().translate(1, 2, 3).translate(3, 2, 1).kind() == Transform::Kind::TRANSLATION);
+        CHECK(Transform().translate(1, 2, 3).scale(2, -1, 3).kind() == Transform::Kind::SCALE);
+        CHECK(Transform().rotateX(1).translate(1, 2, 3).rotateZ(2).kind() == Transform::Kind::RIGID);
+        CHECK(Transform().rotateX(1).scale(1, 2, 3).kind() == Transform::Kind::AFFINE);
+        CHECK(Transform().scale(1, 2, 3).rotateX(1).kind() == Transform::Kind::AFFINE);
+        CHECK(Transform().shear(1, 0, 0, 0, 0, 0).translate(1, 1, 1).kind() == Transform::Kind::AFFINE);
+        CHECK(Transform(translation(1, 2, 3)).kind() == Transform::Kind::AFFINE);
+
+        Matrix4 projective = Matrix4::identity();
+        projective.set(3, 2, 1);
+        CHECK(Transform(projective).kind() == Transform::Kind::GENERAL);
+        CHECK(Transform(projective).translate(1, 0, 0).kind() == Transform::Kind::GENERAL);
+    }
+
+    SUBCASE("Every kind inverts like Matrix4::inverse") {
+        Matrix4 projective = {
+                {-5, 2, 6, -8},
+                {1, -5, 1, 8},
+                {7, 7, -6, -7},
+                {1, -3, 7, 4}
+        };
+        const Transform transforms[] = {
+                Transform(),
+                Transform().translate(5, -3, 2),
+                Transform().translate(5, -3, 2).scale(2, -3, 0.5f),
+                Transform().rotateX(PI / 4).translate(1, 2, 3).rotateY(PI / 3).rotateZ(-PI / 5),
+                Transform().rotateX(PI / 4).scale(1, 2, 3).shear(0, 1, 0, 0, 0.5f, 0).translate(1, 0, -1),
+                Transform(projective),
+        };
+
+        for (const auto &t: transforms) {
+            auto expected = t.matrix().inverse().value();
+            CHECK_EQ(t.inverse().value(), expected);
+            CHECK_EQ(t.inverseTranspose().value(), expected.transpose());
+            CHECK_EQ(t.matrix() * t.inverse().value(), Matrix4::identity());
+        }
+    }
+
+    SUBCASE("A chain that is not invertible has no inverse") {
+        auto t = Transform().scale(1, 0, 1).translate(1, 2, 3);
+        CHECK_FALSE(t.inverse().has_value());
+        CHECK_FALSE(t.inverseTranspose().has_value());
+    }
+
+    SUBCASE("Changing the chain invalidates the cached inverses") {
+        auto t = Transform().translate(1, 2, 3);
+        CHECK_EQ(t.inverse().value(), translation(-1, -2, -3));
+        t.scale(2, 2, 2);
+        CHECK_EQ(t.inverse().value(), t.matrix().inverse().value());
+        CHECK_EQ(t.inverseTranspose().value(), t.matrix().inverse().value().transpose());
+    }
+
+    SUBCASE("Normals are transformed with the inverse-transpose") {
+        // The normal of a transformed unit sphere, as in the book.
+        auto t = Transform().rotateZ(PI / 5).scale(1, 0.5f, 1);
+        auto objectPoint = t.inverse().value() * point(0, SQR_TWO / 2, -SQR_TWO / 2);
+        auto n = t.inverseTranspose().value() * (objectPoint - point(0, 0, 0));
+        n.w = 0;
+        CHECK_EQ(n.normalize().value(), vector(0, 0.97014f, -0.24254f));
+    }
+}
+
+// The chain itself folds into a constant.
+static_assert(transformation::Transform().translate(1, 2, 3).scale(2, 2, 2).matrix() * point(0, 0, 0) == point(2, 4, 6));
+static_assert(transformation::Transform().rotateX(1).translate(1, 0, 0).kind() == transformation::Transform::Kind::RIGID);
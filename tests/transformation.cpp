@@ -3,6 +3,7 @@
 #include <doctest/doctest.h>
 
 #include <sstream>
+#include <cmath>
 
 #include "math/matrix.hpp"
 #include "math/transformation.hpp"
@@ -122,6 +123,72 @@ TEST_CASE("Testing transformation matrices") {
         CHECK_EQ(transform * p, point(2, 3, 7));
     }
 
+    SUBCASE("Individual transformations are applied in sequence") {
+        auto p = point(1, 0, 1);
+        auto A = rotationX(PI / 2);
+        auto B = scale(5, 5, 5);
+        auto C = translation(10, 5, 7);
+        auto p2 = A * p;
+        CHECK_EQ(p2, point(1, -1, 0));
+        auto p3 = B * p2;
+        CHECK_EQ(p3, point(5, -5, 0));
+        auto p4 = C * p3;
+        CHECK_EQ(p4, point(15, 0, 7));
+    }
+
+    SUBCASE("Chained transformations must be applied in reverse order") {
+        auto T = translation(10, 5, 7) * scale(5, 5, 5) * rotationX(PI / 2);
+        CHECK_EQ(T * point(1, 0, 1), point(15, 0, 7));
+    }
 
+    SUBCASE("The constexpr sine and cosine match the standard library") {
+        for (int i = -720; i <= 720; i += 5) {
+            auto r = radians(static_cast<float>(i));
+            CHECK(compareFloat(static_cast<float>(detail::sinReduced(r)), std::sin(r)));
+            CHECK(compareFloat(static_cast<float>(detail::sinReduced(static_cast<double>(r) + M_PI / 2)), std::cos(r)));
+        }
+    }
 }
 
+// The same transformations, evaluated by the compiler.
+namespace compile_time {
+
+    using namespace transformation;
+
+    static_assert(compareFloat(sine(PI / 6), 0.5f));
+    static_assert(compareFloat(cosine(PI / 3), 0.5f));
+    static_assert(compareFloat(sine(-PI / 2), -1.f));
+    static_assert(compareFloat(cosine(4 * PI), 1.f));
+
+    static_assert(translation(5, -3, 2) * point(-3, 4, 5) == point(2, 1, 7));
+    static_assert(translation(5, -3, 2).inverse().value() * point(-3, 4, 5) == point(-8, 7, 3));
+    static_assert(scale(2, 3, 4).inverse().value() * vector(-4, 6, 8) == vector(-2, 2, 2));
+    static_assert(rotationX(PI / 4) * point(0, 1, 0) == point(0, SQR_TWO / 2, SQR_TWO / 2));
+    static_assert(rotationX(PI / 4).inverse().value() * point(0, 1, 0) == point(0, SQR_TWO / 2, -SQR_TWO / 2));
+    static_assert(rotationY(PI / 2) * point(0, 0, 1) == point(1, 0, 0));
+    static_assert(rotationZ(PI / 2) * point(0, 1, 0) == point(-1, 0, 0));
+    static_assert(shearing(0, 0, 0, 0, 0, 1) * point(2, 3, 4) == point(2, 3, 7));
+
+    constexpr Matrix4 chain = translation(10, 5, 7) * scale(5, 5, 5) * rotationX(PI / 2);
+    constexpr Matrix4 chainInverse = chain.inverse().value();
+
+    static_assert(chain * point(1, 0, 1) == point(15, 0, 7));
+    static_assert(chainInverse * point(15, 0, 7) == point(1, 0, 1));
+    static_assert(chain * chainInverse == Matrix4::identity());
+    static_assert(chain.transpose().transpose() == chain);
+
+    // Not affine: the general closed-form inverse and the cofactor expansion.
+    constexpr Matrix4 general = {
+            {-5, 2, 6, -8},
+            {1, -5, 1, 8},
+            {7, 7, -6, -7},
+            {1, -3, 7, 4}
+    };
+
+    static_assert(!general.isAffine());
+    static_assert(compareFloat(general.determinant(), 532));
+    static_assert(compareFloat(general.cofactor(2, 3).value(), -160));
+    static_assert(compareFloat(general.cofactor(3, 2).value(), 105));
+    static_assert(general.inverse().value() == general.cofactorInverse().value());
+    static_assert(!Matrix4().isInvertible());
+}
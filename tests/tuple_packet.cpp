@@ -0,0 +1,105 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "tuple_packet.hpp"
+
+static std::vector<Tuple4> makeTuples(size_t count, float seed) {
+    std::vector<Tuple4> tuples;
+    for (size_t i = 0; i < count; i++) {
+        auto f = static_cast<float>(i) + seed;
+        tuples.emplace_back(f, 2.f - f, f * 0.5f, (i & 1) ? 1.f : 0.f);
+    }
+    return tuples;
+}
+
+TEST_CASE("testing the Tuple4xN packets") {
+
+    auto as = makeTuples(8, 1.f);
+    auto bs = makeTuples(8, -3.f);
+    auto a = Tuple4x8::gather(as);
+    auto b = Tuple4x8::gather(bs);
+
+    SUBCASE("Gathering and scattering tuples") {
+        CHECK_EQ(a.lane(3), as[3]);
+
+        std::vector<Tuple4> out(8, Tuple4(0, 0, 0, 0));
+        a.scatter(out);
+        CHECK_EQ(out, as);
+
+        std::array<uint32_t, 8> reversed = {7, 6, 5, 4, 3, 2, 1, 0};
+        auto r = Tuple4x8::gather(as, reversed);
+        CHECK_EQ(r.lane(0), as[7]);
+
+        auto mask = MaskxN<8>::first(2);
+        r.scatter(out, reversed, mask);
+        CHECK_EQ(out[7], as[7]);
+        CHECK_EQ(out[6], as[6]);
+        CHECK_EQ(out[0], as[0]);
+    }
+
+    SUBCASE("Gathering past the end leaves lanes to zero") {
+        auto partial = Tuple4x8::gather(as, 5);
+        CHECK_EQ(partial.lane(2), as[7]);
+        CHECK_EQ(partial.lane(3), Tuple4(0, 0, 0, 0));
+    }
+
+    SUBCASE("Arithmetic is the same as Tuple4, lane by lane") {
+        auto sum = a + b;
+        auto difference = a - b;
+        auto negated = -a;
+        auto scaled = a * 3.5f;
+        auto product = a * b;
+        for (size_t i = 0; i < 8; i++) {
+            CHECK_EQ(sum.lane(i), as[i] + bs[i]);
+            CHECK_EQ(difference.lane(i), as[i] - bs[i]);
+            CHECK_EQ(negated.lane(i), -as[i]);
+            CHECK_EQ(scaled.lane(i), as[i] * 3.5f);
+            CHECK_EQ(product.lane(i), as[i] * bs[i]);
+        }
+    }
+
+    SUBCASE("Dot, cross, magnitude and normalize are the same as Tuple4, lane by lane") {
+        auto dot = a.dot(b);
+        auto cross = a.cross(b);
+        auto magnitude = a.magnitude();
+        auto normalized = a.normalize();
+        for (size_t i = 0; i < 8; i++) {
+            CHECK(compareFloat(dot[i], as[i].dot(bs[i])));
+            CHECK_EQ(cross.lane(i), as[i].cross(bs[i]));
+            CHECK(compareFloat(magnitude[i], as[i].magnitude()));
+            CHECK_EQ(normalized.lane(i), as[i].normalize().value());
+        }
+    }
+
+    SUBCASE("Normalizing leaves zero lanes untouched") {
+        auto packet = Tuple4x4::broadcast(vector(0, 3, 4));
+        packet.setLane(2, vector(0, 0, 0));
+        auto normalized = packet.normalize();
+        CHECK_EQ(normalized.lane(0), vector(0, 0.6f, 0.8f));
+        CHECK_EQ(normalized.lane(2), vector(0, 0, 0));
+    }
+
+    SUBCASE("Comparing lanes follows compareFloat") {
+        auto c = a;
+        c.setLane(1, as[1] + vector(EPSILON / 2, 0, 0));
+        c.setLane(4, as[4] + vector(0, 0, 1));
+
+        auto equal = a.equal(c);
+        CHECK(equal[0]);
+        CHECK(equal[1]);
+        CHECK(!equal[4]);
+        CHECK_EQ(equal.count(), 7);
+        CHECK(equal.any());
+        CHECK(!equal.all());
+        CHECK((~equal)[4]);
+    }
+
+    SUBCASE("Selecting lanes with a mask") {
+        auto mask = a.x.less(FloatxN<8>::broadcast(4.f));
+        auto selected = select(mask, a, b);
+        for (size_t i = 0; i < 8; i++) {
+            CHECK_EQ(selected.lane(i), as[i].x < 4.f ? as[i] : bs[i]);
+        }
+        CHECK_EQ(mask.count(), 3);
+    }
+}